@@ -29,6 +29,21 @@
 extern "C" {
 #endif
 
+/**
+ * Status and statistics of the compressed audio frame queue.
+ */
+typedef struct
+{
+    uint32_t depth;      ///< Maximum number of frames in the queue.
+    uint32_t level;      ///< Number of frames currently in the queue.
+    uint32_t overruns;   ///< Frames lost because the queue was full.
+    uint32_t underruns;  ///< Frames not available when requested.
+    uint32_t latency;    ///< Current playout latency of the decoder, in frames.
+    uint32_t lost;       ///< Frames missing at playout time and concealed.
+    uint32_t late;       ///< Frames discarded by the decoder to reduce latency.
+}
+codecQueueStats_t;
+
 /**
  * Initialise audio codec manager, allocating data buffers.
  *
@@ -59,10 +74,20 @@ bool codec_startEncode(const pathId path);
  * Only an encoding or decoding operation at a time is possible: in case there
  * is already an operation in progress, this function returns false.
  *
+ * Frames go through a playout buffer which waits for a minimum number of them
+ * before starting to play and conceals the missing ones fading out the last
+ * frame received. When the adaptive mode is enabled, the playout latency is
+ * raised on each queue underrun and lowered after one second without any, and
+ * the frames arriving too late are discarded: this mode is meant for real-time
+ * sources, like a radio link, and not for sources keeping the queue always
+ * full. Only real-time sources count a full queue as an overrun, the other
+ * ones are expected to retry the push later.
+ *
  * @param path: audio path for decoded audio.
+ * @param adaptive: enable the adaptive playout latency.
  * @return true on success, false on failure.
  */
-bool codec_startDecode(const pathId path);
+bool codec_startDecode(const pathId path, const bool adaptive);
 
 /**
  * Stop an ongoing encoding or decoding operation.
@@ -104,6 +129,21 @@ int codec_popFrame(uint8_t *frame, const bool blocking);
  */
 int codec_pushFrame(const uint8_t *frame, const bool blocking);
 
+/**
+ * Signal the end of the stream being decoded. Once the frames already pushed
+ * have been played, the decoder outputs silence without concealing the missing
+ * frames. Pushing a new frame starts a new stream.
+ */
+void codec_endStream();
+
+/**
+ * Get the status of the internal frame queue. The overrun and underrun counters
+ * are cleared each time an encoding or decoding operation is started.
+ *
+ * @return queue status and statistics.
+ */
+codecQueueStats_t codec_getQueueStats();
+
 #ifdef __cplusplus
 }
 #endif
@@ -28,9 +28,9 @@
 
 // Magic number to identify the binary file
 #define CPS_MAGIC 0x43585452
-// Codeplug version v0.1
+// Codeplug version v0.2
 #define CPS_VERSION_MAJOR  0
-#define CPS_VERSION_MINOR  1
+#define CPS_VERSION_MINOR  2
 #define CPS_VERSION_NUMBER (CPS_VERSION_MAJOR << 8) | CPS_VERSION_MINOR
 #define CPS_STR_SIZE 32
 
@@ -296,12 +296,15 @@ typedef struct
 __attribute__((packed)) bankHdr_t; // 18B + 2 * ch_count
 
 /**
- * The codeplug binary structure is composed by:
+ * The v0.1 codeplug binary structure is composed by:
  * - A header struct
  * - A variable length array of all the contacts
  * - A variable length array of all the channels
  * - A variable length array of the offsets to reach each bank
  * - A binary dense structure of all the banks
+ *
+ * From v0.2 the header is followed by a snapshot of the codeplug records and
+ * by a journal of the modifications, as described in the libc cps driver.
  */
 typedef struct
 {
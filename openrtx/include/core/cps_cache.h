@@ -0,0 +1,112 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#ifndef CPS_CACHE_H
+#define CPS_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <cps.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * In-RAM cache of the codeplug, sitting above the cps_io interface.
+ *
+ * The cache keeps a small LRU set of fully decoded channels, contacts and bank
+ * headers, plus an index of entry names loaded lazily in pages of consecutive
+ * entries, to be used when drawing the codeplug menus. Channel and contact
+ * pages are loaded with a single batched read. The whole cache is dropped each
+ * time the codeplug is opened or modified.
+ *
+ * As for the cps_io functions, the cache is not thread safe and has to be
+ * accessed by one thread at a time.
+ */
+
+/**
+ * Drop all the cached codeplug data and mark the codeplug indices as out of
+ * date.
+ */
+void cpsCache_invalidate();
+
+/**
+ * Read one channel, either from the cache or from the codeplug.
+ *
+ * @param channel: pointer to the channel_t data structure to be populated.
+ * @param pos: position, inside the channel table, from which read data.
+ * @return 0 on success, -1 on failure
+ */
+int cpsCache_readChannel(channel_t *channel, uint16_t pos);
+
+/**
+ * Read one contact, either from the cache or from the codeplug.
+ *
+ * @param contact: pointer to the contact_t data structure to be populated.
+ * @param pos: position, inside the contact table, from which read data.
+ * @return 0 on success, -1 on failure
+ */
+int cpsCache_readContact(contact_t *contact, uint16_t pos);
+
+/**
+ * Read one bank header, either from the cache or from the codeplug.
+ *
+ * @param b_header: pointer to the struct to be populated with the bank header.
+ * @param pos: position, inside the bank table, from which read data.
+ * @return 0 on success, -1 on failure
+ */
+int cpsCache_readBankHeader(bankHdr_t *b_header, uint16_t pos);
+
+/**
+ * Get the name of a channel from the name index.
+ *
+ * @param buf: destination buffer.
+ * @param len: size of the destination buffer.
+ * @param pos: position of the channel inside the channel table.
+ * @return 0 on success, -1 on failure
+ */
+int cpsCache_getChannelName(char *buf, size_t len, uint16_t pos);
+
+/**
+ * Get the name of a contact from the name index.
+ *
+ * @param buf: destination buffer.
+ * @param len: size of the destination buffer.
+ * @param pos: position of the contact inside the contact table.
+ * @return 0 on success, -1 on failure
+ */
+int cpsCache_getContactName(char *buf, size_t len, uint16_t pos);
+
+/**
+ * Get the name of a bank from the name index.
+ *
+ * @param buf: destination buffer.
+ * @param len: size of the destination buffer.
+ * @param pos: position of the bank inside the bank table.
+ * @return 0 on success, -1 on failure
+ */
+int cpsCache_getBankName(char *buf, size_t len, uint16_t pos);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CPS_CACHE_H
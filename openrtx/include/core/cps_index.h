@@ -0,0 +1,133 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#ifndef CPS_INDEX_H
+#define CPS_INDEX_H
+
+#include <stdint.h>
+#include <cps.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Sorted indices of the codeplug contacts and channels.
+ *
+ * Contacts and channels are indexed by name, in case-insensitive alphabetical
+ * order, and contacts are also indexed by their DMR ID or M17 address. The
+ * indices hold the codeplug position of each entry together with its sorting
+ * key, which is the full address or the first eight characters of the name:
+ * address lookups and searches of name prefixes up to eight characters long
+ * do not access the codeplug. Longer prefixes are compared by reading the
+ * names of the entries sharing the first eight characters.
+ *
+ * The indices are built from the codeplug at boot and rebuilt on the first
+ * access after a modification of the codeplug. They are allocated according to
+ * the size of the codeplug tables, up to CONFIG_CPS_INDEX_SIZE entries each:
+ * beyond that or if memory runs out, only the first entries of each table are
+ * indexed and the remaining contacts are looked up by address with a linear
+ * search. The result of the last address lookup is cached.
+ */
+
+/**
+ * Range of matching entries, expressed as positions in the sorted index.
+ */
+typedef struct
+{
+    uint16_t first;     // Sorted index position of the first match
+    uint16_t count;     // Number of matches
+}
+cpsMatch_t;
+
+/**
+ * Build the codeplug indices.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int cpsIndex_build();
+
+/**
+ * Mark the codeplug indices as out of date, they will be rebuilt on the next
+ * access.
+ */
+void cpsIndex_invalidate();
+
+/**
+ * Search the contacts whose name begins with a given prefix, the comparison
+ * is case-insensitive. Since matches are contiguous in the sorted index, the
+ * range can be narrowed down as the user types by repeating the search with
+ * a longer prefix.
+ *
+ * @param prefix: name prefix, an empty string matches all the contacts.
+ * @param match: range of the matching contacts in the sorted index.
+ * @return 0 on success, -1 on failure.
+ */
+int cpsIndex_searchContacts(const char *prefix, cpsMatch_t *match);
+
+/**
+ * Search the channels whose name begins with a given prefix, the comparison
+ * is case-insensitive.
+ *
+ * @param prefix: name prefix, an empty string matches all the channels.
+ * @param match: range of the matching channels in the sorted index.
+ * @return 0 on success, -1 on failure.
+ */
+int cpsIndex_searchChannels(const char *prefix, cpsMatch_t *match);
+
+/**
+ * Get the codeplug position of a contact from its position in the sorted
+ * index.
+ *
+ * @param rank: position of the contact in the sorted index.
+ * @return codeplug position of the contact or -1 if out of range.
+ */
+int cpsIndex_getContact(uint16_t rank);
+
+/**
+ * Get the codeplug position of a channel from its position in the sorted
+ * index.
+ *
+ * @param rank: position of the channel in the sorted index.
+ * @return codeplug position of the channel or -1 if out of range.
+ */
+int cpsIndex_getChannel(uint16_t rank);
+
+/**
+ * Find a DMR contact by its ID.
+ *
+ * @param id: DMR ID.
+ * @return codeplug position of the contact or -1 if not found.
+ */
+int cpsIndex_findDmrContact(uint32_t id);
+
+/**
+ * Find an M17 contact by its callsign.
+ *
+ * @param callsign: contact callsign.
+ * @return codeplug position of the contact or -1 if not found.
+ */
+int cpsIndex_findM17Contact(const char *callsign);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CPS_INDEX_H
@@ -30,6 +30,8 @@ extern "C" {
 #endif
 
 typedef int16_t audio_sample_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
 
 /*
  * This header contains various DSP utilities which can be used to condition
@@ -47,6 +49,17 @@ typedef struct
 }
 filter_state_t;
 
+/**
+ * Data structure holding the internal state of a fixed point filter.
+ */
+typedef struct
+{
+    int32_t u;            // last input value u(k-1)
+    int64_t y;            // last output value y(k-1), Q15
+    bool    initialised;  // state variables initialised
+}
+filter_state_q15_t;
+
 
 /**
  * Reset the filter state variables.
@@ -65,6 +78,25 @@ void dsp_resetFilterState(filter_state_t *state);
  */
 void dsp_dcRemoval(filter_state_t *state, audio_sample_t *buffer, size_t length);
 
+/**
+ * Reset the state variables of a fixed point filter.
+ *
+ * @param state: pointer to the data structure containing the filter state.
+ */
+void dsp_resetFilterStateQ15(filter_state_q15_t *state);
+
+/**
+ * Remove the DC offset from a collection of audio samples, processing data
+ * in-place. Fixed point version of dsp_dcRemoval(), not requiring any floating
+ * point operation.
+ *
+ * @param state: pointer to the data structure containing the filter state.
+ * @param buffer: buffer containing the audio samples.
+ * @param length: number of samples contained in the buffer.
+ */
+void dsp_dcRemovalQ15(filter_state_q15_t *state, audio_sample_t *buffer,
+                      size_t length);
+
 /*
  * Inverts the phase of the audio buffer passed as paramenter.
  * The buffer will be processed in place to save memory.
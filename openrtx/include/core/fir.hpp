@@ -28,12 +28,28 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <dsp.h>
+
+#if defined(__AVX__) || defined(__SSE__)
+#include <immintrin.h>
+#endif
 
 /**
  * Class for FIR filter with configurable coefficients.
  * Adapted from the original implementation by Rob Riggs, Mobilinkd LLC.
+ *
+ * The history of past inputs is stored twice, back to back, in a linear
+ * buffer. In this way the last N samples are always available as a contiguous
+ * block ordered from the newest to the oldest, and the filter output can be
+ * computed as a plain dot product against the coefficients without any index
+ * wrapping. This allows to vectorize the inner loop on targets supporting it.
+ *
+ * The second template parameter selects the arithmetic used by the filter:
+ * float by default or Q15 fixed point, see the Fir< N, q15_t > specialization.
  */
-template < size_t N >
+template < size_t N, typename T = float >
 class Fir
 {
 public:
@@ -63,21 +79,219 @@ public:
      */
     float operator()(const float& input)
     {
-        hist[pos] = input;
-        pos = (pos + 1) % N;
+        push(input);
 
-        float  result = 0.0;
-        size_t index  = pos;
+        float result = 0.0;
+        const float *h = &hist[pos];
 
         for(size_t i = 0; i < N; i++)
+            result += h[i] * taps[i];
+
+        return result;
+    }
+
+    /**
+     * Filter a block of samples. Input and output buffers can coincide, in
+     * which case the filtering is done in place. Output values are scaled by
+     * the given gain and saturated to the int16_t range.
+     *
+     * @param in: pointer to the input samples.
+     * @param out: pointer to the output buffer.
+     * @param n: number of samples to be processed.
+     * @param gain: gain applied to the filter output.
+     */
+    void process(const int16_t *in, int16_t *out, const size_t n,
+                 const float gain = 1.0f)
+    {
+        for(size_t i = 0; i < n; i++)
         {
-            index   = (index != 0 ? index - 1 : N - 1);
-            result += hist[index] * taps[i];
+            push(static_cast< float >(in[i]));
+
+            float result = gain * dot(&hist[pos]);
+            if(result > 32767.0f)  result = 32767.0f;
+            if(result < -32768.0f) result = -32768.0f;
+
+            out[i] = static_cast< int16_t >(result);
         }
+    }
+
+    /**
+     * Reset FIR history, clearing the memory of past values.
+     */
+    void reset()
+    {
+        hist.fill(0);
+        pos = 0;
+    }
+
+private:
+
+    /**
+     * Append a new value to the history buffer. The write position moves
+     * backwards so that hist[pos] is always the newest value.
+     *
+     * @param input: value to be appended.
+     */
+    inline void push(const float input)
+    {
+        pos = (pos != 0 ? pos - 1 : N - 1);
+        hist[pos]     = input;
+        hist[pos + N] = input;
+    }
+
+    /**
+     * Compute the dot product between the filter coefficients and N
+     * consecutive values of the history buffer.
+     *
+     * @param h: pointer to the first (newest) history value.
+     * @return dot product.
+     */
+    inline float dot(const float *h) const
+    {
+        const float *t = taps.data();
+        size_t i = 0;
+
+        #if defined(__AVX__)
+        __m256 acc8 = _mm256_setzero_ps();
+        for(; (i + 8) <= N; i += 8)
+        {
+            __m256 prod = _mm256_mul_ps(_mm256_loadu_ps(h + i),
+                                        _mm256_loadu_ps(t + i));
+            acc8 = _mm256_add_ps(acc8, prod);
+        }
+
+        __m128 acc = _mm_add_ps(_mm256_castps256_ps128(acc8),
+                                _mm256_extractf128_ps(acc8, 1));
+        #elif defined(__SSE__)
+        __m128 acc = _mm_setzero_ps();
+        #endif
+
+        #if defined(__AVX__) || defined(__SSE__)
+        for(; (i + 4) <= N; i += 4)
+        {
+            __m128 prod = _mm_mul_ps(_mm_loadu_ps(h + i), _mm_loadu_ps(t + i));
+            acc = _mm_add_ps(acc, prod);
+        }
+
+        acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+        acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 0x55));
+        float result = _mm_cvtss_f32(acc);
+        #else
+        // Four independent accumulators, to avoid stalling the FPU pipeline
+        // on the dependency between consecutive multiply-accumulates.
+        float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for(; (i + 4) <= N; i += 4)
+        {
+            acc[0] += h[i]     * t[i];
+            acc[1] += h[i + 1] * t[i + 1];
+            acc[2] += h[i + 2] * t[i + 2];
+            acc[3] += h[i + 3] * t[i + 3];
+        }
+
+        float result = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+        #endif
+
+        for(; i < N; i++)
+            result += h[i] * t[i];
 
         return result;
     }
 
+    const std::array< float, N >& taps;    ///< FIR filter coefficients.
+    std::array< float, 2 * N >    hist;    ///< History of past inputs, stored twice.
+    size_t                        pos;     ///< Position of the newest value in history.
+};
+
+/**
+ * Fixed point version of the FIR filter, for targets without an FPU or where
+ * the float conversion of each sample is too costly. Coefficients are given as
+ * floating point values and converted to 16 bit fixed point at construction
+ * time: the number of fractional bits is chosen to use the full range for the
+ * largest coefficient, so it is at least 15 (Q15). Input and output samples
+ * are plain 16 bit integers. Products are accumulated on 64 bit, thus the
+ * filter never overflows internally and the output is saturated to the int16_t
+ * range.
+ */
+template < size_t N >
+class Fir< N, q15_t >
+{
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param taps: reference to a std::array of floating poing values representing
+     * the FIR filter coefficients, must lie in the [-1, 1) range.
+     */
+    Fir(const std::array< float, N >& taps) : shift(15), pos(0)
+    {
+        float maxTap = 0.0f;
+        for(size_t i = 0; i < N; i++)
+            maxTap = std::max(maxTap, std::fabs(taps[i]));
+
+        while((shift < 30) && (maxTap * static_cast< float >(1 << (shift + 1)) < 32767.0f))
+            shift += 1;
+
+        for(size_t i = 0; i < N; i++)
+        {
+            float tap = std::round(taps[i] * static_cast< float >(1 << shift));
+            if(tap > 32767.0f)  tap = 32767.0f;
+            if(tap < -32768.0f) tap = -32768.0f;
+
+            this->taps[i] = static_cast< q15_t >(tap);
+        }
+
+        reset();
+    }
+
+    /**
+     * Destructor.
+     */
+    ~Fir() { }
+
+    /**
+     * Perform one step of the FIR filter, computing a new output value given
+     * the input value and the history of previous input values.
+     *
+     * @param input: FIR input value for the current time step.
+     * @return FIR output as a function of the current and past input values.
+     */
+    int16_t operator()(const int16_t& input)
+    {
+        push(input);
+
+        // Round to nearest, dropping the fractional bits of the result
+        int64_t result = (dot(&hist[pos]) + (INT64_C(1) << (shift - 1))) >> shift;
+        return saturate(result);
+    }
+
+    /**
+     * Filter a block of samples. Input and output buffers can coincide, in
+     * which case the filtering is done in place. Output values are scaled by
+     * the given gain and saturated to the int16_t range.
+     *
+     * @param in: pointer to the input samples.
+     * @param out: pointer to the output buffer.
+     * @param n: number of samples to be processed.
+     * @param gain: gain applied to the filter output, magnitude below 1024.
+     */
+    void process(const int16_t *in, int16_t *out, const size_t n,
+                 const float gain = 1.0f)
+    {
+        // Gain is applied in Q16 to the accumulator, previously brought to Q15
+        // to leave room for the multiplication. The final shift brings the
+        // result back to integer samples.
+        const int64_t gainQ16 = static_cast< int64_t >(std::lround(gain * 65536.0f));
+
+        for(size_t i = 0; i < n; i++)
+        {
+            push(in[i]);
+
+            int64_t result = ((dot(&hist[pos]) >> (shift - 15)) * gainQ16 + (INT64_C(1) << 30)) >> 31;
+            out[i] = saturate(result);
+        }
+    }
+
     /**
      * Reset FIR history, clearing the memory of past values.
      */
@@ -89,9 +303,51 @@ public:
 
 private:
 
-    const std::array< float, N >& taps;    ///< FIR filter coefficients.
-    std::array< float, N >        hist;    ///< History of past inputs.
-    size_t                        pos;     ///< Current position in history.
+    /**
+     * Append a new value to the history buffer. The write position moves
+     * backwards so that hist[pos] is always the newest value.
+     *
+     * @param input: value to be appended.
+     */
+    inline void push(const int16_t input)
+    {
+        pos = (pos != 0 ? pos - 1 : N - 1);
+        hist[pos]     = input;
+        hist[pos + N] = input;
+    }
+
+    /**
+     * Compute the dot product between the filter coefficients and N
+     * consecutive values of the history buffer.
+     *
+     * @param h: pointer to the first (newest) history value.
+     * @return dot product, with the same fractional bits of the coefficients.
+     */
+    inline int64_t dot(const int16_t *h) const
+    {
+        int64_t acc = 0;
+
+        for(size_t i = 0; i < N; i++)
+            acc += static_cast< int32_t >(h[i]) * static_cast< int32_t >(taps[i]);
+
+        return acc;
+    }
+
+    /**
+     * Saturate a value to the int16_t range.
+     */
+    static inline int16_t saturate(const int64_t value)
+    {
+        if(value > INT16_MAX) return INT16_MAX;
+        if(value < INT16_MIN) return INT16_MIN;
+
+        return static_cast< int16_t >(value);
+    }
+
+    std::array< q15_t, N >       taps;    ///< FIR filter coefficients.
+    std::array< int16_t, 2 * N > hist;    ///< History of past inputs, stored twice.
+    size_t                       shift;   ///< Fractional bits of the coefficients.
+    size_t                       pos;     ///< Position of the newest value in history.
 };
 
-#endif /* DSP_H */
+#endif /* FIR_H */
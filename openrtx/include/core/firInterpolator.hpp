@@ -0,0 +1,136 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#ifndef FIR_INTERPOLATOR_H
+#define FIR_INTERPOLATOR_H
+
+#ifndef __cplusplus
+#error This header is C++ only!
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Polyphase FIR interpolator. Equivalent to inserting L - 1 zeroes after each
+ * input sample and then filtering the result with an N-tap FIR filter, but
+ * without wasting multiply-accumulates on the zero samples: the filter is
+ * split in L sub-filters of ceil(N/L) taps and each output sample is computed
+ * using only the sub-filter corresponding to its phase.
+ */
+template < size_t N, size_t L >
+class FirInterpolator
+{
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param taps: coefficients of the prototype FIR filter, running at the
+     * output sample rate.
+     */
+    FirInterpolator(const std::array< float, N >& taps) : pos(0)
+    {
+        phases.fill(0.0f);
+
+        for(size_t i = 0; i < N; i++)
+        {
+            size_t phase = i % L;
+            size_t tap   = i / L;
+            phases[(phase * K) + tap] = taps[i];
+        }
+
+        reset();
+    }
+
+    /**
+     * Destructor.
+     */
+    ~FirInterpolator() { }
+
+    /**
+     * Interpolate a block of samples. For each input sample, L output samples
+     * are produced. Output values are scaled by the given gain and saturated
+     * to the int16_t range.
+     *
+     * @param in: pointer to the input samples.
+     * @param out: pointer to the output buffer, at least n * L elements long.
+     * @param n: number of input samples to be processed.
+     * @param gain: gain applied to the filter output.
+     */
+    template < typename T >
+    void process(const T *in, int16_t *out, const size_t n,
+                 const float gain = 1.0f)
+    {
+        for(size_t i = 0; i < n; i++)
+        {
+            push(static_cast< float >(in[i]));
+            const float *h = &hist[pos];
+
+            for(size_t p = 0; p < L; p++)
+            {
+                const float *t = &phases[p * K];
+                float result   = 0.0f;
+
+                for(size_t k = 0; k < K; k++)
+                    result += h[k] * t[k];
+
+                result *= gain;
+                if(result > 32767.0f)  result = 32767.0f;
+                if(result < -32768.0f) result = -32768.0f;
+
+                *out++ = static_cast< int16_t >(result);
+            }
+        }
+    }
+
+    /**
+     * Reset the interpolator history, clearing the memory of past values.
+     */
+    void reset()
+    {
+        hist.fill(0.0f);
+        pos = 0;
+    }
+
+private:
+
+    /**
+     * Append a new value to the history buffer, kept doubled so that the last
+     * K values are always contiguous and ordered from the newest.
+     *
+     * @param input: value to be appended.
+     */
+    inline void push(const float input)
+    {
+        pos = (pos != 0 ? pos - 1 : K - 1);
+        hist[pos]     = input;
+        hist[pos + K] = input;
+    }
+
+    static constexpr size_t K = (N + L - 1) / L;    ///< Taps per sub-filter.
+
+    std::array< float, K * L > phases;    ///< Sub-filter coefficients, one phase after the other.
+    std::array< float, 2 * K > hist;      ///< History of past inputs, stored twice.
+    size_t                     pos;       ///< Position of the newest value in history.
+};
+
+#endif /* FIR_INTERPOLATOR_H */
@@ -134,6 +134,13 @@ void gfx_renderRows(uint8_t startRow, uint8_t endRow);
  */
 void gfx_render();
 
+/**
+ * Copy to the display only the framebuffer rows whose content changed since
+ * the last call to gfx_render() or gfx_renderDirty(). The whole screen is
+ * rendered at the first call after gfx_init().
+ */
+void gfx_renderDirty();
+
 /**
  * Clears a portion of the screen content
  * This results in a black screen on color displays
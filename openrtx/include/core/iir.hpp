@@ -28,12 +28,17 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cmath>
+#include <dsp.h>
 
 /**
  * Class for IIR filter with configurable coefficients.
  * Adapted from the original implementation by Rob Riggs, Mobilinkd LLC.
+ *
+ * The second template parameter selects the arithmetic used by the filter:
+ * float by default or 32 bit fixed point, see the Iir< N, q31_t > specialization.
  */
-template < size_t N >
+template < size_t N, typename T = float >
 class Iir
 {
 public:
@@ -99,4 +104,111 @@ private:
     size_t                        pos;    ///< Current position in history.
 };
 
+/**
+ * Fixed point version of the IIR filter. Coefficients are given as floating
+ * point values and converted at construction time to 32 bit values with 29
+ * fractional bits, leaving room for the denominator coefficients of second
+ * order sections, which can reach magnitude 2. The filter state is kept as
+ * 32 bit integers in the same unit of the input, products are computed on
+ * 64 bit. The input range and the filter DC gain must be such that the state
+ * does not exceed the int32_t range.
+ */
+template < size_t N >
+class Iir< N, q31_t >
+{
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param num: coefficients of the IIR filter numerator.
+     * @param den: coefficients of the IIR filter denominator.
+     */
+    Iir(const std::array< float, N >& num, const std::array< float, N >& den) :
+        pos(0)
+    {
+        for(size_t i = 0; i < N; i++)
+        {
+            this->num[i] = toFixed(num[i]);
+            this->den[i] = toFixed(den[i]);
+        }
+
+        reset();
+    }
+
+    /**
+     * Destructor.
+     */
+    ~Iir() { }
+
+    /**
+     * Perform one step of the IIR filter, computing a new output value given
+     * the input value and the history of previous input values.
+     *
+     * @param input: IIR input value for the current time step.
+     * @return IIR output as a function of the current and past input values.
+     */
+    q31_t operator()(const q31_t& input)
+    {
+        int64_t accNum = 0;
+        int64_t accDen = 0;
+        size_t  index  = pos;
+
+        for(size_t i = 1; i < N; i++)
+        {
+            index   = (index != 0 ? index - 1 : N - 1);
+            accNum += static_cast< int64_t >(hist[index]) * num[i];
+            accDen += static_cast< int64_t >(hist[index]) * den[i];
+        }
+
+        int64_t value = static_cast< int64_t >(input) - round(accDen);
+        if(value > INT32_MAX) value = INT32_MAX;
+        if(value < INT32_MIN) value = INT32_MIN;
+
+        accNum   += value * num[0];
+        hist[pos] = static_cast< int32_t >(value);
+        pos       = (pos + 1) % N;
+
+        return static_cast< q31_t >(round(accNum));
+    }
+
+    /**
+     * Reset IIR history, clearing the memory of past values.
+     */
+    void reset()
+    {
+        hist.fill(0);
+        pos = 0;
+    }
+
+private:
+
+    static constexpr unsigned int FRAC_BITS = 29;
+
+    /**
+     * Convert a coefficient to fixed point, with saturation.
+     */
+    static int32_t toFixed(const float value)
+    {
+        float fixed = std::round(value * static_cast< float >(1 << FRAC_BITS));
+        if(fixed >  2147483520.0f) return INT32_MAX;
+        if(fixed < -2147483648.0f) return INT32_MIN;
+
+        return static_cast< int32_t >(fixed);
+    }
+
+    /**
+     * Round an accumulator value to the nearest integer.
+     */
+    static inline int64_t round(const int64_t acc)
+    {
+        return (acc + (INT64_C(1) << (FRAC_BITS - 1))) >> FRAC_BITS;
+    }
+
+    std::array< int32_t, N > num;    ///< IIR filter numerator coefficients.
+    std::array< int32_t, N > den;    ///< IIR filter denominator coefficients.
+    std::array< int32_t, N > hist;   ///< History of past inputs.
+    size_t                   pos;    ///< Current position in history.
+};
+
 #endif /* IIR_H */
@@ -0,0 +1,166 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#ifndef LOCKFREE_QUEUE_H
+#define LOCKFREE_QUEUE_H
+
+#ifndef __cplusplus
+#error This header is C++ only!
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+/**
+ * Statically allocated, bounded, lock-free queue allowing multiple producers
+ * and multiple consumers. Each slot carries a sequence number telling whether
+ * it is ready to be written or read for a given lap of the queue, so that
+ * producers and consumers only contend on their own position counter.
+ * Push and pop never block: they fail when the queue is full or empty.
+ *
+ * The queue size must be a power of two.
+ */
+template < typename T, size_t N >
+class LockFreeQueue
+{
+    static_assert((N != 0) && ((N & (N - 1)) == 0),
+                  "Queue size must be a power of two");
+
+public:
+
+    /**
+     * Constructor.
+     */
+    LockFreeQueue() : writePos(0), readPos(0)
+    {
+        for(size_t i = 0; i < N; i++)
+            slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    /**
+     * Destructor.
+     */
+    ~LockFreeQueue() { }
+
+    /**
+     * Push an element to the queue.
+     *
+     * @param elem: element to be pushed.
+     * @return true if the element has been pushed, false if the queue is full.
+     */
+    bool push(const T& elem)
+    {
+        size_t pos = writePos.load(std::memory_order_relaxed);
+
+        while(true)
+        {
+            Slot&    slot = slots[pos & (N - 1)];
+            size_t   seq  = slot.seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+
+            if(diff == 0)
+            {
+                // Slot free for this lap, try to claim it
+                if(writePos.compare_exchange_weak(pos, pos + 1,
+                                                  std::memory_order_relaxed))
+                {
+                    slot.data = elem;
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(diff < 0)
+            {
+                // Slot still holds data from the previous lap: queue full
+                return false;
+            }
+            else
+            {
+                // Another producer claimed this position, retry
+                pos = writePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Pop an element from the queue.
+     *
+     * @param elem: place where to store the popped element.
+     * @return true if an element has been popped, false if the queue is empty.
+     */
+    bool pop(T& elem)
+    {
+        size_t pos = readPos.load(std::memory_order_relaxed);
+
+        while(true)
+        {
+            Slot&    slot = slots[pos & (N - 1)];
+            size_t   seq  = slot.seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+
+            if(diff == 0)
+            {
+                if(readPos.compare_exchange_weak(pos, pos + 1,
+                                                 std::memory_order_relaxed))
+                {
+                    elem = slot.data;
+                    slot.seq.store(pos + N, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(diff < 0)
+            {
+                // Slot not yet written: queue empty
+                return false;
+            }
+            else
+            {
+                pos = readPos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Check if the queue is empty. The result is only a snapshot, as other
+     * threads may push or pop elements concurrently.
+     *
+     * @return true if the queue is empty.
+     */
+    bool empty()
+    {
+        return writePos.load(std::memory_order_acquire)
+            == readPos.load(std::memory_order_acquire);
+    }
+
+private:
+
+    struct Slot
+    {
+        std::atomic< size_t > seq;    ///< Slot sequence number.
+        T                     data;   ///< Slot content.
+    };
+
+    Slot slots[N];                                ///< Data storage.
+    alignas(64) std::atomic< size_t > writePos;   ///< Producers position.
+    alignas(64) std::atomic< size_t > readPos;    ///< Consumers position.
+};
+
+#endif  // LOCKFREE_QUEUE_H
@@ -0,0 +1,154 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#ifndef M17_PACKET_H
+#define M17_PACKET_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <gps.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Exchange of M17 packet mode data between the applications and the M17
+ * operating mode.
+ *
+ * Packets are stored in a set of statically allocated slots, which are handed
+ * over between the application and the RTX thread without copying their
+ * content: to transmit a packet the application gets a free slot, writes the
+ * packet content directly inside it and then submits it. Received packets are
+ * reassembled by the RTX thread directly inside a slot, which is then made
+ * available to the application until released.
+ *
+ * The first byte of the packet content is the packet protocol type, as per M17
+ * specification (0x00 raw data, 0x02 APRS, 0x05 SMS, ...).
+ */
+
+#define M17PKT_MAX_SIZE  823    /**< Maximum size of a packet, CRC excluded */
+#define M17PKT_BUF_SIZE  825    /**< Size of a packet buffer, CRC included  */
+
+/**
+ * Data structure representing an M17 packet.
+ */
+typedef struct
+{
+    uint8_t data[M17PKT_BUF_SIZE];  /**< Packet content, followed by the CRC */
+    size_t  size;                   /**< Size of the content, CRC excluded   */
+    char    src[10];                /**< Source callsign                     */
+    char    dst[10];                /**< Destination callsign                */
+}
+m17packet_t;
+
+/**
+ * Get a free packet slot for transmission. Once filled with the packet content,
+ * its size and the destination callsign, the packet has to be either submitted
+ * through m17Packet_send() or discarded through m17Packet_release(). An empty
+ * destination callsign corresponds to a broadcast transmission.
+ *
+ * @return pointer to the packet slot or NULL if another packet is still
+ * waiting to be transmitted.
+ */
+m17packet_t *m17Packet_allocTx();
+
+/**
+ * Submit a packet for transmission. The packet is sent by the M17 operating
+ * mode as soon as the channel is free.
+ *
+ * @param packet: packet slot obtained from m17Packet_allocTx().
+ * @return true on success, false if the packet is empty or too long. In case
+ * of failure the packet slot is released.
+ */
+bool m17Packet_send(m17packet_t *packet);
+
+/**
+ * Submit a short text message for transmission.
+ *
+ * @param dst: destination callsign, empty for broadcast.
+ * @param text: message text, truncated if longer than the maximum packet size.
+ * @return true on success, false if another packet is waiting to be sent.
+ */
+bool m17Packet_sendSms(const char *dst, const char *text);
+
+/**
+ * Submit a position beacon for transmission, as an APRS position report built
+ * from the GPS data.
+ *
+ * @param dst: destination callsign, empty for broadcast.
+ * @param gps: GPS data, usually a copy of the one contained in the radio state.
+ * @return true on success, false if the GPS has no fix or another packet is
+ * waiting to be sent.
+ */
+bool m17Packet_sendPosition(const char *dst, const gps_t *gps);
+
+/**
+ * Get the oldest packet received and not yet read by the application. The
+ * packet slot has to be released through m17Packet_release() once done with
+ * its content, to make it available again for reception.
+ *
+ * @return pointer to the received packet or NULL if there is none.
+ */
+const m17packet_t *m17Packet_receive();
+
+/**
+ * Release a packet slot.
+ *
+ * @param packet: packet slot to be released.
+ */
+void m17Packet_release(const m17packet_t *packet);
+
+/**
+ * Check if there is a packet waiting to be transmitted.
+ *
+ * @return true if a packet is waiting to be transmitted.
+ */
+bool m17Packet_txPending();
+
+/**
+ * Get the packet waiting to be transmitted, to be used by the RTX thread. The
+ * packet slot has to be released at the end of the transmission.
+ *
+ * @return pointer to the packet to be transmitted or NULL if there is none.
+ */
+m17packet_t *m17Packet_getTx();
+
+/**
+ * Get a free packet slot for reception, to be used by the RTX thread.
+ *
+ * @return pointer to the packet slot or NULL if no slot is available.
+ */
+m17packet_t *m17Packet_allocRx();
+
+/**
+ * Make a received packet available to the application, to be used by the RTX
+ * thread.
+ *
+ * @param packet: packet slot obtained from m17Packet_allocRx().
+ */
+void m17Packet_publishRx(m17packet_t *packet);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* M17_PACKET_H */
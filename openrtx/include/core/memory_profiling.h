@@ -21,6 +21,11 @@
 #ifndef MEMORY_PROFILING_H
 #define MEMORY_PROFILING_H
 
+#ifdef PLATFORM_LINUX
+#include <pthread.h>
+#include <stddef.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -68,6 +73,37 @@ unsigned int getAbsoluteFreeHeap();
  */
 unsigned int getCurrentFreeHeap();
 
+#ifdef PLATFORM_LINUX
+
+/**
+ * Provide a profiled stack to a thread about to be created. The stack is
+ * allocated outside the heap, painted with a known pattern and registered
+ * under the given name, so that its high-water mark can be tracked.
+ *
+ * Since stack usage on the host is much larger than on the target devices,
+ * the allocated stack is bigger than the nominal one: the nominal size is
+ * kept only to compare it against the measured peak usage.
+ * When a thread with the same name is created again, the stack of the
+ * previous one is reused without painting it again, thus the peak usage is
+ * tracked across all the instances. The previous thread must have already
+ * terminated.
+ *
+ * @param attr: attributes of the thread to be created.
+ * @param name: name of the thread, the pointed string is not copied.
+ * @param nominalSize: stack size of the thread on the target devices.
+ * @return 0 on success, -1 on failure.
+ */
+int memprof_setThreadStack(pthread_attr_t *attr, const char *name,
+                           const size_t nominalSize);
+
+/**
+ * Print to the standard output a report containing the peak stack usage of
+ * all the profiled threads and the heap usage.
+ */
+void memprof_printReport();
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#ifndef THREAD_STATS_H
+#define THREAD_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Timing statistics of the periodic loops of the system threads.
+ *
+ * Each loop marks the beginning and the end of the active part of its
+ * iterations, excluding the time spent waiting for the next period. From these
+ * marks are computed the duration of the iterations, the jitter of their start
+ * with respect to the nominal period and the number of missed deadlines.
+ * An iteration misses its deadline when its active part lasts more than one
+ * period or when it starts more than one period later than expected. Loops
+ * blocking in the middle of their work mark the waits with threadStats_pause()
+ * and threadStats_resume(), which are not accounted in the duration.
+ *
+ * Times are measured with the system tick, thus have a resolution of one
+ * millisecond. Each loop must be marked only by the thread running it, while
+ * the statistics can be read from any thread.
+ */
+
+/**
+ * Instrumented thread loops.
+ */
+enum threadLoop
+{
+    LOOP_UI = 0,    ///< UI thread, 25ms period
+    LOOP_MAIN,      ///< Main thread, 5ms period
+    LOOP_RTX,       ///< RTX thread, free running
+    LOOP_ENCODE,    ///< CODEC2 encoder thread, 20ms period
+    LOOP_DECODE,    ///< CODEC2 decoder thread, 20ms period
+    LOOP_NUM
+};
+
+/**
+ * Timing statistics of a thread loop, times are in milliseconds.
+ */
+typedef struct
+{
+    uint32_t iterations;    // Number of completed iterations
+    uint32_t period;        // Nominal period, zero for free running loops
+    uint32_t lastDuration;  // Duration of the last iteration
+    uint32_t maxDuration;   // Maximum duration of an iteration
+    uint32_t avgDuration;   // Average duration of an iteration
+    uint32_t maxJitter;     // Maximum deviation of the start from the period
+    uint32_t missed;        // Number of missed deadlines
+}
+threadStats_t;
+
+/**
+ * Mark the beginning of the active part of a loop iteration.
+ *
+ * @param loop: instrumented loop.
+ */
+void threadStats_begin(const enum threadLoop loop);
+
+/**
+ * Mark the end of the active part of a loop iteration.
+ *
+ * @param loop: instrumented loop.
+ */
+void threadStats_end(const enum threadLoop loop);
+
+/**
+ * Mark the beginning of a wait within the active part of a loop iteration.
+ *
+ * @param loop: instrumented loop.
+ */
+void threadStats_pause(const enum threadLoop loop);
+
+/**
+ * Mark the end of a wait within the active part of a loop iteration, the time
+ * elapsed since the call to threadStats_pause() is excluded from the duration
+ * of the iteration.
+ *
+ * @param loop: instrumented loop.
+ */
+void threadStats_resume(const enum threadLoop loop);
+
+/**
+ * Mark the start of a new instance of a loop, the time elapsed since the last
+ * iteration of the previous instance is not accounted as jitter.
+ *
+ * @param loop: instrumented loop.
+ */
+void threadStats_restart(const enum threadLoop loop);
+
+/**
+ * Get the timing statistics of a thread loop.
+ *
+ * @param loop: instrumented loop.
+ * @param stats: pointer to the struct to be populated with the statistics.
+ * @return 0 on success, -1 if the loop is not valid.
+ */
+int threadStats_get(const enum threadLoop loop, threadStats_t *stats);
+
+/**
+ * Clear the timing statistics of all the thread loops.
+ */
+void threadStats_reset();
+
+/**
+ * Write a table with the timing statistics of all the thread loops. On the
+ * radios the standard output is redirected to the USB virtual COM port.
+ *
+ * @param file: output file, for example stdout.
+ */
+void threadStats_dump(FILE *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* THREAD_STATS_H */
@@ -89,6 +89,48 @@ int cps_readBankHeader(bankHdr_t *b_header, uint16_t pos);
  */
 int cps_readBankData(uint16_t bank_pos, uint16_t pos);
 
+/**
+ * Read a range of consecutive contacts from the table stored in nonvolatile
+ * memory, with a single access to the memory where possible. Reading stops at
+ * the end of the table or at the first contact which cannot be read.
+ *
+ * @param contacts: array of at least count contact_t data structures to be
+ * populated.
+ * @param first: position, inside the contact table, of the first contact.
+ * @param count: number of contacts to read.
+ * @return the number of contacts read, -1 if the first one cannot be read
+ */
+int cps_readContacts(contact_t *contacts, uint16_t first, uint16_t count);
+
+/**
+ * Read a range of consecutive channels from the table stored in nonvolatile
+ * memory, with a single access to the memory where possible. Reading stops at
+ * the end of the table or at the first channel which cannot be read.
+ *
+ * @param channels: array of at least count channel_t data structures to be
+ * populated.
+ * @param first: position, inside the channel table, of the first channel.
+ * @param count: number of channels to read.
+ * @return the number of channels read, -1 if the first one cannot be read
+ */
+int cps_readChannels(channel_t *channels, uint16_t first, uint16_t count);
+
+/**
+ * Read a range of consecutive channel indices from a bank of the codeplug
+ * stored in NVM. Reading stops at the end of the bank or at the first index
+ * which cannot be read.
+ *
+ * @param channels: array of at least count elements to be populated with the
+ * channel indices.
+ * @param bank_pos: position of the bank inside the cps.
+ * @param first: position of the first channel index inside the bank.
+ * @param count: number of channel indices to read.
+ * @return the number of channel indices read, -1 if the first one cannot be
+ * read
+ */
+int cps_readBankChannels(uint16_t *channels, uint16_t bank_pos, uint16_t first,
+                         uint16_t count);
+
 /**
  * Overwrite one contact to the codeplug stored in nonvolatile memory.
  *
@@ -31,6 +31,12 @@
 namespace M17
 {
 
+/**
+ * Size of a buffer holding a callsign in text form, including the null
+ * terminator.
+ */
+static constexpr size_t M17_CALLSIGN_SIZE = 10;
+
 /**
  * Encode a callsign in base-40 format, starting with the right-most character.
  * The final value is written out in "big-endian" form, with the most-significant
@@ -55,6 +61,30 @@ bool encode_callsign(const std::string& callsign, call_t& encodedCall,
  */
 std::string decode_callsign(const call_t& encodedCall);
 
+/**
+ * Decode a base-40 encoded callsign to its text representation, without
+ * allocating memory.
+ *
+ * \param encodedCall base-40 encoded callsign.
+ * \param callsign buffer of at least M17_CALLSIGN_SIZE bytes where to store
+ * the decoded text, null-terminated.
+ * \return the length of the decoded text.
+ */
+size_t decode_callsign(const call_t& encodedCall, char *callsign);
+
+/**
+ * Compare two callsigns in plain text form.
+ * The comparison does not take into account the country prefixes up to two
+ * characters long (strips the '/' and whatever is in front of it). It does
+ * take into account the dash and whatever is after it. In case the incoming
+ * callsign is "ALL", "INFO" or "ECHO" the function returns true.
+ *
+ * \param localCs plain text callsign from the user.
+ * \param incomingCs plain text destination callsign.
+ * \return true if local an incoming callsigns match.
+ */
+bool compare_callsigns(const char *localCs, const char *incomingCs);
+
 }      // namespace M17
 
 #endif // M17_CALLSIGN_H
@@ -33,9 +33,11 @@ namespace M17
 
 using call_t    = std::array< uint8_t, 6 >;    // Data type for encoded callsign
 using payload_t = std::array< uint8_t, 16 >;   // Data type for frame payload field
+using pktPayload_t = std::array< uint8_t, 25 >; // Data type for packet frame payload field
 using lich_t    = std::array< uint8_t, 12 >;   // Data type for Golay(24,12) encoded LICH data
 using frame_t   = std::array< uint8_t, 48 >;   // Data type for a full M17 data frame, including sync word
 using syncw_t   = std::array< uint8_t, 2  >;   // Data type for a sync word
+using softFrame_t = std::array< uint16_t, 384 >; // Soft bits of a full M17 frame, including sync word
 
 enum M17DataMode
 {
@@ -65,6 +67,17 @@ enum M17MetaType
     M17_META_EXTD_CALLSIGN = 2,
 };
 
+enum M17PacketType
+{
+    M17_PACKET_RAW     = 0x00,
+    M17_PACKET_AX25    = 0x01,
+    M17_PACKET_APRS    = 0x02,
+    M17_PACKET_6LOWPAN = 0x03,
+    M17_PACKET_IPV4    = 0x04,
+    M17_PACKET_SMS     = 0x05,
+    M17_PACKET_WINLINK = 0x06,
+};
+
 enum M17ScramblingType
 {
     M17_SCRAMBLING_8BIT     = 0,
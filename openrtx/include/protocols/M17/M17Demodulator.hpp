@@ -28,6 +28,7 @@
 #endif
 
 #include <iir.hpp>
+#include <fir.hpp>
 #include <cstdint>
 #include <cstddef>
 #include <memory>
@@ -40,6 +41,7 @@
 #include <M17/M17Constants.hpp>
 #include <M17/Correlator.hpp>
 #include <M17/Synchronizer.hpp>
+#include <M17/M17DSP.hpp>
 
 namespace M17
 {
@@ -86,6 +88,17 @@ public:
      */
     const frame_t& getFrame();
 
+    /**
+     * Returns the soft-decision bits of the last decoded frame. Each element
+     * ranges from 0x0000 (bit is certainly zero) to 0xFFFF (bit is certainly
+     * one) and is derived from the distance of the sampled value from the
+     * symbol decision thresholds.
+     *
+     * @return reference to the internal data structure containing the soft
+     * bits of the last decoded frame.
+     */
+    const softFrame_t& getSoftFrame();
+
     /**
      * Demodulates data from the ADC and fills the idle frame.
      * Everytime this function is called a whole ADC buffer is consumed.
@@ -95,6 +108,19 @@ public:
      */
     bool update(const bool invertPhase = false);
 
+    /**
+     * Demodulates a block of baseband samples, sampled at 24kHz, provided by
+     * the caller instead of the ADC. Samples are processed in place. The block
+     * must not be longer than half of a frame, otherwise decoded frames may be
+     * lost.
+     *
+     * @param samples: pointer to the baseband samples.
+     * @param len: number of samples.
+     * @param invertPhase: invert the phase of the baseband signal before decoding.
+     * @return true if a new frame has been fully decoded.
+     */
+    bool update(int16_t *samples, const size_t len, const bool invertPhase = false);
+
     /**
      * @return true if a demodulator is locked on an M17 stream.
      */
@@ -112,6 +138,23 @@ private:
      */
     int8_t updateFrame(const int16_t sample);
 
+    /**
+     * Convert a normalized bit metric to a soft bit value.
+     *
+     * @param value: bit metric, zero for a certain zero and one for a certain
+     * one. Values outside the [0, 1] range are clamped.
+     * @return soft bit value, from 0x0000 to 0xFFFF.
+     */
+    static uint16_t softBit(const float value);
+
+    /**
+     * Compute the minimum hamming distance between the syncword of the frame
+     * being demodulated and the ones of link setup, stream and packet frames.
+     *
+     * @return minimum hamming distance from a valid syncword.
+     */
+    uint8_t syncwordDistance();
+
     /**
      * Reset the demodulator state.
      */
@@ -151,6 +194,8 @@ private:
     pathId                         basebandPath;    ///< Id of the baseband input path.
     std::unique_ptr<frame_t >      demodFrame;      ///< Frame being demodulated.
     std::unique_ptr<frame_t >      readyFrame;      ///< Fully demodulated frame to be returned.
+    std::unique_ptr<softFrame_t >  demodSoftFrame;  ///< Soft bits of the frame being demodulated.
+    std::unique_ptr<softFrame_t >  readySoftFrame;  ///< Soft bits of the fully demodulated frame.
     bool                           locked;          ///< A syncword was correctly demodulated.
     bool                           newFrame;        ///< A new frame has been fully decoded.
     uint16_t                       frameIndex;      ///< Index for filling the raw frame.
@@ -161,12 +206,24 @@ private:
     uint32_t                       initCount;       ///< Downcounter for initialization
     uint32_t                       syncCount;       ///< Downcounter for resynchronization
     std::pair < int32_t, int32_t > outerDeviation;  ///< Deviation of outer symbols
+    #ifdef CONFIG_DSP_FIXED_POINT
+    int32_t                        corrThreshold;   ///< Correlation threshold
+    filter_state_q15_t             dcrState;        ///< State of the DC removal filter
+    #else
     float                          corrThreshold;   ///< Correlation threshold
     filter_state_t                 dcrState;        ///< State of the DC removal filter
+    #endif
 
     Correlator   < M17_SYNCWORD_SYMBOLS, SAMPLES_PER_SYMBOL > correlator;
     Synchronizer < M17_SYNCWORD_SYMBOLS, SAMPLES_PER_SYMBOL > streamSync{{ -3, -3, -3, -3, +3, +3, -3, +3 }};
+    Synchronizer < M17_SYNCWORD_SYMBOLS, SAMPLES_PER_SYMBOL > packetSync{{ +3, -3, +3, +3, -3, -3, -3, -3 }};
+    #ifdef CONFIG_DSP_FIXED_POINT
+    Iir          < 3, q31_t >                                 sampleFilter{sfNum, sfDen};
+    Fir          < std::tuple_size< decltype(rrc_taps_24k) >::value, q15_t > rrc{rrc_taps_24k};
+    #else
     Iir          < 3 >                                        sampleFilter{sfNum, sfDen};
+    Fir          < std::tuple_size< decltype(rrc_taps_24k) >::value > rrc{rrc_taps_24k};
+    #endif
 };
 
 } /* M17 */
@@ -31,6 +31,8 @@
 #include "M17LinkSetupFrame.hpp"
 #include "M17Viterbi.hpp"
 #include "M17StreamFrame.hpp"
+#include "M17PacketFrame.hpp"
+#include "M17Callsign.hpp"
 
 namespace M17
 {
@@ -44,6 +46,32 @@ enum class M17FrameType : uint8_t
     UNKNOWN    = 4     ///< Frame is unknown.
 };
 
+/**
+ * Stream events detected by the frame decoder.
+ */
+enum class M17RxEvent : uint8_t
+{
+    NONE         = 0,    ///< No event.
+    STREAM_START = 1,    ///< A new stream started, its information is available.
+    LSF_CHANGED  = 2,    ///< The LSF of the current stream changed.
+    STREAM_END   = 3,    ///< The current stream ended.
+    PACKET_START = 4     ///< A packet transmission started, its information is available.
+};
+
+/**
+ * Content of the Link Setup Frame of the current stream or packet, decoded
+ * once each time the LSF changes.
+ */
+struct M17StreamInfo
+{
+    streamType_t type;                          ///< Stream type.
+    char dst[M17_CALLSIGN_SIZE];                ///< Destination callsign.
+    char src[M17_CALLSIGN_SIZE];                ///< Source callsign.
+    char extCall1[M17_CALLSIGN_SIZE];           ///< First extended callsign.
+    char extCall2[M17_CALLSIGN_SIZE];           ///< Second extended callsign.
+    bool extended;                              ///< Extended callsigns present.
+};
+
 /**
  * M17 frame decoder.
  */
@@ -75,6 +103,17 @@ public:
      */
     M17FrameType decodeFrame(const frame_t& frame);
 
+    /**
+     * Decode an M17 frame using soft-decision Viterbi decoding. The frame type
+     * is identified from the hard-decision sync word, payload is decoded from
+     * the soft bits.
+     *
+     * @param frame: byte array containg frame data.
+     * @param softFrame: soft bits of the same frame, sync word included.
+     * @return the type of frame recognized.
+     */
+    M17FrameType decodeFrame(const frame_t& frame, const softFrame_t& softFrame);
+
     /**
      * Get the latest Link Setup Frame decoded. Check of the validity of the
      * data contained in the LSF is left to application code.
@@ -86,6 +125,46 @@ public:
         return lsf;
     }
 
+    /**
+     * Get the last stream event detected and clear it. Events are detected
+     * while decoding the frames: a stream starts with the first valid LSF
+     * received, either directly or reassembled from the LICH, and ends with
+     * the stream frame having the end of stream bit set. A valid packet mode
+     * LSF announces a packet transmission, without starting a stream. Only
+     * the latest event is kept, thus this function should be called after
+     * each frame.
+     *
+     * @return the last stream event detected.
+     */
+    M17RxEvent getEvent()
+    {
+        M17RxEvent ret = event;
+        event = M17RxEvent::NONE;
+        return ret;
+    }
+
+    /**
+     * Check if a stream is currently being received, that is if a valid LSF
+     * has been received and the end of the stream has not been reached yet.
+     *
+     * @return true if a stream is being received.
+     */
+    bool streamActive()
+    {
+        return inStream;
+    }
+
+    /**
+     * Get the decoded information about the current stream or packet, updated
+     * when the STREAM_START, LSF_CHANGED or PACKET_START events are generated.
+     *
+     * @return a reference to the information about the current stream.
+     */
+    const M17StreamInfo& getStreamInfo()
+    {
+        return streamInfo;
+    }
+
     /**
      * Get the latest stream data frame decoded.
      *
@@ -96,6 +175,16 @@ public:
         return streamFrame;
     }
 
+    /**
+     * Get the latest packet data frame decoded.
+     *
+     * @return a reference to the latest packet data frame decoded.
+     */
+    const M17PacketFrame& getPacketFrame()
+    {
+        return packetFrame;
+    }
+
 private:
 
     /**
@@ -125,6 +214,67 @@ private:
      */
     void decodeStream(const std::array< uint8_t, 46 >& data);
 
+    /**
+     * Decode Link Setup Frame soft bits and update the internal LSF field
+     * with the new frame data.
+     *
+     * @param data: array containg frame soft bits, without sync word.
+     */
+    void decodeLSF(const std::array< uint16_t, 368 >& data);
+
+    /**
+     * Decode stream soft bits and update the internal stream frame field
+     * with the new frame data.
+     *
+     * @param data: array containg frame soft bits, without sync word.
+     */
+    void decodeStream(const std::array< uint16_t, 368 >& data);
+
+    /**
+     * Decode packet data and update the internal packet frame field with the
+     * new frame data.
+     *
+     * @param data: byte array containg frame data, without sync word.
+     */
+    void decodePacket(const std::array< uint8_t, 46 >& data);
+
+    /**
+     * Decode packet soft bits and update the internal packet frame field with
+     * the new frame data.
+     *
+     * @param data: array containg frame soft bits, without sync word.
+     */
+    void decodePacket(const std::array< uint16_t, 368 >& data);
+
+    /**
+     * Update the internal packet frame field with the output of the Viterbi
+     * decoder.
+     *
+     * @param decoded: decoded packet frame bits.
+     */
+    void unpackPacket(const std::array< uint8_t, sizeof(M17PacketFrame) >& decoded);
+
+    /**
+     * Check if the latest LSF received is valid and differs from the one of
+     * the current stream, updating the stream information and generating the
+     * corresponding event.
+     */
+    void checkLsf();
+
+    /**
+     * Check if the latest stream frame received is the last one of the
+     * current stream, generating the corresponding event.
+     */
+    void checkEndOfStream();
+
+    /**
+     * Add a decoded LICH segment to the Link Setup Frame being reassembled.
+     *
+     * @param lsfSegment: decoded LICH segment, the last byte contains the
+     * segment number.
+     */
+    void updateLich(const std::array< uint8_t, 6 >& lsfSegment);
+
     /**
      * Decode a LICH block.
      *
@@ -135,12 +285,41 @@ private:
      */
     bool decodeLich(std::array< uint8_t, 6 >& segment, const lich_t& lich);
 
+    /**
+     * Decode a LICH block from its soft bits, using soft-decision decoding of
+     * the Golay codewords.
+     *
+     * @param segment: byte array where to store the decoded Link Setup Frame
+     * segment. The last byte contains the segment number.
+     * @param softLich: soft bits of the LICH block, 96 elements.
+     * @return true when the LICH block is successfully decoded.
+     */
+    bool decodeLich(std::array< uint8_t, 6 >& segment, const uint16_t *softLich);
+
+    /**
+     * Assemble a LICH segment from its four decoded Golay blocks.
+     *
+     * @param segment: byte array where to store the decoded Link Setup Frame
+     * segment. The last byte contains the segment number.
+     * @param blocks: decoded Golay blocks, 0xFFFF marks a block which could
+     * not be decoded.
+     * @return true when the LICH segment is valid.
+     */
+    bool unpackLich(std::array< uint8_t, 6 >& segment,
+                    const std::array< uint16_t, 4 >& blocks);
+
 
     uint8_t           lsfSegmentMap;    ///< Bitmap for LSF reassembly from LICH
     M17LinkSetupFrame lsf;              ///< Latest LSF received.
     M17LinkSetupFrame lsfFromLich;      ///< LSF assembled from LICH segments.
     M17StreamFrame    streamFrame;      ///< Latest stream dat frame received.
+    M17PacketFrame    packetFrame;      ///< Latest packet data frame received.
+    M17LinkSetupFrame streamLsf;        ///< LSF of the current stream.
+    M17StreamInfo     streamInfo;       ///< Decoded LSF of the current stream.
+    M17RxEvent        event;            ///< Last stream event detected.
+    bool              inStream;         ///< A stream is being received.
     M17HardViterbi    viterbi;          ///< Viterbi decoder.
+    M17SoftViterbi    softViterbi;      ///< Soft-decision Viterbi decoder.
 
     ///< Maximum allowed hamming distance when determining the frame type.
     static constexpr uint8_t MAX_SYNC_HAMM_DISTANCE = 4;
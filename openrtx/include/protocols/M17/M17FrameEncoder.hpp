@@ -30,6 +30,7 @@
 #include "M17ConvolutionalEncoder.hpp"
 #include "M17LinkSetupFrame.hpp"
 #include "M17StreamFrame.hpp"
+#include "M17PacketFrame.hpp"
 
 namespace M17
 {
@@ -85,6 +86,15 @@ public:
     uint16_t encodeStreamFrame(const payload_t& payload, frame_t& output,
                                const bool isLast = false);
 
+    /**
+     * Encode a packet data frame into a frame ready for transmission, prepended
+     * with the corresponding sync word.
+     *
+     * @param packetFrame: packet frame to be encoded.
+     * @param output: destination buffer for the encoded data.
+     */
+    void encodePacketFrame(const M17PacketFrame& packetFrame, frame_t& output);
+
     /**
      * Encode an End Of Transmission marker frame.
      *
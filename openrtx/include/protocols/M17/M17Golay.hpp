@@ -52,6 +52,24 @@ uint16_t calcChecksum(const uint16_t& value);
  */
 uint32_t detectErrors(const uint32_t& codeword);
 
+/**
+ * Number of least reliable bits flipped by the soft-decision decoder.
+ */
+static constexpr uint8_t CHASE_BITS = 4;
+
+/**
+ * Decode a Golay(24,12) codeword from its soft bits, using a Chase decoder:
+ * the least reliable bits are flipped in all the possible combinations, each
+ * resulting word is hard decoded and the codeword closest to the soft bits
+ * is selected. This allows to recover some of the codewords having more than
+ * three bit errors.
+ *
+ * @param softBits: 24 soft bits, starting from the most significant one. Each
+ * soft bit ranges from 0x0000 (strong zero) to 0xFFFF (strong one).
+ * @return original data block or 0xFFFF in case of unrecoverable errors.
+ */
+uint16_t softDecode(const uint16_t *softBits);
+
 }   // namespace Golay24
 
 
@@ -28,32 +28,97 @@
 #endif
 
 #include "M17Utils.hpp"
+#include "M17Decorrelator.hpp"
 
 namespace M17
 {
 
 /**
- * Interleave a block of data using the quadratic permutation polynomial from
- * M17 protocol specification. Polynomial used is P(x) = 45*x + 92*x^2.
+ * Permutation table of the quadratic permutation polynomial from M17 protocol
+ * specification, P(x) = 45*x + 92*x^2, computed at compile time for the 368
+ * bits of a frame payload. The permutation is its own inverse, thus the same
+ * table is used for both interleaving and deinterleaving.
+ *
+ * The table also contains the decorrelator sequence reordered through the
+ * permutation, allowing to merge deinterleaving and decorrelation in a single
+ * pass over the frame payload.
+ */
+struct InterleaverTable
+{
+    static constexpr size_t F1 = 45;
+    static constexpr size_t F2 = 92;
+    static constexpr size_t NB = 368;
+
+    uint16_t index[NB];         ///< Bit permutation.
+    uint8_t  sequence[NB / 8];  ///< Permuted decorrelator sequence.
+
+    constexpr InterleaverTable() : index(), sequence()
+    {
+        for(size_t i = 0; i < NB; i++)
+        {
+            size_t pos = ((F1 * i) + (F2 * i * i)) % NB;
+            index[i]   = pos;
+
+            if((M17::sequence[pos / 8] >> (7 - (pos % 8))) & 0x01)
+                sequence[i / 8] |= 0x80 >> (i % 8);
+        }
+    }
+
+    constexpr bool isInvolution() const
+    {
+        for(size_t i = 0; i < NB; i++)
+        {
+            if(index[index[i]] != i)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+static constexpr InterleaverTable interleaverTable;
+static_assert(interleaverTable.isInvolution(), "Interleaver permutation is not self-inverse");
+
+/**
+ * Permute the bits of a block of data through the interleaver table, building
+ * each output byte at once, optionally XORing it with a byte sequence.
  *
  * \param data: input byte array.
+ * \param sequence: byte sequence to be XORed to the output, or nullptr.
  */
 template < size_t N >
-void interleave(std::array< uint8_t, N >& data)
+inline void permute(std::array< uint8_t, N >& data, const uint8_t *sequence)
 {
-    std::array< uint8_t, N > interleaved;
+    static_assert(N * 8 == InterleaverTable::NB, "M17 interleaver is defined only for 368 bit blocks");
 
-    static constexpr size_t F1 = 45;
-    static constexpr size_t F2 = 92;
-    static constexpr size_t NB = N*8;
+    std::array< uint8_t, N > permuted;
+    const uint16_t *index = interleaverTable.index;
 
-    for(size_t i = 0; i < NB; i++)
+    for(size_t i = 0; i < N; i++)
     {
-        size_t index = ((F1 * i) + (F2 * i * i)) % NB;
-        setBit(interleaved, index, getBit(data, i));
+        uint8_t byte = 0;
+        for(size_t j = 0; j < 8; j++)
+        {
+            uint16_t pos = *index++;
+            byte = (byte << 1) | ((data[pos / 8] >> (7 - (pos % 8))) & 0x01);
+        }
+
+        permuted[i] = (sequence != nullptr) ? (byte ^ sequence[i]) : byte;
     }
 
-    std::copy(interleaved.begin(), interleaved.end(), data.begin());
+    std::copy(permuted.begin(), permuted.end(), data.begin());
+}
+
+/**
+ * Interleave a block of data using the quadratic permutation polynomial from
+ * M17 protocol specification. Polynomial used is P(x) = 45*x + 92*x^2.
+ *
+ * \param data: input byte array.
+ */
+template < size_t N >
+inline void interleave(std::array< uint8_t, N >& data)
+{
+    permute(data, nullptr);
 }
 
 /**
@@ -64,18 +129,49 @@ void interleave(std::array< uint8_t, N >& data)
  * \param data: input byte array.
  */
 template < size_t N >
-void deinterleave(std::array< uint8_t, N >& data)
+inline void deinterleave(std::array< uint8_t, N >& data)
 {
-    std::array< uint8_t, N > deinterleaved;
+    permute(data, nullptr);
+}
 
-    static constexpr size_t F1 = 45;
-    static constexpr size_t F2 = 92;
-    static constexpr size_t NB = N*8;
+/**
+ * Interleave and then decorrelate a frame payload in a single pass, as done
+ * before transmission.
+ *
+ * \param data: frame payload.
+ */
+inline void interleaveAndDecorrelate(std::array< uint8_t, 46 >& data)
+{
+    permute(data, M17::sequence.data());
+}
+
+/**
+ * Decorrelate and then deinterleave a received frame payload in a single pass.
+ *
+ * \param data: frame payload.
+ */
+inline void decorrelateAndDeinterleave(std::array< uint8_t, 46 >& data)
+{
+    permute(data, interleaverTable.sequence);
+}
 
-    for(size_t i = 0; i < NB; i++)
+/**
+ * Decorrelate and then deinterleave the soft bits of a received frame payload
+ * in a single pass. Flipping a soft bit corresponds to mirroring its value.
+ *
+ * \param data: soft bits of the frame payload, one element per bit.
+ */
+inline void decorrelateAndDeinterleave(std::array< uint16_t, 368 >& data)
+{
+    std::array< uint16_t, 368 > deinterleaved;
+
+    for(size_t i = 0; i < data.size(); i++)
     {
-        size_t index = ((F1 * i) + (F2 * i * i)) % NB;
-        setBit(deinterleaved, i, getBit(data, index));
+        uint16_t value = data[interleaverTable.index[i]];
+        if((interleaverTable.sequence[i / 8] >> (7 - (i % 8))) & 0x01)
+            value = 0xFFFF - value;
+
+        deinterleaved[i] = value;
     }
 
     std::copy(deinterleaved.begin(), deinterleaved.end(), data.begin());
@@ -28,6 +28,8 @@
 #include <audio_stream.h>
 #include <M17/PwmCompensator.hpp>
 #include <M17/M17Constants.hpp>
+#include <M17/M17DSP.hpp>
+#include <firInterpolator.hpp>
 #include <audio_path.h>
 #include <cstdint>
 #include <memory>
@@ -114,7 +116,6 @@ private:
     static constexpr size_t M17_FRAME_SAMPLES      = M17_FRAME_SYMBOLS * M17_SAMPLES_PER_SYMBOL;
 
     static constexpr float  M17_RRC_GAIN          = 23000.0f;
-    static constexpr float  M17_RRC_OFFSET        = 0.0f;
 
     std::array< int8_t, M17_FRAME_SYMBOLS > symbols;
     std::unique_ptr< int16_t[] > baseband_buffer;  ///< Buffer for baseband audio handling.
@@ -124,6 +125,10 @@ private:
     bool                         txRunning;        ///< Transmission running.
     bool                         invPhase;        ///< Invert signal phase
 
+    /// Polyphase RRC filter, generating the baseband directly from the symbols
+    FirInterpolator< std::tuple_size< decltype(rrc_taps_48k) >::value,
+                     M17_SAMPLES_PER_SYMBOL > rrc{rrc_taps_48k};
+
     #if defined(PLATFORM_MD3x0) || defined(PLATFORM_MDUV3x0)
     PwmCompensator pwmComp;
     #endif
@@ -0,0 +1,170 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#ifndef M17_MULTIRECEIVER_H
+#define M17_MULTIRECEIVER_H
+
+#ifndef __cplusplus
+#error This header is C++ only!
+#endif
+
+#include <M17/M17Demodulator.hpp>
+#include <M17/M17FrameDecoder.hpp>
+#include <lockFreeQueue.hpp>
+#include <pthread.h>
+#include <cstdint>
+#include <cstdio>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace M17
+{
+
+/**
+ * Frame decoded by the multi-channel receiver, tagged with the index of the
+ * channel it has been received from.
+ */
+struct M17RxFrame
+{
+    uint8_t           channel;      ///< Index of the source channel.
+    M17FrameType      type;         ///< Type of the decoded frame.
+    M17LinkSetupFrame lsf;          ///< Latest LSF received on the channel.
+    M17StreamFrame    streamFrame;  ///< Stream frame, valid for STREAM frames.
+};
+
+/**
+ * Multi-channel M17 receiver for linux targets. Each channel is a raw baseband
+ * source (signed 16 bit samples at 24kHz, either a regular file or a FIFO) with
+ * its own demodulator and frame decoder. Channels are statically distributed
+ * among a pool of worker threads and the decoded frames of all the channels
+ * are collected in a single lock-free output queue.
+ */
+class M17MultiReceiver
+{
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param numWorkers: number of worker threads.
+     * @param softDecoding: use soft-decision decoding.
+     */
+    M17MultiReceiver(const size_t numWorkers, const bool softDecoding = true);
+
+    /**
+     * Destructor.
+     */
+    ~M17MultiReceiver();
+
+    /**
+     * Add a new receive channel. Channels can be added only when the receiver
+     * is not running.
+     *
+     * @param path: path of the baseband source.
+     * @param invertPhase: invert the phase of the baseband signal.
+     * @return index of the new channel or a negative error code.
+     */
+    int addChannel(const char *path, const bool invertPhase = false);
+
+    /**
+     * Start the worker threads.
+     *
+     * @return true on success.
+     */
+    bool start();
+
+    /**
+     * Stop the worker threads and wait for their termination.
+     */
+    void stop();
+
+    /**
+     * Check if the receiver is running, that is if at least one worker thread
+     * has still some channel to process.
+     *
+     * @return true if the receiver is running.
+     */
+    bool isRunning();
+
+    /**
+     * Get a decoded frame from the output queue, non-blocking.
+     *
+     * @param frame: place where to store the frame.
+     * @return true if a frame has been retrieved, false if the queue is empty.
+     */
+    bool getFrame(M17RxFrame& frame);
+
+private:
+
+    /**
+     * Internal state of a receive channel.
+     */
+    struct Channel
+    {
+        FILE            *source;
+        bool            invertPhase;
+        bool            locked;
+        bool            done;
+        M17Demodulator  demodulator;
+        M17FrameDecoder decoder;
+        int16_t         samples[960];   // Half a frame at 24kHz
+    };
+
+    /**
+     * Worker thread entry point.
+     */
+    static void *workerFunc(void *arg);
+
+    /**
+     * Worker thread body, processes all the channels assigned to a worker.
+     *
+     * @param worker: worker index.
+     */
+    void work(const size_t worker);
+
+    /**
+     * Process one block of samples of a channel.
+     *
+     * @param index: channel index.
+     * @return false if the channel source is exhausted.
+     */
+    bool processChannel(const size_t index);
+
+    struct WorkerCtx
+    {
+        M17MultiReceiver *rx;
+        size_t           index;
+        pthread_t        thread;
+    };
+
+    const size_t                             numWorkers;
+    const bool                               softDecoding;
+    bool                                     running;
+    std::vector< std::unique_ptr< Channel > > channels;
+    std::vector< WorkerCtx >                 workers;
+    std::atomic< bool >                      stopRequest;
+    std::atomic< size_t >                    activeWorkers;
+    LockFreeQueue< M17RxFrame, 256 >         outQueue;
+};
+
+}      // namespace M17
+
+#endif // M17_MULTIRECEIVER_H
@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#ifndef M17PACKET_H
+#define M17PACKET_H
+
+#ifndef __cplusplus
+#error This header is C++ only!
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include "M17PacketFrame.hpp"
+
+namespace M17
+{
+
+static constexpr size_t M17_PACKET_FRAME_BYTES = 25;
+static constexpr size_t M17_PACKET_MAX_FRAMES  = 33;
+static constexpr size_t M17_PACKET_BUF_SIZE    = M17_PACKET_MAX_FRAMES * M17_PACKET_FRAME_BYTES;
+static constexpr size_t M17_PACKET_MAX_SIZE    = M17_PACKET_BUF_SIZE - 2;
+
+/**
+ * Status of a packet superframe being reassembled.
+ */
+enum class M17PacketStatus : uint8_t
+{
+    INCOMPLETE = 0,    ///< Waiting for further frames.
+    COMPLETE   = 1,    ///< Packet fully received, CRC is valid.
+    ERROR      = 2     ///< Frame lost, packet too long or CRC mismatch.
+};
+
+/**
+ * This class handles an M17 packet superframe, made of the packet content
+ * followed by its CRC and split in chunks of 25 bytes carried by the packet
+ * frames. The first byte of the content is the packet protocol type.
+ *
+ * Packet data is stored in a buffer provided by the application, allowing to
+ * transmit and receive packets without copying their content: the buffer must
+ * be at least M17_PACKET_BUF_SIZE bytes long, to accommodate also the CRC.
+ */
+class M17Packet
+{
+public:
+
+    /**
+     * Constructor.
+     */
+    M17Packet();
+
+    /**
+     * Destructor.
+     */
+    ~M17Packet();
+
+    /**
+     * Prepare a packet for transmission, appending the CRC to its content.
+     *
+     * @param packet: buffer containing the packet content.
+     * @param size: size of the packet content, CRC excluded.
+     * @return false if the packet is empty or exceeds the maximum size.
+     */
+    bool load(uint8_t *packet, const size_t size);
+
+    /**
+     * Get the number of frames needed to transmit the packet.
+     *
+     * @return number of packet frames.
+     */
+    size_t numFrames() const;
+
+    /**
+     * Fill a packet frame with the corresponding chunk of the packet.
+     *
+     * @param index: index of the frame, from zero to numFrames() - 1.
+     * @param frame: packet frame to be filled.
+     */
+    void getFrame(const size_t index, M17PacketFrame& frame) const;
+
+    /**
+     * Start the reassembly of a new packet.
+     *
+     * @param packet: buffer where to store the packet being received.
+     */
+    void reset(uint8_t *packet);
+
+    /**
+     * Append a received frame to the packet being reassembled. Once the packet
+     * is complete or an error occurred, further frames are ignored.
+     *
+     * @param frame: received packet frame.
+     * @return status of the packet reassembly.
+     */
+    M17PacketStatus append(const M17PacketFrame& frame);
+
+    /**
+     * Get the size of the packet content.
+     *
+     * @return packet size, CRC excluded.
+     */
+    size_t size() const;
+
+    /**
+     * Get the packet content.
+     *
+     * @return pointer to the packet buffer.
+     */
+    const uint8_t *data() const
+    {
+        return buffer;
+    }
+
+private:
+
+    uint8_t         *buffer;    ///< Packet buffer.
+    size_t           length;    ///< Packet length, CRC included.
+    uint8_t          nextFrame; ///< Sequence number of the next frame.
+    M17PacketStatus  status;    ///< Reassembly status.
+};
+
+}      // namespace M17
+
+#endif // M17PACKET_H
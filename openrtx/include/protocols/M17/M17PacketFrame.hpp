@@ -0,0 +1,161 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#ifndef M17_PACKET_FRAME_H
+#define M17_PACKET_FRAME_H
+
+#ifndef __cplusplus
+#error This header is C++ only!
+#endif
+
+#include <cstring>
+#include "M17Datatypes.hpp"
+
+namespace M17
+{
+
+class M17FrameDecoder;
+
+/**
+ * This class describes and handles an M17 packet data frame, carrying a chunk
+ * of a packet superframe. The six bit metadata field following the payload
+ * contains the end of frame bit and a counter: when the end of frame bit is
+ * cleared the counter is the frame sequence number, otherwise it contains the
+ * number of valid bytes in the frame.
+ */
+class M17PacketFrame
+{
+public:
+
+    /**
+     * Constructor.
+     */
+    M17PacketFrame()
+    {
+        clear();
+    }
+
+    /**
+     * Destructor.
+     */
+    ~M17PacketFrame(){ }
+
+    /**
+     * Clear the frame content, filling it with zeroes.
+     */
+    void clear()
+    {
+        memset(&data, 0x00, sizeof(data));
+    }
+
+    /**
+     * Set the frame sequence number, clearing the end of frame bit.
+     *
+     * @param seqNum: frame number, between 0 and 31.
+     */
+    void setFrameNumber(const uint8_t seqNum)
+    {
+        data.meta = (seqNum & CNT_MASK) << CNT_SHIFT;
+    }
+
+    /**
+     * Mark this frame as the last one of the packet, setting the end of frame
+     * bit and the number of valid bytes in the frame.
+     *
+     * @param numBytes: number of valid payload bytes, between 1 and 25.
+     */
+    void lastFrame(const uint8_t numBytes)
+    {
+        data.meta = EOF_BIT | ((numBytes & CNT_MASK) << CNT_SHIFT);
+    }
+
+    /**
+     * Check if this frame is the last one of the packet, that is, get the value
+     * of the end of frame bit.
+     *
+     * @return true if the frame has the end of frame bit set.
+     */
+    bool isLastFrame() const
+    {
+        return (data.meta & EOF_BIT) != 0;
+    }
+
+    /**
+     * Get the counter field of the frame: the frame sequence number or, for
+     * the last frame, the number of valid bytes.
+     *
+     * @return value of the counter field.
+     */
+    uint8_t getCounter() const
+    {
+        return (data.meta >> CNT_SHIFT) & CNT_MASK;
+    }
+
+    /**
+     * Access frame payload.
+     *
+     * @return a reference to frame's paylod field, allowing for both read and
+     * write access.
+     */
+    pktPayload_t& payload()
+    {
+        return data.payload;
+    }
+
+    /**
+     * Access frame payload.
+     *
+     * @return a const reference to frame's paylod field.
+     */
+    const pktPayload_t& payload() const
+    {
+        return data.payload;
+    }
+
+    /**
+     * Get underlying data.
+     *
+     * @return a pointer to const uint8_t allowing direct access to frame data.
+     */
+    const uint8_t *getData() const
+    {
+        return reinterpret_cast < const uint8_t * > (&data);
+    }
+
+private:
+
+    struct __attribute__((packed))
+    {
+        pktPayload_t payload;  // Payload data
+        uint8_t      meta;     // End of frame bit and counter, left aligned
+    }
+    data;
+                                                   ///< Frame data.
+    static constexpr uint8_t EOF_BIT   = 0x80;     ///< End Of Frame bit.
+    static constexpr uint8_t CNT_MASK  = 0x1F;     ///< Bitmask for the counter.
+    static constexpr uint8_t CNT_SHIFT = 2;        ///< Position of the counter.
+
+    // Frame decoder class needs to access raw frame data
+    friend class M17FrameDecoder;
+};
+
+}      // namespace M17
+
+#endif // M17_PACKET_FRAME_H
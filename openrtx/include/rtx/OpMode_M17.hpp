@@ -25,7 +25,9 @@
 #include <M17/M17FrameEncoder.hpp>
 #include <M17/M17Demodulator.hpp>
 #include <M17/M17Modulator.hpp>
+#include <M17/M17Packet.hpp>
 #include <audio_path.h>
+#include <m17_packet.h>
 #include "OpMode.hpp"
 
 /**
@@ -122,24 +124,38 @@ private:
     void txState(rtxStatus_t *const status);
 
     /**
-     * Compare two callsigns in plain text form.
-     * The comparison does not take into account the country prefixes (strips
-     * the '/' and whatever is in front from all callsigns). It does take into
-     * account the dash and whatever is after it. In case the incoming callsign
-     * is "ALL" the function returns true.
+     * Function handling the TX operating state when transmitting a packet:
+     * each call sends one frame of the packet waiting to be transmitted.
      *
-     * \param localCs plain text callsign from the user
-     * \param incomingCs plain text destination callsign
-     * \return true if local an incoming callsigns match.
+     * @param status: pointer to the rtxStatus_t structure containing the
+     * current RTX status.
+     */
+    void txPacketState(rtxStatus_t *const status);
+
+    /**
+     * Update the M17 fields of the RTX status with the information about the
+     * stream being received, decoded from its LSF, and check if the stream is
+     * directed to us.
+     *
+     * @param status: pointer to the RTX status.
+     */
+    void updateStreamInfo(rtxStatus_t *const status);
+
+    /**
+     * Check if the CAN and the destination callsign of the stream being
+     * received match with the current configuration, caching the result for
+     * the whole stream.
+     *
+     * @param status: pointer to the RTX status.
      */
-    bool compareCallsigns(const std::string& localCs, const std::string& incomingCs);
+    void updateCallMatch(const rtxStatus_t *const status);
 
 
     bool startRx;                      ///< Flag for RX management.
     bool startTx;                      ///< Flag for TX management.
     bool locked;                       ///< Demodulator locked on data stream.
     bool dataValid;                    ///< Demodulated data is valid
-    bool extendedCall;                 ///< Extended callsign data received
+    bool callMatch;                    ///< Current stream is directed to us
     bool invertTxPhase;                ///< TX signal phase inversion setting.
     bool invertRxPhase;                ///< RX signal phase inversion setting.
     pathId rxAudioPath;                ///< Audio path ID for RX
@@ -148,6 +164,12 @@ private:
     M17::M17Demodulator  demodulator;  ///< M17 demodulator.
     M17::M17FrameDecoder decoder;      ///< M17 frame decoder
     M17::M17FrameEncoder encoder;      ///< M17 frame encoder
+    M17::M17Packet       rxPacket;     ///< Packet being received
+    M17::M17Packet       txPacket;     ///< Packet being transmitted
+    m17packet_t         *rxSlot;       ///< Slot of the packet being received
+    m17packet_t         *txSlot;       ///< Slot of the packet being transmitted
+    size_t               txFrame;      ///< Next packet frame to be transmitted
+    long long            lastBusy;     ///< Last time the channel was busy
 };
 
 #endif /* OPMODE_M17_H */
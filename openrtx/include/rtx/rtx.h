@@ -56,7 +56,8 @@ typedef struct
 
     uint8_t  can      : 4,  /**< M17 Channel Access Number     */
              canRxEn  : 1,  /**< M17 Check CAN on RX           */
-             _unused  : 3;
+             softDec  : 1,  /**< M17 soft-decision decoding    */
+             _unused  : 2;
 
     char     source_address[10];       /**< M17 call source address    */
     char     destination_address[10];  /**< M17 call routing address   */
@@ -0,0 +1,174 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN,                            *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#ifndef UI_WIDGETS_H
+#define UI_WIDGETS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <graphics.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Retained mode widgets for the user interface.
+ *
+ * Each widget remembers what it rendered on the screen and is re-rasterized
+ * only when its content changes. Widgets rendered before the last call to
+ * widget_invalidateAll() are considered to be no more on the screen and are
+ * fully redrawn at their next update: the caller has to clear the screen
+ * before invalidating the widgets, typically when the active screen or its
+ * layout changes.
+ *
+ * Widgets are plain structures which must be zero-initialised, a zeroed
+ * widget is never considered as being on the screen.
+ */
+
+/**
+ * Text label.
+ */
+typedef struct
+{
+    uint16_t    epoch;      // Screen epoch of the last render
+    point_t     pos;        // Text position
+    fontSize_t  font;       // Text font
+    textAlign_t align;      // Text alignment
+    color_t     color;      // Text color
+    char        text[32];   // Text currently on the screen
+}
+uiLabel_t;
+
+/**
+ * Value field: a text label bound to a numeric state value, formatted only
+ * when the value changes.
+ */
+typedef struct
+{
+    uiLabel_t label;        // Label showing the value
+    uint32_t  value;        // Value currently on the screen
+}
+uiValue_t;
+
+/**
+ * Generic box widget, used for meters and graphic elements. The content of the
+ * box is represented by an hash of the state it has been drawn from.
+ */
+typedef struct
+{
+    uint16_t epoch;         // Screen epoch of the last render
+    uint32_t hash;          // Hash of the content currently on the screen
+}
+uiBox_t;
+
+/**
+ * List widget, keeps track of the visible window and of the selected entry to
+ * redraw only the entries affected by a change of selection.
+ */
+typedef struct
+{
+    uint16_t epoch;         // Screen epoch of the last render
+    uint8_t  first;         // Index of the first visible entry
+    uint8_t  selected;      // Index of the selected entry
+    uint8_t  prevSelected;  // Index of the previously selected entry
+    bool     full;          // All the visible entries have to be redrawn
+}
+uiList_t;
+
+
+/**
+ * Mark all the widgets as being no more on the screen.
+ */
+void widget_invalidateAll();
+
+/**
+ * Update a text label. If the label content or its style changed, the old
+ * text is erased and the new one is rendered.
+ *
+ * @param label: pointer to the label.
+ * @param pos: text position.
+ * @param font: text font.
+ * @param align: text alignment.
+ * @param color: text color.
+ * @param fmt: printf style format string.
+ * @return true if the label has been redrawn.
+ */
+bool widget_label(uiLabel_t *label, point_t pos, fontSize_t font,
+                  textAlign_t align, color_t color, const char *fmt, ...);
+
+/**
+ * Update a value field. If the value is the same currently displayed, the
+ * function returns without formatting the text.
+ *
+ * @param field: pointer to the value field.
+ * @param value: value the field is bound to.
+ * @param pos: text position.
+ * @param font: text font.
+ * @param align: text alignment.
+ * @param color: text color.
+ * @param fmt: printf style format string.
+ * @return true if the field has been redrawn.
+ */
+bool widget_value(uiValue_t *field, uint32_t value, point_t pos,
+                  fontSize_t font, textAlign_t align, color_t color,
+                  const char *fmt, ...);
+
+/**
+ * Check if a box widget has to be redrawn and, in case, clear its area.
+ * Widgets whose presence and content are fixed by the screen layout can pass
+ * a zero sized area and no content, to be drawn once after each invalidation.
+ *
+ * @param box: pointer to the box widget.
+ * @param pos: top left corner of the widget area.
+ * @param width: width of the widget area.
+ * @param height: height of the widget area.
+ * @param content: state the widget content is drawn from.
+ * @param len: size of the state, in bytes.
+ * @return true if the caller has to draw the widget content.
+ */
+bool widget_box(uiBox_t *box, point_t pos, uint16_t width, uint16_t height,
+                const void *content, size_t len);
+
+/**
+ * Update the state of a list widget.
+ *
+ * @param list: pointer to the list widget.
+ * @param first: index of the first visible entry.
+ * @param selected: index of the selected entry.
+ * @return true if at least one entry has to be redrawn.
+ */
+bool widget_listUpdate(uiList_t *list, uint8_t first, uint8_t selected);
+
+/**
+ * Check if a list entry has to be redrawn after the last call to
+ * widget_listUpdate().
+ *
+ * @param list: pointer to the list widget.
+ * @param index: entry index.
+ * @return true if the entry has to be redrawn.
+ */
+bool widget_listEntryDirty(const uiList_t *list, uint8_t index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UI_WIDGETS_H */
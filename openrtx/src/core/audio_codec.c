@@ -20,6 +20,7 @@
 
 #include <audio_stream.h>
 #include <audio_codec.h>
+#include <hwconfig.h>
 #include <pthread.h>
 #include <threads.h>
 // codec2 system library has a weird include prefix
@@ -28,30 +29,98 @@
 #else
 #include <codec2.h>
 #endif
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <errno.h>
 #include <dsp.h>
+#include <thread_stats.h>
+#ifdef PLATFORM_LINUX
+#include <memory_profiling.h>
+#endif
+
+/*
+ * Depth of the frame queue, must be a power of two. Can be overridden by the
+ * target, for example to deepen the playout buffer for network-fed audio.
+ */
+#ifndef CONFIG_CODEC2_QUEUE_DEPTH
+#define CONFIG_CODEC2_QUEUE_DEPTH 4
+#endif
+
+/*
+ * Minimum playout latency, in frames of 20ms, kept by the decoder before
+ * starting to play a stream. In adaptive mode the latency is raised on each
+ * underrun and lowered after a window without underruns, between this value
+ * and the queue depth minus one.
+ */
+#ifndef CONFIG_CODEC2_PLAYOUT_LATENCY
+#define CONFIG_CODEC2_PLAYOUT_LATENCY 2
+#endif
 
-#define BUF_SIZE 4
+#define BUF_SIZE     CONFIG_CODEC2_QUEUE_DEPTH
+#define CACHE_LINE   64
+#define MAX_LATENCY  (BUF_SIZE - 1)
+#define PLC_FRAMES   5      // Concealed frames before muting the output
+#define ADAPT_FRAMES 50     // Frames in a latency adaptation window, 1s
+
+_Static_assert((BUF_SIZE != 0) && ((BUF_SIZE & (BUF_SIZE - 1)) == 0),
+               "Codec queue depth must be a power of two");
+_Static_assert((CONFIG_CODEC2_PLAYOUT_LATENCY > 0) &&
+               (CONFIG_CODEC2_PLAYOUT_LATENCY <= MAX_LATENCY),
+               "Codec playout latency must be lower than the queue depth");
+
+enum PlayoutAction
+{
+    PLAYOUT_SILENCE,    // Nothing to play
+    PLAYOUT_DECODE,     // Decode a new frame
+    PLAYOUT_CONCEAL     // Frame missing, conceal its loss
+};
+
+/*
+ * State of the playout buffer of the decoder.
+ */
+typedef struct
+{
+    bool     playing;       // Playout started
+    uint8_t  latency;       // Target latency, in frames
+    uint8_t  lostCount;     // Consecutive concealed frames
+    uint8_t  minLevel;      // Minimum queue level in the adaptation window
+    uint8_t  frameCount;    // Frames played in the adaptation window
+    bool     underrun;      // Queue underrun in the adaptation window
+    uint64_t lastFrame;     // Last frame played
+}
+playout_t;
 
 static pathId           audioPath;
 
 static uint8_t          initCnt = 0;
-static bool             running;
+static atomic_bool      running;
 
-static bool             reqStop;
+static atomic_bool      reqStop;
+static atomic_bool      streamEnded;
+static bool             adaptivePlayout;
 static pthread_t        codecThread;
 static pthread_attr_t   codecAttr;
-static pthread_mutex_t  data_mutex  = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t  init_mutex  = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t  wait_mutex  = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t   wakeup_cond = PTHREAD_COND_INITIALIZER;
 
-static uint8_t          readPos;
-static uint8_t          writePos;
-static uint8_t          numElements;
+/*
+ * Single-producer single-consumer frame queue. Read and write positions are
+ * free running counters, each one written only by its owner and placed on a
+ * separate cache line. The mutex and the condition variable are used only by
+ * the blocking calls, when they actually have to wait.
+ */
+static _Alignas(CACHE_LINE) atomic_uint writePos;
+static _Alignas(CACHE_LINE) atomic_uint readPos;
+static _Alignas(CACHE_LINE) atomic_uint waiters;
 static uint64_t         dataBuffer[BUF_SIZE];
+static atomic_uint      overruns;
+static atomic_uint      underruns;
+static atomic_uint      lostFrames;
+static atomic_uint      lateFrames;
+static atomic_uint      playoutLatency;
 
 #ifdef PLATFORM_MOD17
 static const uint8_t micGainPre  = 4;
@@ -67,6 +136,15 @@ static void *encodeFunc(void *arg);
 static void *decodeFunc(void *arg);
 static bool startThread(const pathId path, void *(*func) (void *));
 static void stopThread();
+static void resetQueue();
+static bool queuePush(const uint64_t frame);
+static bool queuePop(uint64_t *frame);
+static void queueWait(const bool forData);
+static void queueWakeup();
+static void playoutReset(playout_t *playout);
+static enum PlayoutAction playoutNext(playout_t *playout, uint64_t *frame);
+static void applyGain(stream_sample_t *buf, const size_t len,
+                      const int32_t startGain, const int32_t endGain);
 
 
 void codec_init()
@@ -78,10 +156,8 @@ void codec_init()
     if(initCnt > 0)
         return;
 
-    running     = false;
-    readPos     = 0;
-    writePos    = 0;
-    numElements = 0;
+    running = false;
+    resetQueue();
 }
 
 void codec_terminate()
@@ -102,8 +178,11 @@ bool codec_startEncode(const pathId path)
     return startThread(path, encodeFunc);
 }
 
-bool codec_startDecode(const pathId path)
+bool codec_startDecode(const pathId path, const bool adaptive)
 {
+    if(running == false)
+        adaptivePlayout = adaptive;
+
     return startThread(path, decodeFunc);
 }
 
@@ -130,24 +209,22 @@ int codec_popFrame(uint8_t *frame, const bool blocking)
 
     uint64_t element;
 
-    // No data available and non-blocking call: just return false.
-    if((numElements == 0) && (blocking == false))
-        return -EAGAIN;
-
-    // Blocking call: wait until some data is pushed
-    pthread_mutex_lock(&data_mutex);
-    while(numElements == 0)
+    while(queuePop(&element) == false)
     {
-        pthread_cond_wait(&wakeup_cond, &data_mutex);
-    }
+        // No data available and non-blocking call: just return.
+        if(blocking == false)
+        {
+            atomic_fetch_add_explicit(&underruns, 1, memory_order_relaxed);
+            return -EAGAIN;
+        }
 
-    element      = dataBuffer[readPos];
-    readPos      = (readPos + 1) % BUF_SIZE;
-    numElements -= 1;
-    pthread_mutex_unlock(&data_mutex);
+        // Blocking call: wait until some data is pushed
+        queueWait(true);
+
+        if(running == false)
+            return -EPERM;
+    }
 
-    // Do memcpy after mutex unlock to reduce execution time spent inside the
-    // critical section
     memcpy(frame, &element, 8);
 
     return 0;
@@ -158,34 +235,53 @@ int codec_pushFrame(const uint8_t *frame, const bool blocking)
     if(running == false)
         return -EPERM;
 
-    // Copy data to a temporary variable before mutex lock to reduce execution
-    // time spent inside the critical section
     uint64_t element;
     memcpy(&element, frame, 8);
 
+    // New data, the stream goes on
+    atomic_store_explicit(&streamEnded, false, memory_order_relaxed);
 
-    // No space available and non-blocking call: return
-    if((numElements >= BUF_SIZE) && (blocking == false))
-        return -EAGAIN;
-
-    // Blocking call: wait until there is some free space
-    pthread_mutex_lock(&data_mutex);
-    while(numElements >= BUF_SIZE)
+    while(queuePush(element) == false)
     {
-        pthread_cond_wait(&wakeup_cond, &data_mutex);
-    }
+        // No space available and non-blocking call: return. Only real-time
+        // sources lose the frame, the other ones retry it later.
+        if(blocking == false)
+        {
+            if(adaptivePlayout)
+                atomic_fetch_add_explicit(&overruns, 1, memory_order_relaxed);
 
-    // There is free space, push data into the queue
-    dataBuffer[writePos] = element;
-    writePos = (writePos + 1) % BUF_SIZE;
-    numElements += 1;
+            return -EAGAIN;
+        }
+
+        // Blocking call: wait until there is some free space
+        queueWait(false);
+
+        if(running == false)
+            return -EPERM;
+    }
 
-    pthread_mutex_unlock(&data_mutex);
     return 0;
 }
 
+void codec_endStream()
+{
+    atomic_store(&streamEnded, true);
+}
+
+codecQueueStats_t codec_getQueueStats()
+{
+    codecQueueStats_t stats;
 
+    stats.depth     = BUF_SIZE;
+    stats.level     = atomic_load(&writePos) - atomic_load(&readPos);
+    stats.overruns  = atomic_load(&overruns);
+    stats.underruns = atomic_load(&underruns);
+    stats.latency   = atomic_load(&playoutLatency);
+    stats.lost      = atomic_load(&lostFrames);
+    stats.late      = atomic_load(&lateFrames);
 
+    return stats;
+}
 
 static void *encodeFunc(void *arg)
 {
@@ -207,6 +303,7 @@ static void *encodeFunc(void *arg)
 
     dsp_resetFilterState(&dcrState);
     codec2 = codec2_create(CODEC2_MODE_3200);
+    threadStats_restart(LOOP_ENCODE);
 
     while(reqStop == false)
     {
@@ -218,6 +315,8 @@ static void *encodeFunc(void *arg)
         if(audio.data == NULL)
             break;
 
+        threadStats_begin(LOOP_ENCODE);
+
         #ifndef PLATFORM_LINUX
         // Pre-amplification stage
         for(size_t i = 0; i < audio.len; i++) audio.data[i] *= micGainPre;
@@ -236,24 +335,12 @@ static void *encodeFunc(void *arg)
         uint64_t frame = 0;
         codec2_encode(codec2, ((uint8_t*) &frame), audio.data);
 
-        pthread_mutex_lock(&data_mutex);
+        // If the queue is full the frame gets dropped, the consumer is
+        // lagging behind and will pick up the older frames first.
+        if(queuePush(frame) == false)
+            atomic_fetch_add_explicit(&overruns, 1, memory_order_relaxed);
 
-        // If buffer is full erase the oldest frame
-        if(numElements >= BUF_SIZE)
-        {
-            readPos = (readPos + 1) % BUF_SIZE;
-        }
-
-        dataBuffer[writePos] = frame;
-        writePos = (writePos + 1) % BUF_SIZE;
-
-        if(numElements == 0)
-            pthread_cond_signal(&wakeup_cond);
-
-        if(numElements < BUF_SIZE)
-            numElements += 1;
-
-        pthread_mutex_unlock(&data_mutex);
+        threadStats_end(LOOP_ENCODE);
     }
 
     audioStream_terminate(iStream);
@@ -265,6 +352,8 @@ static void *encodeFunc(void *arg)
         pthread_detach(pthread_self());
 
     running = false;
+    queueWakeup();
+
     return NULL;
 }
 
@@ -274,6 +363,8 @@ static void *decodeFunc(void *arg)
     pathId          oPath = *((pathId*) arg);
     stream_sample_t audioBuf[320];
     struct CODEC2   *codec2;
+    playout_t       playout;
+    int32_t         gain = 0;
 
     // Open output stream
     memset(audioBuf, 0x00, 320 * sizeof(stream_sample_t));
@@ -287,12 +378,14 @@ static void *decodeFunc(void *arg)
     }
 
     codec2 = codec2_create(CODEC2_MODE_3200);
+    playoutReset(&playout);
 
     // Ensure that thread start is correctly synchronized with the output
     // stream to avoid having the decode function writing in a memory area
     // being read at the same time by the output stream system causing cracking
     // noises at speaker output. Behaviour observed on both Module17 and MD-UV380
     outputStream_sync(oStream, false);
+    threadStats_restart(LOOP_DECODE);
 
     while(reqStop == false)
     {
@@ -300,44 +393,45 @@ static void *decodeFunc(void *arg)
         if(audioPath_getStatus(oPath) != PATH_OPEN)
             break;
 
-        // Try popping data from the queue
-        uint64_t frame   = 0;
-        bool     newData = false;
+        threadStats_begin(LOOP_DECODE);
 
-        pthread_mutex_lock(&data_mutex);
-
-        if(numElements != 0)
-        {
-            frame        = dataBuffer[readPos];
-            readPos      = (readPos + 1) % BUF_SIZE;
-            if(numElements >= BUF_SIZE)
-                pthread_cond_signal(&wakeup_cond);
-
-            numElements -= 1;
-            newData      = true;
-        }
-
-        pthread_mutex_unlock(&data_mutex);
+        // Get the next frame to be played from the playout buffer
+        uint64_t frame = 0;
+        enum PlayoutAction action = playoutNext(&playout, &frame);
 
         stream_sample_t *audioBuf = outputStream_getIdleBuffer(oStream);
         if(audioBuf == NULL)
             break;
 
-        if(newData)
+        if(action == PLAYOUT_SILENCE)
+        {
+            memset(audioBuf, 0x00, 160 * sizeof(stream_sample_t));
+            gain = 0;
+        }
+        else
         {
+            // Missing frames are concealed by decoding again the last one,
+            // fading it out. Gain changes are ramped over the whole frame
+            // to avoid clicks, also when the stream starts or resumes.
+            int32_t newGain = 32768;
+            if(action == PLAYOUT_CONCEAL)
+            {
+                newGain = gain - (32768 / PLC_FRAMES);
+                if(newGain < 0)
+                    newGain = 0;
+            }
+
             codec2_decode(codec2, audioBuf, ((uint8_t *) &frame));
+            applyGain(audioBuf, 160, gain, newGain);
+            gain = newGain;
 
             #ifdef PLATFORM_MD3x0
             // Bump up volume a little bit, as on MD3x0 is quite low
             for(size_t i = 0; i < 160; i++) audioBuf[i] *= 2;
             #endif
-
-        }
-        else
-        {
-            memset(audioBuf, 0x00, 160 * sizeof(stream_sample_t));
         }
 
+        threadStats_end(LOOP_DECODE);
         outputStream_sync(oStream, true);
     }
 
@@ -351,6 +445,8 @@ static void *decodeFunc(void *arg)
         pthread_detach(pthread_self());
 
     running = false;
+    queueWakeup();
+
     return NULL;
 }
 
@@ -391,10 +487,8 @@ static bool startThread(const pathId path, void *(*func) (void *))
     audioPath = path;
     pthread_mutex_unlock(&init_mutex);
 
-    readPos     = 0;
-    writePos    = 0;
-    numElements = 0;
-    reqStop     = false;
+    resetQueue();
+    reqStop = false;
 
     pthread_attr_init(&codecAttr);
 
@@ -410,6 +504,8 @@ static bool startThread(const pathId path, void *(*func) (void *))
     // Allocate and set the stack for CODEC2 thread
     void *codec_thread_stack = malloc(CODEC2_THREAD_STKSIZE * sizeof(uint8_t));
     pthread_attr_setstack(&codecAttr, codec_thread_stack, CODEC2_THREAD_STKSIZE);
+    #elif defined(PLATFORM_LINUX)
+    memprof_setThreadStack(&codecAttr, "CODEC2", CODEC2_THREAD_STKSIZE);
     #endif
 
     // Start thread
@@ -434,3 +530,211 @@ static void stopThread()
     free(addr);
     #endif
 }
+
+static void resetQueue()
+{
+    atomic_store(&readPos,    0);
+    atomic_store(&writePos,   0);
+    atomic_store(&overruns,   0);
+    atomic_store(&underruns,  0);
+    atomic_store(&lostFrames, 0);
+    atomic_store(&lateFrames, 0);
+    atomic_store(&playoutLatency, CONFIG_CODEC2_PLAYOUT_LATENCY);
+    atomic_store(&streamEnded, false);
+}
+
+static bool queuePush(const uint64_t frame)
+{
+    unsigned int wrPos = atomic_load_explicit(&writePos, memory_order_relaxed);
+    unsigned int rdPos = atomic_load_explicit(&readPos,  memory_order_acquire);
+
+    if((wrPos - rdPos) >= BUF_SIZE)
+        return false;
+
+    dataBuffer[wrPos & (BUF_SIZE - 1)] = frame;
+    atomic_store_explicit(&writePos, wrPos + 1, memory_order_release);
+    queueWakeup();
+
+    return true;
+}
+
+static bool queuePop(uint64_t *frame)
+{
+    unsigned int rdPos = atomic_load_explicit(&readPos,  memory_order_relaxed);
+    unsigned int wrPos = atomic_load_explicit(&writePos, memory_order_acquire);
+
+    if(wrPos == rdPos)
+        return false;
+
+    *frame = dataBuffer[rdPos & (BUF_SIZE - 1)];
+    atomic_store_explicit(&readPos, rdPos + 1, memory_order_release);
+    queueWakeup();
+
+    return true;
+}
+
+static void queueWait(const bool forData)
+{
+    pthread_mutex_lock(&wait_mutex);
+    atomic_fetch_add(&waiters, 1);
+
+    // Pairs with the fence in queueWakeup(): either the other side sees the
+    // waiter registered or the waiter sees the updated queue positions.
+    atomic_thread_fence(memory_order_seq_cst);
+
+    while(running && (reqStop == false))
+    {
+        unsigned int level = atomic_load(&writePos) - atomic_load(&readPos);
+        if(forData && (level != 0))
+            break;
+
+        if((forData == false) && (level < BUF_SIZE))
+            break;
+
+        pthread_cond_wait(&wakeup_cond, &wait_mutex);
+    }
+
+    atomic_fetch_sub(&waiters, 1);
+    pthread_mutex_unlock(&wait_mutex);
+}
+
+static void queueWakeup()
+{
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if(atomic_load_explicit(&waiters, memory_order_relaxed) == 0)
+        return;
+
+    pthread_mutex_lock(&wait_mutex);
+    pthread_cond_broadcast(&wakeup_cond);
+    pthread_mutex_unlock(&wait_mutex);
+}
+
+static void playoutReset(playout_t *playout)
+{
+    playout->playing      = false;
+    playout->latency      = CONFIG_CODEC2_PLAYOUT_LATENCY;
+    playout->lostCount    = 0;
+    playout->minLevel     = BUF_SIZE;
+    playout->frameCount   = 0;
+    playout->underrun     = false;
+    playout->lastFrame    = 0;
+}
+
+static enum PlayoutAction playoutNext(playout_t *playout, uint64_t *frame)
+{
+    unsigned int level = atomic_load_explicit(&writePos, memory_order_acquire)
+                       - atomic_load_explicit(&readPos,  memory_order_relaxed);
+
+    // Wait for the queue to fill up to the target latency before starting
+    if(playout->playing == false)
+    {
+        if(level < playout->latency)
+            return PLAYOUT_SILENCE;
+
+        playout->playing      = true;
+        playout->minLevel     = BUF_SIZE;
+        playout->frameCount   = 0;
+        playout->underrun     = false;
+    }
+
+    // Stream ended and all its frames played: nothing is missing, stop and
+    // buffer again for the next one.
+    if((level == 0) && atomic_load_explicit(&streamEnded, memory_order_relaxed))
+    {
+        playout->playing   = false;
+        playout->lostCount = 0;
+        return PLAYOUT_SILENCE;
+    }
+
+    // Frame missing at its playout time: increase the latency to make the next
+    // underrun less likely and conceal the loss for a while, then stop and
+    // buffer again.
+    if(level == 0)
+    {
+        atomic_fetch_add_explicit(&underruns, 1, memory_order_relaxed);
+
+        if((adaptivePlayout) && (playout->lostCount == 0) &&
+           (playout->latency < MAX_LATENCY))
+        {
+            playout->latency += 1;
+            atomic_store(&playoutLatency, playout->latency);
+        }
+
+        playout->underrun   = true;
+        playout->lostCount += 1;
+        if(playout->lostCount > PLC_FRAMES)
+        {
+            playout->playing   = false;
+            playout->lostCount = 0;
+            return PLAYOUT_SILENCE;
+        }
+
+        atomic_fetch_add_explicit(&lostFrames, 1, memory_order_relaxed);
+        *frame = playout->lastFrame;
+
+        return PLAYOUT_CONCEAL;
+    }
+
+    if(adaptivePlayout)
+    {
+        uint64_t discard;
+
+        // Frames arrived after their slot has been concealed: drop them, as
+        // long as the queue stays above the target latency.
+        while((playout->lostCount > 0) && (level > playout->latency))
+        {
+            queuePop(&discard);
+            atomic_fetch_add_explicit(&lateFrames, 1, memory_order_relaxed);
+            playout->lostCount -= 1;
+            level              -= 1;
+        }
+
+        // At the end of each window, lower the target latency if the queue
+        // never underran and drop one frame if the queue never went below
+        // the target, meaning that the frames are waiting more than needed.
+        if(level < playout->minLevel)
+            playout->minLevel = level;
+
+        playout->frameCount += 1;
+        if(playout->frameCount >= ADAPT_FRAMES)
+        {
+            if((playout->underrun == false) &&
+               (playout->latency > CONFIG_CODEC2_PLAYOUT_LATENCY))
+            {
+                playout->latency -= 1;
+                atomic_store(&playoutLatency, playout->latency);
+            }
+
+            if((playout->minLevel >= playout->latency) && (level > 1))
+            {
+                queuePop(&discard);
+                atomic_fetch_add_explicit(&lateFrames, 1, memory_order_relaxed);
+            }
+
+            playout->minLevel     = BUF_SIZE;
+            playout->frameCount   = 0;
+            playout->underrun     = false;
+        }
+    }
+
+    playout->lostCount = 0;
+    queuePop(frame);
+    playout->lastFrame = *frame;
+
+    return PLAYOUT_DECODE;
+}
+
+static void applyGain(stream_sample_t *buf, const size_t len,
+                      const int32_t startGain, const int32_t endGain)
+{
+    if((startGain == 32768) && (endGain == 32768))
+        return;
+
+    // Linear ramp from the start to the end gain, both in Q15
+    for(size_t i = 0; i < len; i++)
+    {
+        int32_t gain = startGain + (((endGain - startGain) * (int32_t) i) / (int32_t) len);
+        buf[i] = (stream_sample_t) ((buf[i] * gain) >> 15);
+    }
+}
@@ -0,0 +1,284 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <interfaces/cps_io.h>
+#include <cps_cache.h>
+#include <cps_index.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * Number of decoded entries kept for each of the channel, contact and bank
+ * tables.
+ */
+#ifndef CONFIG_CPS_CACHE_SIZE
+#define CONFIG_CPS_CACHE_SIZE 8
+#endif
+
+/**
+ * Number of name pages kept for each of the channel, contact and bank tables.
+ */
+#ifndef CONFIG_CPS_CACHE_NAME_PAGES
+#define CONFIG_CPS_CACHE_NAME_PAGES 4
+#endif
+
+#define NAME_PAGE_SIZE 8
+
+/**
+ * LRU tag of a cache slot.
+ */
+typedef struct
+{
+    uint16_t pos;       // Codeplug position of the cached entry or page
+    uint32_t used;      // Time of last use, zero for empty slots
+}
+lruTag_t;
+
+/**
+ * Names of a group of consecutive codeplug entries.
+ */
+typedef struct
+{
+    uint8_t count;                                  // Number of valid names
+    char    names[NAME_PAGE_SIZE][CPS_STR_SIZE];    // Entry names
+}
+namePage_t;
+
+/**
+ * Name index of a codeplug table.
+ */
+typedef struct
+{
+    lruTag_t   tags[CONFIG_CPS_CACHE_NAME_PAGES];
+    namePage_t pages[CONFIG_CPS_CACHE_NAME_PAGES];
+    int        (*readNames)(namePage_t *page, uint16_t first);
+}
+nameIndex_t;
+
+static int readChannelNames(namePage_t *page, uint16_t first);
+static int readContactNames(namePage_t *page, uint16_t first);
+static int readBankNames(namePage_t *page, uint16_t first);
+
+static uint32_t useCount = 0;
+
+static lruTag_t  channelTags[CONFIG_CPS_CACHE_SIZE];
+static channel_t channels[CONFIG_CPS_CACHE_SIZE];
+static lruTag_t  contactTags[CONFIG_CPS_CACHE_SIZE];
+static contact_t contacts[CONFIG_CPS_CACHE_SIZE];
+static lruTag_t  bankTags[CONFIG_CPS_CACHE_SIZE];
+static bankHdr_t banks[CONFIG_CPS_CACHE_SIZE];
+
+static nameIndex_t channelNames = { .readNames = readChannelNames };
+static nameIndex_t contactNames = { .readNames = readContactNames };
+static nameIndex_t bankNames    = { .readNames = readBankNames    };
+
+// Destination of the batched reads loading the name pages
+static union
+{
+    channel_t channels[NAME_PAGE_SIZE];
+    contact_t contacts[NAME_PAGE_SIZE];
+}
+pageBuf;
+
+
+/**
+ * @internal
+ * Look for an entry in a set of cache slots. If the entry is not present, the
+ * least recently used slot is assigned to it.
+ *
+ * @param tags: tags of the cache slots.
+ * @param num: number of cache slots.
+ * @param pos: codeplug position of the entry.
+ * @param slot: index of the slot holding the entry.
+ * @return true if the entry is already present in the cache.
+ */
+static bool lruLookup(lruTag_t *tags, const size_t num, const uint16_t pos,
+                      size_t *slot)
+{
+    size_t victim = 0;
+
+    useCount += 1;
+
+    for(size_t i = 0; i < num; i++)
+    {
+        if((tags[i].used != 0) && (tags[i].pos == pos))
+        {
+            tags[i].used = useCount;
+            *slot = i;
+            return true;
+        }
+
+        if(tags[i].used < tags[victim].used)
+            victim = i;
+    }
+
+    tags[victim].pos  = pos;
+    tags[victim].used = useCount;
+    *slot = victim;
+
+    return false;
+}
+
+static int readChannelNames(namePage_t *page, uint16_t first)
+{
+    int count = cps_readChannels(pageBuf.channels, first, NAME_PAGE_SIZE);
+
+    for(int i = 0; i < count; i++)
+        memcpy(page->names[i], pageBuf.channels[i].name, CPS_STR_SIZE);
+
+    return count;
+}
+
+static int readContactNames(namePage_t *page, uint16_t first)
+{
+    int count = cps_readContacts(pageBuf.contacts, first, NAME_PAGE_SIZE);
+
+    for(int i = 0; i < count; i++)
+        memcpy(page->names[i], pageBuf.contacts[i].name, CPS_STR_SIZE);
+
+    return count;
+}
+
+static int readBankNames(namePage_t *page, uint16_t first)
+{
+    int count;
+
+    for(count = 0; count < NAME_PAGE_SIZE; count++)
+    {
+        bankHdr_t bank;
+        if(cps_readBankHeader(&bank, first + count) < 0)
+            break;
+
+        memcpy(page->names[count], bank.name, CPS_STR_SIZE);
+    }
+
+    return count;
+}
+
+static int getName(nameIndex_t *index, char *buf, const size_t len,
+                   const uint16_t pos)
+{
+    uint16_t page  = pos / NAME_PAGE_SIZE;
+    uint8_t  entry = pos % NAME_PAGE_SIZE;
+    size_t   slot;
+
+    bool hit = lruLookup(index->tags, CONFIG_CPS_CACHE_NAME_PAGES, page, &slot);
+    namePage_t *names = &index->pages[slot];
+
+    // Load the whole page, stopping at the end of the table. Pages past the
+    // end of the table are cached as empty ones.
+    if(hit == false)
+    {
+        int count = index->readNames(names, page * NAME_PAGE_SIZE);
+        names->count = (count > 0) ? count : 0;
+    }
+
+    if((entry >= names->count) || (len == 0))
+        return -1;
+
+    // Names are not guaranteed to be null-terminated inside the codeplug
+    const char *name = names->names[entry];
+    size_t      size = strnlen(name, CPS_STR_SIZE);
+    if(size >= len)
+        size = len - 1;
+
+    memcpy(buf, name, size);
+    buf[size] = '\0';
+
+    return 0;
+}
+
+
+
+void cpsCache_invalidate()
+{
+    memset(channelTags, 0x00, sizeof(channelTags));
+    memset(contactTags, 0x00, sizeof(contactTags));
+    memset(bankTags,    0x00, sizeof(bankTags));
+
+    memset(channelNames.tags, 0x00, sizeof(channelNames.tags));
+    memset(contactNames.tags, 0x00, sizeof(contactNames.tags));
+    memset(bankNames.tags,    0x00, sizeof(bankNames.tags));
+
+    cpsIndex_invalidate();
+}
+
+int cpsCache_readChannel(channel_t *channel, uint16_t pos)
+{
+    size_t slot;
+    if(lruLookup(channelTags, CONFIG_CPS_CACHE_SIZE, pos, &slot) == false)
+    {
+        if(cps_readChannel(&channels[slot], pos) < 0)
+        {
+            channelTags[slot].used = 0;
+            return -1;
+        }
+    }
+
+    *channel = channels[slot];
+    return 0;
+}
+
+int cpsCache_readContact(contact_t *contact, uint16_t pos)
+{
+    size_t slot;
+    if(lruLookup(contactTags, CONFIG_CPS_CACHE_SIZE, pos, &slot) == false)
+    {
+        if(cps_readContact(&contacts[slot], pos) < 0)
+        {
+            contactTags[slot].used = 0;
+            return -1;
+        }
+    }
+
+    *contact = contacts[slot];
+    return 0;
+}
+
+int cpsCache_readBankHeader(bankHdr_t *b_header, uint16_t pos)
+{
+    size_t slot;
+    if(lruLookup(bankTags, CONFIG_CPS_CACHE_SIZE, pos, &slot) == false)
+    {
+        if(cps_readBankHeader(&banks[slot], pos) < 0)
+        {
+            bankTags[slot].used = 0;
+            return -1;
+        }
+    }
+
+    *b_header = banks[slot];
+    return 0;
+}
+
+int cpsCache_getChannelName(char *buf, size_t len, uint16_t pos)
+{
+    return getName(&channelNames, buf, len, pos);
+}
+
+int cpsCache_getContactName(char *buf, size_t len, uint16_t pos)
+{
+    return getName(&contactNames, buf, len, pos);
+}
+
+int cpsCache_getBankName(char *buf, size_t len, uint16_t pos)
+{
+    return getName(&bankNames, buf, len, pos);
+}
@@ -0,0 +1,528 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+#include <interfaces/cps_io.h>
+#include <cps_index.h>
+#include <hwconfig.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <rtx.h>
+
+/**
+ * Maximum number of entries indexed for each table, can be raised by targets
+ * with enough RAM. Each entry takes ten bytes and contacts are indexed twice.
+ */
+#ifndef CONFIG_CPS_INDEX_SIZE
+#define CONFIG_CPS_INDEX_SIZE 1024
+#endif
+
+#define NAME_KEY_LEN  8
+#define INDEX_INITIAL 64
+
+_Static_assert((CONFIG_CPS_INDEX_SIZE > 0) && (CONFIG_CPS_INDEX_SIZE <= UINT16_MAX),
+               "Codeplug index size out of range");
+
+/**
+ * Entry of a sorted index: the sorting key and the codeplug position.
+ */
+typedef struct
+{
+    uint64_t key;       // First characters of the name or address
+    uint16_t pos;       // Codeplug position
+}
+__attribute__((packed)) entry_t;
+
+/**
+ * Sorted index of a codeplug table.
+ */
+typedef struct
+{
+    entry_t  *entries;      // Indexed entries, sorted
+    uint16_t  count;        // Number of indexed entries
+    uint16_t  size;         // Number of allocated entries
+    bool      complete;     // All the table entries are indexed
+}
+index_t;
+
+/**
+ * Function reading a codeplug entry and returning its name and its address
+ * key, as required by the index being built.
+ */
+typedef int (*readEntry_t)(uint16_t pos, char *name, uint64_t *addr);
+
+static index_t contactNames;
+static index_t channelNames;
+static index_t contactAddrs;
+static bool    valid = false;
+
+// Cache of the last address lookup
+static uint64_t lastAddr     = 0;
+static int      lastAddrPos  = -1;
+static bool     lastAddrOk   = false;
+
+// Sorting context
+static readEntry_t sortRead;
+static bool        sortByName;
+
+
+static inline uint8_t fold(const char c)
+{
+    return toupper((unsigned char) c);
+}
+
+/**
+ * @internal
+ * Case-insensitive comparison of at most len characters of two names, which
+ * are not necessarily null-terminated.
+ */
+static int compareNames(const char *a, const char *b, size_t len)
+{
+    for(size_t i = 0; i < len; i++)
+    {
+        uint8_t ca = fold(a[i]);
+        uint8_t cb = fold(b[i]);
+
+        if(ca != cb)
+            return (ca < cb) ? -1 : 1;
+
+        if(ca == '\0')
+            break;
+    }
+
+    return 0;
+}
+
+/**
+ * @internal
+ * Compute the sorting key of a name: its first characters, case folded and
+ * packed so that the numeric order of the keys follows the alphabetical one.
+ */
+static uint64_t nameKey(const char *name)
+{
+    uint64_t key = 0;
+    bool     end = false;
+
+    for(size_t i = 0; i < NAME_KEY_LEN; i++)
+    {
+        if((end == false) && (name[i] == '\0'))
+            end = true;
+
+        key = (key << 8) | (end ? 0 : fold(name[i]));
+    }
+
+    return key;
+}
+
+static uint64_t addressKey(const uint8_t mode, const uint64_t address)
+{
+    return ((uint64_t) mode << 48) | (address & 0xFFFFFFFFFFFFULL);
+}
+
+static uint64_t contactAddress(const contact_t *contact)
+{
+    uint64_t address = 0;
+
+    switch(contact->mode)
+    {
+        case OPMODE_DMR:
+            address = contact->info.dmr.id;
+            break;
+
+        case OPMODE_M17:
+            for(size_t i = 0; i < 6; i++)
+                address = (address << 8) | contact->info.m17.address[i];
+            break;
+
+        default:
+            break;
+    }
+
+    return addressKey(contact->mode, address);
+}
+
+static int readContact(uint16_t pos, char *name, uint64_t *addr)
+{
+    contact_t contact;
+    if(cps_readContact(&contact, pos) < 0)
+        return -1;
+
+    if(name != NULL)
+        memcpy(name, contact.name, CPS_STR_SIZE);
+
+    if(addr != NULL)
+        *addr = contactAddress(&contact);
+
+    return 0;
+}
+
+static int readChannel(uint16_t pos, char *name, uint64_t *addr)
+{
+    (void) addr;
+
+    channel_t channel;
+    if(cps_readChannel(&channel, pos) < 0)
+        return -1;
+
+    if(name != NULL)
+        memcpy(name, channel.name, CPS_STR_SIZE);
+
+    return 0;
+}
+
+static int sortCompare(const void *a, const void *b)
+{
+    const entry_t *entryA = (const entry_t *) a;
+    const entry_t *entryB = (const entry_t *) b;
+
+    if(entryA->key != entryB->key)
+        return (entryA->key < entryB->key) ? -1 : 1;
+
+    // Names with the same key have to be compared in full
+    if(sortByName)
+    {
+        char nameA[CPS_STR_SIZE];
+        char nameB[CPS_STR_SIZE];
+
+        if((sortRead(entryA->pos, nameA, NULL) == 0) &&
+           (sortRead(entryB->pos, nameB, NULL) == 0))
+        {
+            int ret = compareNames(nameA, nameB, CPS_STR_SIZE);
+            if(ret != 0)
+                return ret;
+        }
+    }
+
+    // Keep entries with the same name in codeplug order
+    return (entryA->pos < entryB->pos) ? -1 : 1;
+}
+
+/**
+ * @internal
+ * Append an entry to an index, growing it up to CONFIG_CPS_INDEX_SIZE entries.
+ *
+ * @param index: index to be extended.
+ * @param key: sorting key of the entry.
+ * @param pos: codeplug position of the entry.
+ * @return true on success, false if the index is full or memory runs out.
+ */
+static bool appendEntry(index_t *index, const uint64_t key, const uint16_t pos)
+{
+    if(index->count == index->size)
+    {
+        uint32_t size    = (index->size > 0) ? (index->size * 2) : INDEX_INITIAL;
+        entry_t *entries = NULL;
+
+        if(size > CONFIG_CPS_INDEX_SIZE)
+            size = CONFIG_CPS_INDEX_SIZE;
+
+        if(size > index->size)
+            entries = (entry_t *) realloc(index->entries,
+                                          size * sizeof(entry_t));
+
+        if(entries == NULL)
+        {
+            index->complete = false;
+            return false;
+        }
+
+        index->entries = entries;
+        index->size    = size;
+    }
+
+    index->entries[index->count].key = key;
+    index->entries[index->count].pos = pos;
+    index->count += 1;
+
+    return true;
+}
+
+/**
+ * @internal
+ * Build the sorted indices of a codeplug table, reading each entry once. The
+ * indices grow with the table up to CONFIG_CPS_INDEX_SIZE entries: beyond that
+ * or if memory runs out, only the first entries of the table are indexed.
+ *
+ * @param names: index by name to be built.
+ * @param addrs: index by address to be built, NULL if not needed.
+ * @param read: function reading the table entries.
+ */
+static void buildIndex(index_t *names, index_t *addrs, readEntry_t read)
+{
+    char     name[CPS_STR_SIZE];
+    uint64_t addr;
+    uint16_t pos = 0;
+
+    names->count    = 0;
+    names->complete = true;
+    if(addrs != NULL)
+    {
+        addrs->count    = 0;
+        addrs->complete = true;
+    }
+
+    while(read(pos, name, &addr) == 0)
+    {
+        bool ok = appendEntry(names, nameKey(name), pos);
+        if(addrs != NULL)
+            ok = appendEntry(addrs, addr, pos) && ok;
+
+        if(ok == false)
+            break;
+
+        pos += 1;
+    }
+
+    // Drop the entry appended to only one of the indices
+    if((addrs != NULL) && (addrs->count != names->count))
+    {
+        if(addrs->count > names->count)
+            addrs->count = names->count;
+        else
+            names->count = addrs->count;
+
+        names->complete = false;
+        addrs->complete = false;
+    }
+
+    sortRead   = read;
+    sortByName = true;
+    qsort(names->entries, names->count, sizeof(entry_t), sortCompare);
+
+    if(addrs != NULL)
+    {
+        sortByName = false;
+        qsort(addrs->entries, addrs->count, sizeof(entry_t), sortCompare);
+    }
+}
+
+static bool ensureValid()
+{
+    if(valid)
+        return true;
+
+    return (cpsIndex_build() == 0);
+}
+
+/**
+ * @internal
+ * Binary search of the first entry whose key, masked to the given number of
+ * characters, is greater or equal (or strictly greater) than the key of the
+ * prefix. Works on the index only, without accessing the codeplug.
+ */
+static uint16_t searchKey(const index_t *index, const uint64_t key,
+                          const uint64_t mask, bool upper)
+{
+    uint16_t lo = 0;
+    uint16_t hi = index->count;
+
+    while(lo < hi)
+    {
+        uint16_t mid   = lo + ((hi - lo) / 2);
+        uint64_t entry = index->entries[mid].key & mask;
+
+        if((entry < key) || (upper && (entry == key)))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/**
+ * @internal
+ * Binary search, within a range of the index, of the first entry whose name
+ * truncated to the prefix length is greater or equal (or strictly greater)
+ * than the prefix. Reads the names from the codeplug.
+ */
+static uint16_t searchName(const index_t *index, readEntry_t read,
+                           const char *prefix, size_t len, bool upper,
+                           uint16_t lo, uint16_t hi)
+{
+    while(lo < hi)
+    {
+        uint16_t mid = lo + ((hi - lo) / 2);
+        char     name[CPS_STR_SIZE];
+
+        if(read(index->entries[mid].pos, name, NULL) < 0)
+            return lo;
+
+        int cmp = compareNames(name, prefix, len);
+        if((cmp < 0) || (upper && (cmp == 0)))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+static int search(const index_t *index, readEntry_t read, const char *prefix,
+                  cpsMatch_t *match)
+{
+    if(ensureValid() == false)
+        return -1;
+
+    size_t len = strnlen(prefix, CPS_STR_SIZE);
+    if(len == 0)
+    {
+        match->first = 0;
+        match->count = index->count;
+        return 0;
+    }
+
+    // Narrow down the range using the keys, which hold the first characters
+    size_t   keyLen = (len < NAME_KEY_LEN) ? len : NAME_KEY_LEN;
+    uint64_t mask   = ~0ULL << (8 * (NAME_KEY_LEN - keyLen));
+    uint64_t key    = nameKey(prefix) & mask;
+
+    uint16_t first = searchKey(index, key, mask, false);
+    uint16_t last  = searchKey(index, key, mask, true);
+
+    // Longer prefixes are compared in full only within the narrowed range
+    if(len > NAME_KEY_LEN)
+    {
+        uint16_t end = last;
+        first = searchName(index, read, prefix, len, false, first, end);
+        last  = searchName(index, read, prefix, len, true,  first, end);
+    }
+
+    match->first = first;
+    match->count = last - first;
+
+    return 0;
+}
+
+static int findAddress(const uint64_t key)
+{
+    if(ensureValid() == false)
+        return -1;
+
+    // The same address is looked up repeatedly while receiving a call
+    if(lastAddrOk && (lastAddr == key))
+        return lastAddrPos;
+
+    int      result = -1;
+    uint16_t pos    = searchKey(&contactAddrs, key, ~0ULL, false);
+    if((pos < contactAddrs.count) && (contactAddrs.entries[pos].key == key))
+    {
+        result = contactAddrs.entries[pos].pos;
+    }
+    else if(contactAddrs.complete == false)
+    {
+        // Contacts left out of the index are searched linearly, only once
+        // per address thanks to the lookup cache
+        uint64_t addr;
+        for(uint16_t i = contactAddrs.count; readContact(i, NULL, &addr) == 0; i++)
+        {
+            if(addr == key)
+            {
+                result = i;
+                break;
+            }
+        }
+    }
+
+    lastAddr    = key;
+    lastAddrPos = result;
+    lastAddrOk  = true;
+
+    return result;
+}
+
+
+
+int cpsIndex_build()
+{
+    buildIndex(&contactNames, &contactAddrs, readContact);
+    buildIndex(&channelNames, NULL,          readChannel);
+
+    lastAddrOk = false;
+    valid      = true;
+
+    return 0;
+}
+
+void cpsIndex_invalidate()
+{
+    valid      = false;
+    lastAddrOk = false;
+}
+
+int cpsIndex_searchContacts(const char *prefix, cpsMatch_t *match)
+{
+    return search(&contactNames, readContact, prefix, match);
+}
+
+int cpsIndex_searchChannels(const char *prefix, cpsMatch_t *match)
+{
+    return search(&channelNames, readChannel, prefix, match);
+}
+
+int cpsIndex_getContact(uint16_t rank)
+{
+    if((ensureValid() == false) || (rank >= contactNames.count))
+        return -1;
+
+    return contactNames.entries[rank].pos;
+}
+
+int cpsIndex_getChannel(uint16_t rank)
+{
+    if((ensureValid() == false) || (rank >= channelNames.count))
+        return -1;
+
+    return channelNames.entries[rank].pos;
+}
+
+int cpsIndex_findDmrContact(uint32_t id)
+{
+    return findAddress(addressKey(OPMODE_DMR, id));
+}
+
+int cpsIndex_findM17Contact(const char *callsign)
+{
+    // Base-40 encoding of the callsign, as in M17::encode_callsign()
+    size_t   len     = strnlen(callsign, 10);
+    uint64_t address = 0;
+
+    if(len > 9)
+        return -1;
+
+    for(size_t i = len; i > 0; i--)
+    {
+        char c = callsign[i - 1];
+
+        address *= 40;
+        if((c >= 'A') && (c <= 'Z'))
+            address += (c - 'A') + 1;
+        else if((c >= '0') && (c <= '9'))
+            address += (c - '0') + 27;
+        else if(c == '-')
+            address += 37;
+        else if(c == '/')
+            address += 38;
+        else if(c == '.')
+            address += 39;
+    }
+
+    return findAddress(addressKey(OPMODE_M17, address));
+}
@@ -0,0 +1,123 @@
+/***************************************************************************
+ *   Copyright (C) 2022 - 2025 by Federico Amedeo Izzo IU2NUO,             *
+ *                                Niccolò Izzo IU2KIN                      *
+ *                                Frederik Saraci IU2NRO                   *
+ *                                Silvano Seva IU2KWO                      *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <crc.h>
+
+/*
+ * Table driven computation of MSB-first 16-bit CRCs, processing four bytes at a
+ * time ("slice-by-4"). The lookup tables are generated at compile time and
+ * placed in read-only memory.
+ *
+ * The hardware CRC units available on some of the supported MCUs are not used:
+ * the one of the STM32F4 family only computes the CRC-32, while the other ones
+ * would have to be shared among threads and reprogrammed at each call.
+ */
+
+template < uint16_t POLY >
+struct Crc16Table
+{
+    /*
+     * Element i of table k contains the CRC of byte i followed by k zero
+     * bytes.
+     */
+    uint16_t t[4][256];
+
+    constexpr Crc16Table() : t()
+    {
+        for(uint16_t i = 0; i < 256; i++)
+        {
+            uint16_t crc = i << 8;
+            for(uint8_t j = 0; j < 8; j++)
+                crc = (crc & 0x8000) ? ((crc << 1) ^ POLY) : (crc << 1);
+
+            t[0][i] = crc;
+        }
+
+        for(uint8_t k = 1; k < 4; k++)
+        {
+            for(uint16_t i = 0; i < 256; i++)
+            {
+                uint16_t prev = t[k - 1][i];
+                t[k][i] = (prev << 8) ^ t[0][prev >> 8];
+            }
+        }
+    }
+};
+
+static constexpr Crc16Table< 0x1021 > ccittTable;
+static constexpr Crc16Table< 0x5935 > m17Table;
+
+
+/**
+ * \internal Update a 16-bit CRC with a new block of data.
+ *
+ * @param table: lookup tables of the CRC polynomial.
+ * @param crc: current CRC value.
+ * @param data: input data.
+ * @param len: data length, in bytes.
+ * @return updated CRC.
+ */
+template < uint16_t POLY >
+static uint16_t crc16Update(const Crc16Table< POLY >& table, uint16_t crc,
+                            const void *data, size_t len)
+{
+    const uint8_t *buf = reinterpret_cast< const uint8_t * >(data);
+
+    while(len >= 4)
+    {
+        uint16_t x = crc ^ ((buf[0] << 8) | buf[1]);
+        crc = table.t[3][x >> 8]
+            ^ table.t[2][x & 0xFF]
+            ^ table.t[1][buf[2]]
+            ^ table.t[0][buf[3]];
+
+        buf += 4;
+        len -= 4;
+    }
+
+    while(len > 0)
+    {
+        crc = (crc << 8) ^ table.t[0][(crc >> 8) ^ *buf];
+        buf += 1;
+        len -= 1;
+    }
+
+    return crc;
+}
+
+uint16_t crc_ccitt(const void *data, const size_t len)
+{
+    return crc16Update(ccittTable, CRC_CCITT_INIT, data, len);
+}
+
+uint16_t crc_ccittUpdate(const uint16_t crc, const void *data, const size_t len)
+{
+    return crc16Update(ccittTable, crc, data, len);
+}
+
+uint16_t crc_m17(const void *data, const size_t len)
+{
+    return crc16Update(m17Table, CRC_M17_INIT, data, len);
+}
+
+uint16_t crc_m17Update(const uint16_t crc, const void *data, const size_t len)
+{
+    return crc16Update(m17Table, crc, data, len);
+}
@@ -67,6 +67,54 @@ void dsp_dcRemoval(filter_state_t *state, audio_sample_t *buffer, size_t length)
     }
 }
 
+void dsp_resetFilterStateQ15(filter_state_q15_t *state)
+{
+    state->u = 0;
+    state->y = 0;
+    state->initialised = false;
+}
+
+void dsp_dcRemovalQ15(filter_state_q15_t *state, audio_sample_t *buffer,
+                      size_t length)
+{
+    /*
+     * Same filter of dsp_dcRemoval(), with the output kept in Q15 to retain
+     * the fractional part across iterations. The recursion is rewritten as
+     * y(k) = u(k) - u(k-1) + y(k-1) - (1 - 0.999)*y(k-1)
+     * with the (1 - 0.999) coefficient represented in Q30 for accuracy.
+     */
+
+    if(length < 2) return;
+
+    static constexpr int64_t beta = 1073742;    // 0.001 in Q30
+    size_t pos = 0;
+
+    if(state->initialised == false)
+    {
+        state->u = buffer[0];
+        state->initialised = true;
+        pos = 1;
+    }
+
+    for(; pos < length; pos++)
+    {
+        int32_t u = buffer[pos];
+        int64_t y = state->y;
+
+        y += static_cast< int64_t >(u - state->u) * 32768;
+        y -= (state->y * beta + (1 << 29)) >> 30;
+
+        state->u = u;
+        state->y = y;
+
+        int64_t out = (y + (1 << 14)) >> 15;
+        if(out > INT16_MAX) out = INT16_MAX;
+        if(out < INT16_MIN) out = INT16_MIN;
+
+        buffer[pos] = static_cast< audio_sample_t >(out);
+    }
+}
+
 void dsp_invertPhase(audio_sample_t *buffer, uint16_t length)
 {
     for(uint16_t i = 0; i < length; i++)
@@ -99,6 +99,7 @@ static const GFXfont fonts[] = { TomThumb,            // 5pt
 
 #define PIXEL_T rgb565_t
 #define FB_SIZE (CONFIG_SCREEN_HEIGHT * CONFIG_SCREEN_WIDTH)
+#define BAND_SHIFT 0
 
 typedef struct
 {
@@ -128,6 +129,7 @@ static rgb565_t _true2highColor(color_t true_color)
 
 #define PIXEL_T uint8_t
 #define FB_SIZE (((CONFIG_SCREEN_HEIGHT * CONFIG_SCREEN_WIDTH) / 8 ) + 1)
+#define BAND_SHIFT 3
 
 typedef enum
 {
@@ -157,11 +159,89 @@ static PIXEL_T __attribute__((section(".bss.fb"))) framebuffer[FB_SIZE];
 #endif
 static char text[32];
 
+/*
+ * Dirty region tracking. The framebuffer is split in horizontal bands, one
+ * pixel row high on color displays and eight pixel rows high (one controller
+ * page) on B/W displays. Every framebuffer write widens the dirty band range,
+ * while a per-band hash of the content last sent to the display allows to
+ * skip the bands that have been redrawn with the same content, as it happens
+ * when the UI clears and repaints the whole screen at each update.
+ */
+#define BAND_HEIGHT (1 << BAND_SHIFT)
+#define NUM_BANDS   (CONFIG_SCREEN_HEIGHT >> BAND_SHIFT)
+#define BAND_SIZE   ((CONFIG_SCREEN_WIDTH * BAND_HEIGHT * sizeof(PIXEL_T)) >> BAND_SHIFT)
+
+static uint16_t dirtyStart;             // First dirty band
+static uint16_t dirtyEnd;               // One past the last dirty band
+static bool     fullFlush;              // Display content is unknown
+static uint32_t bandHash[NUM_BANDS];    // Hash of the bands on the display
+
+static inline void markDirty(const uint16_t startRow, const uint16_t endRow)
+{
+    uint16_t start = startRow >> BAND_SHIFT;
+    uint16_t end   = (endRow + BAND_HEIGHT - 1) >> BAND_SHIFT;
+
+    if(end > NUM_BANDS)
+        end = NUM_BANDS;
+
+    if(start >= end)
+        return;
+
+    if(dirtyStart >= dirtyEnd)
+    {
+        dirtyStart = start;
+        dirtyEnd   = end;
+        return;
+    }
+
+    if(start < dirtyStart) dirtyStart = start;
+    if(end > dirtyEnd)     dirtyEnd   = end;
+}
+
+static uint32_t hashBand(const uint16_t band)
+{
+    // 32 bit FNV-1a
+    const uint8_t *ptr  = ((const uint8_t *) framebuffer) + (band * BAND_SIZE);
+    uint32_t       hash = 2166136261u;
+
+    for(size_t i = 0; i < BAND_SIZE; i++)
+    {
+        hash ^= ptr[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static void flushBands(const uint16_t start, const uint16_t end)
+{
+    #ifdef CONFIG_SCREEN_ROW_PAGES
+    display_renderRows(start, end, framebuffer);
+    #else
+    display_renderRows(start << BAND_SHIFT, end << BAND_SHIFT, framebuffer);
+    #endif
+}
+
+static void clearDirty()
+{
+    for(uint16_t band = dirtyStart; band < dirtyEnd; band++)
+        bandHash[band] = hashBand(band);
+
+    dirtyStart = 0;
+    dirtyEnd   = 0;
+    fullFlush  = false;
+}
+
 
 void gfx_init()
 {
     display_init();
 
+    // Display content is unknown until the first flush
+    dirtyStart = 0;
+    dirtyEnd   = NUM_BANDS;
+    fullFlush  = true;
+
     // Clear text buffer
     memset(text, 0x00, 32);
 }
@@ -178,24 +258,68 @@ void gfx_renderRows(uint8_t startRow, uint8_t endRow)
 
 void gfx_render()
 {
+    // Hash the bands before flushing, some display drivers modify the
+    // framebuffer content while sending it
+    clearDirty();
     display_render(framebuffer);
 }
 
+void gfx_renderDirty()
+{
+    if(fullFlush)
+    {
+        gfx_render();
+        return;
+    }
+
+    // Flush the runs of consecutive bands whose content actually changed
+    uint16_t runStart = dirtyEnd;
+    for(uint16_t band = dirtyStart; band < dirtyEnd; band++)
+    {
+        uint32_t hash = hashBand(band);
+        if(hash != bandHash[band])
+        {
+            bandHash[band] = hash;
+            if(runStart == dirtyEnd)
+                runStart = band;
+
+            continue;
+        }
+
+        if(runStart != dirtyEnd)
+        {
+            flushBands(runStart, band);
+            runStart = dirtyEnd;
+        }
+    }
+
+    if(runStart != dirtyEnd)
+        flushBands(runStart, dirtyEnd);
+
+    dirtyStart = 0;
+    dirtyEnd   = 0;
+}
+
 void gfx_clearRows(uint8_t startRow, uint8_t endRow)
 {
-    if(endRow < startRow)
+    if(endRow > CONFIG_SCREEN_HEIGHT)
+        endRow = CONFIG_SCREEN_HEIGHT;
+
+    if(endRow <= startRow)
         return;
 
-    uint16_t start = startRow * CONFIG_SCREEN_WIDTH * sizeof(PIXEL_T);
-    uint16_t height = endRow - startRow * CONFIG_SCREEN_WIDTH * sizeof(PIXEL_T);
+    size_t start = ((size_t) startRow * BAND_SIZE) >> BAND_SHIFT;
+    size_t size  = ((size_t) (endRow - startRow) * BAND_SIZE) >> BAND_SHIFT;
     // Set the specified rows to 0x00 = make the screen black
-    memset(framebuffer + start, 0x00, height);
+    memset(((uint8_t *) framebuffer) + start, 0x00, size);
+    markDirty(startRow, endRow);
 }
 
 void gfx_clearScreen()
 {
     // Set the whole framebuffer to 0x00 = make the screen black
     memset(framebuffer, 0x00, FB_SIZE * sizeof(PIXEL_T));
+    markDirty(0, CONFIG_SCREEN_HEIGHT);
 }
 
 void gfx_fillScreen(color_t color)
@@ -216,6 +340,8 @@ inline void gfx_setPixel(point_t pos, color_t color)
         pos.x < 0 || pos.y < 0)
         return; // off the screen
 
+    markDirty(pos.y, pos.y + 1);
+
 #ifdef CONFIG_PIX_FMT_RGB565
     // Blend old pixel value and new one
     if (color.alpha < 255)
@@ -442,6 +568,226 @@ static inline uint16_t get_reset_x(textAlign_t alignment, uint16_t line_size,
     return 0;
 }
 
+/*
+ * Glyph rasterization.
+ *
+ * Glyph bitmaps are decoded into horizontal spans of set pixels, which are
+ * then filled directly into the framebuffer in its native pixel format. The
+ * spans of the most recently used glyphs are kept in a small direct mapped
+ * cache, so that the bitmap of frequently printed characters is not decoded
+ * again at each redraw. The cache content does not depend on the text color.
+ *
+ * As with gfx_setPixel(), pixels on the first row and first column of the
+ * screen are never written by text rendering.
+ */
+
+#ifndef CONFIG_GFX_GLYPH_CACHE_SIZE
+#define CONFIG_GFX_GLYPH_CACHE_SIZE 16
+#endif
+
+#define GLYPH_MAX_SPANS 40
+
+typedef struct
+{
+    uint8_t row;        // Row inside the glyph
+    uint8_t col;        // Column of the first pixel inside the glyph
+    uint8_t len;        // Number of pixels
+}
+span_t;
+
+typedef struct
+{
+    const uint8_t  *bitmap;     // Font bitmap
+    const GFXglyph *glyph;      // Glyph being decoded
+    uint8_t         row;        // Current decoding row
+    uint8_t         col;        // Current decoding column
+}
+spanDecoder_t;
+
+#if CONFIG_GFX_GLYPH_CACHE_SIZE > 0
+typedef struct
+{
+    const GFXglyph *glyph;                      // Cached glyph, NULL if empty
+    uint8_t         numSpans;                   // Number of spans
+    span_t          spans[GLYPH_MAX_SPANS];     // Glyph spans
+}
+glyphCacheEntry_t;
+
+static glyphCacheEntry_t glyphCache[CONFIG_GFX_GLYPH_CACHE_SIZE];
+#endif
+
+/**
+ * Decode the next spans of a glyph bitmap.
+ *
+ * @param dec: decoder state.
+ * @param spans: output span buffer.
+ * @param maxSpans: size of the span buffer.
+ * @return number of decoded spans, zero when the whole glyph has been decoded.
+ */
+static uint8_t decodeSpans(spanDecoder_t *dec, span_t *spans, const uint8_t maxSpans)
+{
+    const GFXglyph *glyph = dec->glyph;
+    const uint8_t  *bits  = dec->bitmap + glyph->bitmapOffset;
+    uint8_t         num   = 0;
+
+    while((dec->row < glyph->height) && (num < maxSpans))
+    {
+        uint16_t base = dec->row * glyph->width;
+        uint8_t  col  = dec->col;
+
+        while(col < glyph->width)
+        {
+            uint16_t idx = base + col;
+            if((bits[idx >> 3] & (0x80 >> (idx & 7))) == 0)
+            {
+                col++;
+                continue;
+            }
+
+            uint8_t start = col;
+            do
+            {
+                col++;
+                idx++;
+            }
+            while((col < glyph->width) && (bits[idx >> 3] & (0x80 >> (idx & 7))));
+
+            spans[num].row = dec->row;
+            spans[num].col = start;
+            spans[num].len = col - start;
+            num++;
+
+            if(num == maxSpans)
+                break;
+        }
+
+        if(col < glyph->width)
+        {
+            dec->col = col;
+        }
+        else
+        {
+            dec->col = 0;
+            dec->row++;
+        }
+    }
+
+    return num;
+}
+
+/**
+ * Fill a set of glyph spans into the framebuffer.
+ *
+ * @param x0: x coordinate of the glyph top left corner.
+ * @param y0: y coordinate of the glyph top left corner.
+ * @param spans: spans to be filled.
+ * @param num: number of spans.
+ * @param clip: clip spans against the screen boundaries.
+ * @param color: fill color.
+ * @param pixel: fill color, in framebuffer pixel format.
+ */
+static void fillSpans(const int16_t x0, const int16_t y0, const span_t *spans,
+                      const uint8_t num, const bool clip, const color_t color,
+                      const PIXEL_T pixel)
+{
+    for(uint8_t i = 0; i < num; i++)
+    {
+        int16_t x   = x0 + spans[i].col;
+        int16_t y   = y0 + spans[i].row;
+        int16_t end = x + spans[i].len;
+
+        if(clip)
+        {
+            if((y < 1) || (y >= CONFIG_SCREEN_HEIGHT)) continue;
+            if(x < 1) x = 1;
+            if(end > CONFIG_SCREEN_WIDTH) end = CONFIG_SCREEN_WIDTH;
+        }
+
+        #ifdef CONFIG_PIX_FMT_RGB565
+        if(color.alpha < 255)
+        {
+            // Blending needs the old pixel value, go through gfx_setPixel()
+            for(point_t pos = {x, y}; pos.x < end; pos.x++)
+                gfx_setPixel(pos, color);
+
+            continue;
+        }
+
+        PIXEL_T *ptr = &framebuffer[x + y*CONFIG_SCREEN_WIDTH];
+        for(; x < end; x++)
+            *ptr++ = pixel;
+        #elif defined CONFIG_PIX_FMT_BW
+        (void) color;
+        for(uint16_t idx = x + y*CONFIG_SCREEN_WIDTH; x < end; x++, idx++)
+        {
+            framebuffer[idx / 8] &= ~(1 << (idx % 8));
+            framebuffer[idx / 8] |= (pixel << (idx % 8));
+        }
+        #endif
+    }
+}
+
+/**
+ * Draw a glyph into the framebuffer.
+ *
+ * @param f: font the glyph belongs to.
+ * @param glyph: glyph to be drawn.
+ * @param x0: x coordinate of the glyph top left corner.
+ * @param y0: y coordinate of the glyph top left corner.
+ * @param color: glyph color.
+ * @param pixel: glyph color, in framebuffer pixel format.
+ */
+static void drawGlyph(const GFXfont *f, const GFXglyph *glyph, const int16_t x0,
+                      const int16_t y0, const color_t color, const PIXEL_T pixel)
+{
+    int16_t x1 = x0 + glyph->width;
+    int16_t y1 = y0 + glyph->height;
+
+    if((glyph->width == 0) || (glyph->height == 0))
+        return;
+
+    // Entirely off the screen
+    if((x1 <= 1) || (y1 <= 1) || (x0 >= CONFIG_SCREEN_WIDTH) ||
+       (y0 >= CONFIG_SCREEN_HEIGHT))
+        return;
+
+    bool clip = (x0 < 1) || (y0 < 1) || (x1 > CONFIG_SCREEN_WIDTH) ||
+                (y1 > CONFIG_SCREEN_HEIGHT);
+
+    markDirty((y0 < 0) ? 0 : y0, y1);
+
+    #if CONFIG_GFX_GLYPH_CACHE_SIZE > 0
+    uintptr_t          slot  = ((uintptr_t) glyph) / sizeof(GFXglyph);
+    glyphCacheEntry_t *entry = &glyphCache[slot % CONFIG_GFX_GLYPH_CACHE_SIZE];
+
+    if(entry->glyph == glyph)
+    {
+        fillSpans(x0, y0, entry->spans, entry->numSpans, clip, color, pixel);
+        return;
+    }
+    #endif
+
+    spanDecoder_t dec = {f->bitmap, glyph, 0, 0};
+    span_t        spans[GLYPH_MAX_SPANS];
+    uint8_t       num = decodeSpans(&dec, spans, GLYPH_MAX_SPANS);
+
+    #if CONFIG_GFX_GLYPH_CACHE_SIZE > 0
+    // Cache only glyphs entirely fitting in a cache entry
+    if(dec.row >= glyph->height)
+    {
+        entry->glyph    = glyph;
+        entry->numSpans = num;
+        memcpy(entry->spans, spans, num * sizeof(span_t));
+    }
+    #endif
+
+    while(num > 0)
+    {
+        fillSpans(x0, y0, spans, num, clip, color, pixel);
+        num = decodeSpans(&dec, spans, GLYPH_MAX_SPANS);
+    }
+}
+
 uint8_t gfx_getFontHeight(fontSize_t size)
 {
     GFXfont f = fonts[size];
@@ -464,19 +810,21 @@ point_t gfx_printBuffer(point_t start, fontSize_t size, textAlign_t alignment,
     uint16_t saved_start_y = start.y;
     uint16_t line_h = 0;
 
+    // Convert the text color to the framebuffer format only once
+    #ifdef CONFIG_PIX_FMT_RGB565
+    PIXEL_T pixel = _true2highColor(color);
+    #elif defined CONFIG_PIX_FMT_BW
+    PIXEL_T pixel = _color2bw(color);
+    // Ignore more than half transparent pixels
+    bool visible = (color.alpha >= 128);
+    #endif
+
     /* For each char in the string */
     for(unsigned i = 0; i < len; i++)
     {
         char c = buf[i];
-        GFXglyph glyph = f.glyph[c - f.first];
-        uint8_t *bitmap = f.bitmap;
-
-        uint16_t bo = glyph.bitmapOffset;
-        uint8_t w = glyph.width, h = glyph.height;
-        int8_t xo = glyph.xOffset,
-               yo = glyph.yOffset;
-        uint8_t xx, yy, bits = 0, bit = 0;
-        line_h = h;
+        const GFXglyph *glyph = &f.glyph[c - f.first];
+        line_h = glyph->height;
 
         // Handle newline and carriage return
         if (c == '\n')
@@ -500,7 +848,7 @@ point_t gfx_printBuffer(point_t start, fontSize_t size, textAlign_t alignment,
         }
 
         // Handle wrap around
-        if (start.x + glyph.xAdvance > CONFIG_SCREEN_WIDTH)
+        if (start.x + glyph->xAdvance > CONFIG_SCREEN_WIDTH)
         {
             // Compute size of the first row in pixels
             line_size = get_line_size(f, buf, len);
@@ -508,36 +856,13 @@ point_t gfx_printBuffer(point_t start, fontSize_t size, textAlign_t alignment,
             start.y += f.yAdvance;
         }
 
-        // Draw bitmap
-        for (yy = 0; yy < h; yy++)
-        {
-            for (xx = 0; xx < w; xx++)
-            {
-                if (!(bit++ & 7))
-                {
-                    bits = bitmap[bo++];
-                }
-
-                if (bits & 0x80)
-                {
-                    if (start.y + yo + yy < CONFIG_SCREEN_HEIGHT &&
-                        start.x + xo + xx < CONFIG_SCREEN_WIDTH &&
-                        start.y + yo + yy > 0 &&
-                        start.x + xo + xx > 0)
-                    {
-                        point_t pos;
-                        pos.x = start.x + xo + xx;
-                        pos.y = start.y + yo + yy;
-                        gfx_setPixel(pos, color);
-
-                    }
-                }
-
-                bits <<= 1;
-            }
-        }
+        #ifdef CONFIG_PIX_FMT_BW
+        if(visible)
+        #endif
+        drawGlyph(&f, glyph, start.x + glyph->xOffset,
+                  start.y + glyph->yOffset, color, pixel);
 
-        start.x += glyph.xAdvance;
+        start.x += glyph->xAdvance;
     }
     // Calculate text size
     point_t text_size = {0, 0};
@@ -0,0 +1,251 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <m17_packet.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <stdio.h>
+
+#ifndef CONFIG_M17_PACKET_RX_SLOTS
+#define CONFIG_M17_PACKET_RX_SLOTS 2
+#endif
+
+#define PACKET_TYPE_APRS 0x02
+#define PACKET_TYPE_SMS  0x05
+
+enum slotState
+{
+    SLOT_FREE  = 0,     // Slot available
+    SLOT_WRITE = 1,     // Slot being filled by its producer
+    SLOT_READY = 2,     // Slot ready for its consumer
+    SLOT_BUSY  = 3      // Slot being used by its consumer
+};
+
+typedef struct
+{
+    m17packet_t packet;
+    atomic_uint state;
+    uint32_t    seqNum;
+}
+slot_t;
+
+static slot_t   txSlot;
+static slot_t   rxSlots[CONFIG_M17_PACKET_RX_SLOTS];
+static uint32_t rxSeqNum;
+
+
+static inline bool changeState(slot_t *slot, unsigned int from, unsigned int to)
+{
+    return atomic_compare_exchange_strong(&slot->state, &from, to);
+}
+
+static slot_t *findSlot(const m17packet_t *packet)
+{
+    if(packet == &txSlot.packet)
+        return &txSlot;
+
+    for(size_t i = 0; i < CONFIG_M17_PACKET_RX_SLOTS; i++)
+    {
+        if(packet == &rxSlots[i].packet)
+            return &rxSlots[i];
+    }
+
+    return NULL;
+}
+
+/**
+ * \internal Format a coordinate in the APRS degrees and decimal minutes format.
+ *
+ * @param buf: destination buffer.
+ * @param len: size of the destination buffer.
+ * @param value: coordinate, in millionths of degree.
+ * @param degDigits: number of digits of the degrees field.
+ * @param pos: hemisphere letter for positive coordinates.
+ * @param neg: hemisphere letter for negative coordinates.
+ * @return number of characters written.
+ */
+static int aprsCoordinate(char *buf, size_t len, const int32_t value,
+                          const int degDigits, const char pos, const char neg)
+{
+    uint32_t absValue = (value < 0) ? -((uint32_t) value) : (uint32_t) value;
+    uint32_t degrees  = absValue / 1000000;
+    uint32_t minutes  = ((absValue % 1000000) * 6) / 1000;    // 1/100 minutes
+
+    return snprintf(buf, len, "%0*u%02u.%02u%c", degDigits,
+                    (unsigned int) degrees, (unsigned int) (minutes / 100),
+                    (unsigned int) (minutes % 100), (value < 0) ? neg : pos);
+}
+
+
+m17packet_t *m17Packet_allocTx()
+{
+    if(changeState(&txSlot, SLOT_FREE, SLOT_WRITE) == false)
+        return NULL;
+
+    txSlot.packet.size   = 0;
+    txSlot.packet.src[0] = '\0';
+    txSlot.packet.dst[0] = '\0';
+
+    return &txSlot.packet;
+}
+
+bool m17Packet_send(m17packet_t *packet)
+{
+    if(packet != &txSlot.packet)
+        return false;
+
+    if((packet->size == 0) || (packet->size > M17PKT_MAX_SIZE))
+    {
+        atomic_store(&txSlot.state, SLOT_FREE);
+        return false;
+    }
+
+    return changeState(&txSlot, SLOT_WRITE, SLOT_READY);
+}
+
+bool m17Packet_sendSms(const char *dst, const char *text)
+{
+    m17packet_t *packet = m17Packet_allocTx();
+    if(packet == NULL)
+        return false;
+
+    // Protocol type, text and its terminator
+    size_t len = strlen(text);
+    if(len > (M17PKT_MAX_SIZE - 2))
+        len = M17PKT_MAX_SIZE - 2;
+
+    packet->data[0] = PACKET_TYPE_SMS;
+    memcpy(&packet->data[1], text, len);
+    packet->data[len + 1] = '\0';
+    packet->size = len + 2;
+
+    strncpy(packet->dst, dst, sizeof(packet->dst) - 1);
+    packet->dst[sizeof(packet->dst) - 1] = '\0';
+
+    return m17Packet_send(packet);
+}
+
+bool m17Packet_sendPosition(const char *dst, const gps_t *gps)
+{
+    if(gps->fix_quality == 0)
+        return false;
+
+    m17packet_t *packet = m17Packet_allocTx();
+    if(packet == NULL)
+        return false;
+
+    /*
+     * APRS position report without timestamp, using the "human" symbol and
+     * the course/speed and altitude extensions:
+     * !DDMM.mmN/DDDMM.mmE[CCC/SSS/A=AAAAAA
+     */
+    char  *text = (char *) &packet->data[1];
+    size_t size = M17PKT_MAX_SIZE - 1;
+    int    len  = 0;
+
+    int32_t course = gps->tmg_true % 360;
+    if(course <= 0)
+        course += 360;
+
+    uint32_t speed = (gps->speed * 1000) / 1852;    // km/h to knots
+    if(speed > 999)
+        speed = 999;
+
+    int32_t altitude = (gps->altitude * 3281) / 1000;   // m to feet
+
+    len += snprintf(text + len, size - len, "!");
+    len += aprsCoordinate(text + len, size - len, gps->latitude, 2, 'N', 'S');
+    len += snprintf(text + len, size - len, "/");
+    len += aprsCoordinate(text + len, size - len, gps->longitude, 3, 'E', 'W');
+    len += snprintf(text + len, size - len, "[%03d/%03u/A=%06d",
+                    (int) course, (unsigned int) speed, (int) altitude);
+
+    packet->data[0] = PACKET_TYPE_APRS;
+    packet->size    = len + 1;
+
+    strncpy(packet->dst, dst, sizeof(packet->dst) - 1);
+    packet->dst[sizeof(packet->dst) - 1] = '\0';
+
+    return m17Packet_send(packet);
+}
+
+const m17packet_t *m17Packet_receive()
+{
+    slot_t *oldest = NULL;
+
+    for(size_t i = 0; i < CONFIG_M17_PACKET_RX_SLOTS; i++)
+    {
+        slot_t *slot = &rxSlots[i];
+        if(atomic_load(&slot->state) != SLOT_READY)
+            continue;
+
+        if((oldest == NULL) || ((int32_t)(slot->seqNum - oldest->seqNum) < 0))
+            oldest = slot;
+    }
+
+    if((oldest == NULL) || (changeState(oldest, SLOT_READY, SLOT_BUSY) == false))
+        return NULL;
+
+    return &oldest->packet;
+}
+
+void m17Packet_release(const m17packet_t *packet)
+{
+    slot_t *slot = findSlot(packet);
+    if(slot != NULL)
+        atomic_store(&slot->state, SLOT_FREE);
+}
+
+bool m17Packet_txPending()
+{
+    return atomic_load(&txSlot.state) == SLOT_READY;
+}
+
+m17packet_t *m17Packet_getTx()
+{
+    if(changeState(&txSlot, SLOT_READY, SLOT_BUSY) == false)
+        return NULL;
+
+    return &txSlot.packet;
+}
+
+m17packet_t *m17Packet_allocRx()
+{
+    for(size_t i = 0; i < CONFIG_M17_PACKET_RX_SLOTS; i++)
+    {
+        if(changeState(&rxSlots[i], SLOT_FREE, SLOT_WRITE))
+        {
+            rxSlots[i].packet.size = 0;
+            return &rxSlots[i].packet;
+        }
+    }
+
+    return NULL;
+}
+
+void m17Packet_publishRx(m17packet_t *packet)
+{
+    slot_t *slot = findSlot(packet);
+    if(slot == NULL)
+        return;
+
+    slot->seqNum = rxSeqNum++;
+    atomic_store(&slot->state, SLOT_READY);
+}
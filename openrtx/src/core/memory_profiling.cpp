@@ -58,10 +58,471 @@ unsigned int getCurrentFreeHeap()
     return miosix::MemoryProfiling::getCurrentFreeHeap();
 }
 
+#elif defined(PLATFORM_LINUX)
+
+#include <sys/mman.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <atomic>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+/*
+ * On linux the stacks of the profiled threads are allocated and painted when
+ * the threads are created, while heap usage is tracked by replacing the glibc
+ * allocation functions. Stack usage is then measured on the host machine and
+ * is thus larger than on the target devices, due to the wider registers and to
+ * the host C library, making it an upper bound of the real one.
+ */
+
+#ifndef CONFIG_MEMPROF_MAX_THREADS
+#define CONFIG_MEMPROF_MAX_THREADS 16
+#endif
+
+#ifndef CONFIG_MEMPROF_STACK_SIZE
+#define CONFIG_MEMPROF_STACK_SIZE 262144
+#endif
+
+#ifndef CONFIG_MEMPROF_HEAP_SIZE
+#define CONFIG_MEMPROF_HEAP_SIZE 16777216
+#endif
+
+#ifndef MAP_STACK
+#define MAP_STACK 0
+#endif
+
+// AddressSanitizer provides its own allocator, heap hooks cannot be used
+#if defined(__SANITIZE_ADDRESS__)
+#define ASAN_ENABLED
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define ASAN_ENABLED
+#endif
+#endif
+
+#define STACK_PAINT 0xA5
+
+/*
+ * Each profiled thread owns two stacks, used alternately: a detached thread may
+ * still be terminating when the next thread with the same name is created.
+ */
+struct profiledThread
+{
+    const char *name;       // Thread name
+    size_t      nominal;    // Stack size on the target devices
+    size_t      size;       // Allocated stack size
+    uint8_t    *stack[2];   // Lowest address of the stacks
+    uint8_t     next;       // Stack to be used by the next thread
+    size_t      peak;       // Peak stack usage of the terminated threads
+};
+
+static pthread_mutex_t threadMutex = PTHREAD_MUTEX_INITIALIZER;
+static profiledThread  threads[CONFIG_MEMPROF_MAX_THREADS];
+static size_t          numThreads = 0;
+
+static std::atomic< size_t > heapUsed(0);
+static std::atomic< size_t > heapPeak(0);
+
+
+/**
+ * \internal Get an approximation of the stack pointer of the caller thread.
+ */
+static inline const uint8_t *currentSp()
+{
+    return reinterpret_cast< const uint8_t * >(__builtin_frame_address(0));
+}
+
+/**
+ * \internal Get the space of a painted stack which has never been used.
+ * Stacks grow downwards, thus the untouched area is at the lowest addresses.
+ *
+ * @param stack: lowest address of the stack.
+ * @param size: stack size.
+ * @return number of bytes never used.
+ */
+static size_t unusedStack(const uint8_t *stack, const size_t size)
+{
+    size_t free = 0;
+    while((free < size) && (stack[free] == STACK_PAINT))
+        free++;
+
+    return free;
+}
+
+/**
+ * \internal Get the profiled stack containing a given address.
+ *
+ * @param addr: address to look up.
+ * @param size: stack size.
+ * @return lowest address of the stack or NULL if the address does not belong
+ * to any of the profiled stacks.
+ */
+static const uint8_t *findStack(const uint8_t *addr, size_t *size)
+{
+    const uint8_t *ret = NULL;
+
+    pthread_mutex_lock(&threadMutex);
+    for(size_t i = 0; (i < numThreads) && (ret == NULL); i++)
+    {
+        for(size_t j = 0; j < 2; j++)
+        {
+            const uint8_t *stack = threads[i].stack[j];
+            if((stack != NULL) && (addr >= stack) &&
+               (addr < stack + threads[i].size))
+            {
+                ret   = stack;
+                *size = threads[i].size;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&threadMutex);
+
+    return ret;
+}
+
+/**
+ * \internal Get the stack of the caller thread from the thread library, used
+ * for the threads which are not profiled.
+ *
+ * @param stack: lowest address of the stack.
+ * @param size: stack size.
+ * @return true on success.
+ */
+static bool threadStack(const uint8_t **stack, size_t *size)
+{
+    #ifdef __GLIBC__
+    pthread_attr_t attr;
+    void *addr;
+
+    if(pthread_getattr_np(pthread_self(), &attr) != 0)
+        return false;
+
+    int ret = pthread_attr_getstack(&attr, &addr, size);
+    pthread_attr_destroy(&attr);
+
+    *stack = reinterpret_cast< const uint8_t * >(addr);
+    return ret == 0;
+    #else
+    (void) stack;
+    (void) size;
+
+    return false;
+    #endif
+}
+
+/**
+ * \internal Get the peak stack usage of a profiled thread across all its
+ * instances. To be called with the thread table locked.
+ *
+ * @param thread: profiled thread.
+ * @return peak stack usage, in bytes.
+ */
+static size_t threadPeak(const profiledThread *thread)
+{
+    size_t peak = thread->peak;
+
+    for(size_t i = 0; i < 2; i++)
+    {
+        if(thread->stack[i] == NULL)
+            continue;
+
+        size_t used = thread->size - unusedStack(thread->stack[i], thread->size);
+        if(used > peak)
+            peak = used;
+    }
+
+    return peak;
+}
+
+unsigned int getStackSize()
+{
+    const uint8_t *stack;
+    size_t size;
+
+    if(findStack(currentSp(), &size) != NULL)
+        return size;
+
+    if(threadStack(&stack, &size) == false)
+        return 0;
+
+    return size;
+}
+
+unsigned int getAbsoluteFreeStack()
+{
+    size_t size;
+    const uint8_t *stack = findStack(currentSp(), &size);
+    if(stack != NULL)
+        return unusedStack(stack, size);
+
+    // Stack of a non profiled thread: its high-water mark is unknown
+    return getCurrentFreeStack();
+}
+
+unsigned int getCurrentFreeStack()
+{
+    const uint8_t *sp = currentSp();
+    const uint8_t *stack;
+    size_t size;
+
+    stack = findStack(sp, &size);
+    if((stack == NULL) && (threadStack(&stack, &size) == false))
+        return 0;
+
+    return sp - stack;
+}
+
+unsigned int getHeapSize()
+{
+    // The host has no heap limit, use a budget growing with the peak usage
+    size_t peak = heapPeak.load();
+    if(peak > CONFIG_MEMPROF_HEAP_SIZE)
+        return peak;
+
+    return CONFIG_MEMPROF_HEAP_SIZE;
+}
+
+unsigned int getAbsoluteFreeHeap()
+{
+    return getHeapSize() - heapPeak.load();
+}
+
+unsigned int getCurrentFreeHeap()
+{
+    return getHeapSize() - heapUsed.load();
+}
+
+int memprof_setThreadStack(pthread_attr_t *attr, const char *name,
+                           const size_t nominalSize)
+{
+    profiledThread *thread = NULL;
+    uint8_t *stack = NULL;
+
+    pthread_mutex_lock(&threadMutex);
+
+    for(size_t i = 0; i < numThreads; i++)
+    {
+        if(strcmp(threads[i].name, name) == 0)
+        {
+            thread = &threads[i];
+            break;
+        }
+    }
+
+    if((thread == NULL) && (numThreads < CONFIG_MEMPROF_MAX_THREADS))
+    {
+        size_t size = CONFIG_MEMPROF_STACK_SIZE;
+        if(size < nominalSize)
+            size = nominalSize;
+
+        size_t page = sysconf(_SC_PAGESIZE);
+
+        thread          = &threads[numThreads];
+        thread->name    = name;
+        thread->nominal = nominalSize;
+        thread->size    = (size + page - 1) & ~(page - 1);
+        numThreads++;
+    }
+
+    if(thread != NULL)
+    {
+        stack = thread->stack[thread->next];
+
+        if(stack == NULL)
+        {
+            // Allocate the stack outside the heap, not to account it as heap
+            void *mem = mmap(NULL, thread->size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+            if(mem != MAP_FAILED)
+                stack = reinterpret_cast< uint8_t * >(mem);
+        }
+        else
+        {
+            // Save the peak usage of the previous thread before repainting
+            thread->peak = threadPeak(thread);
+        }
+
+        if(stack != NULL)
+        {
+            memset(stack, STACK_PAINT, thread->size);
+            thread->stack[thread->next] = stack;
+            thread->next ^= 1;
+        }
+    }
+
+    pthread_mutex_unlock(&threadMutex);
+
+    if(stack == NULL)
+        return -1;
+
+    if(pthread_attr_setstack(attr, stack, thread->size) != 0)
+        return -1;
+
+    return 0;
+}
+
+void memprof_printReport()
+{
+    printf("Thread      Nominal     Peak  Allocated\n");
+
+    pthread_mutex_lock(&threadMutex);
+    for(size_t i = 0; i < numThreads; i++)
+    {
+        const profiledThread *thread = &threads[i];
+        size_t peak = threadPeak(thread);
+
+        printf("%-10s %8zu %8zu %10zu%s\n", thread->name, thread->nominal,
+               peak, thread->size, (peak > thread->nominal) ? "  (over)" : "");
+    }
+    pthread_mutex_unlock(&threadMutex);
+
+    printf("Heap: %zu bytes used, %zu bytes peak\n", heapUsed.load(),
+           heapPeak.load());
+}
+
+#if defined(__GLIBC__) && !defined(ASAN_ENABLED)
+
+/*
+ * Replacement of the glibc allocation functions, forwarding the requests to the
+ * glibc allocator while keeping track of the heap usage. Allocations which are
+ * not done through these functions must never be released by them, thus all
+ * the allocation functions provided by glibc are replaced.
+ */
+
+extern "C"
+{
+
+void *__libc_malloc(size_t size);
+void  __libc_free(void *ptr);
+void *__libc_calloc(size_t num, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void *__libc_valloc(size_t size);
+void *__libc_pvalloc(size_t size);
+
+}
+
+static void heapAdd(void *ptr)
+{
+    if(ptr == NULL)
+        return;
+
+    size_t size = malloc_usable_size(ptr);
+    size_t used = heapUsed.fetch_add(size) + size;
+    size_t peak = heapPeak.load();
+
+    while(used > peak)
+    {
+        if(heapPeak.compare_exchange_weak(peak, used))
+            break;
+    }
+}
+
+static void heapRemove(void *ptr)
+{
+    if(ptr != NULL)
+        heapUsed.fetch_sub(malloc_usable_size(ptr));
+}
+
+extern "C"
+{
+
+void *malloc(size_t size)
+{
+    void *ptr = __libc_malloc(size);
+    heapAdd(ptr);
+
+    return ptr;
+}
+
+void free(void *ptr)
+{
+    heapRemove(ptr);
+    __libc_free(ptr);
+}
+
+void *calloc(size_t num, size_t size)
+{
+    void *ptr = __libc_calloc(num, size);
+    heapAdd(ptr);
+
+    return ptr;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    size_t prevSize = (ptr != NULL) ? malloc_usable_size(ptr) : 0;
+    void  *newPtr   = __libc_realloc(ptr, size);
+
+    // On failure the original block is left untouched
+    if((newPtr == NULL) && (size != 0))
+        return NULL;
+
+    heapUsed.fetch_sub(prevSize);
+    heapAdd(newPtr);
+
+    return newPtr;
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    void *ptr = __libc_memalign(alignment, size);
+    heapAdd(ptr);
+
+    return ptr;
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+    if((alignment % sizeof(void *)) != 0)
+        return EINVAL;
+
+    if((alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    void *mem = memalign(alignment, size);
+    if((mem == NULL) && (size != 0))
+        return ENOMEM;
+
+    *ptr = mem;
+    return 0;
+}
+
+void *valloc(size_t size)
+{
+    void *ptr = __libc_valloc(size);
+    heapAdd(ptr);
+
+    return ptr;
+}
+
+void *pvalloc(size_t size)
+{
+    void *ptr = __libc_pvalloc(size);
+    heapAdd(ptr);
+
+    return ptr;
+}
+
+}
+
+#endif
+
 #else
 
 /*
- * No memory profiling is possible on x86/64 machines, thus all the functions
+ * No memory profiling is available on this platform, thus all the functions
  * return 0.
  */
 
@@ -23,6 +23,7 @@
 #include <interfaces/display.h>
 #include <interfaces/delays.h>
 #include <interfaces/cps_io.h>
+#include <cps_index.h>
 #include <peripherals/gps.h>
 #include <voicePrompts.h>
 #include <graphics.h>
@@ -74,6 +75,9 @@ void openrtx_init()
     sleepFor(0u, 30u);
     display_setBacklightLevel(state.settings.brightness);
 
+    // Build the codeplug search indices while the splash screen is shown
+    cpsIndex_build();
+
     #if defined(CONFIG_GPS)
     // Detect and initialise GPS
     state.gpsDetected = gps_detect(1000);
@@ -0,0 +1,179 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <interfaces/delays.h>
+#include <thread_stats.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * Timing state of a thread loop, written only by the thread running it.
+ */
+typedef struct
+{
+    threadStats_t stats;        // Statistics exposed to the other threads
+    long long     start;        // Start time of the current iteration
+    long long     pauseStart;   // Start time of the current wait
+    long long     prevStart;    // Start time of the previous iteration
+    uint64_t      total;        // Total duration of the iterations
+    bool          late;         // Previous iteration missed its deadline
+    atomic_bool   clear;        // Statistics clear requested
+}
+loopState_t;
+
+static const char *loopNames[LOOP_NUM] =
+{
+    "UI", "Main", "RTX", "Encode", "Decode"
+};
+
+static const uint32_t loopPeriods[LOOP_NUM] =
+{
+    25, 5, 0, 20, 20
+};
+
+static loopState_t loops[LOOP_NUM];
+
+
+static void clearLoop(loopState_t *state, const enum threadLoop loop)
+{
+    memset(&state->stats, 0x00, sizeof(threadStats_t));
+    state->stats.period = loopPeriods[loop];
+    state->prevStart    = -1;
+    state->total        = 0;
+    state->late         = false;
+}
+
+void threadStats_begin(const enum threadLoop loop)
+{
+    if(loop >= LOOP_NUM)
+        return;
+
+    loopState_t *state = &loops[loop];
+    long long now = getTick();
+
+    // Statistics of a never used loop are not yet initialised
+    if((atomic_exchange(&state->clear, false) == true) ||
+       (state->stats.period != loopPeriods[loop]))
+        clearLoop(state, loop);
+
+    uint32_t period = state->stats.period;
+    if((period > 0) && (state->prevStart >= 0))
+    {
+        long long interval = now - state->prevStart;
+        long long jitter   = interval - period;
+        if(jitter < 0)
+            jitter = -jitter;
+
+        if(jitter > state->stats.maxJitter)
+            state->stats.maxJitter = jitter;
+
+        // Late start, not already accounted to an overlong iteration
+        if((interval > (2 * period)) && (state->late == false))
+            state->stats.missed += 1;
+    }
+
+    state->prevStart = now;
+    state->start     = now;
+}
+
+void threadStats_end(const enum threadLoop loop)
+{
+    if(loop >= LOOP_NUM)
+        return;
+
+    loopState_t *state = &loops[loop];
+    uint32_t duration  = getTick() - state->start;
+
+    state->total += duration;
+    state->stats.iterations  += 1;
+    state->stats.lastDuration = duration;
+    state->stats.avgDuration  = state->total / state->stats.iterations;
+
+    if(duration > state->stats.maxDuration)
+        state->stats.maxDuration = duration;
+
+    uint32_t period = state->stats.period;
+    state->late = (period > 0) && (duration > period);
+    if(state->late)
+        state->stats.missed += 1;
+}
+
+void threadStats_pause(const enum threadLoop loop)
+{
+    if(loop < LOOP_NUM)
+        loops[loop].pauseStart = getTick();
+}
+
+void threadStats_resume(const enum threadLoop loop)
+{
+    if(loop >= LOOP_NUM)
+        return;
+
+    // Move the start of the iteration forward by the time spent waiting
+    loopState_t *state = &loops[loop];
+    state->start += getTick() - state->pauseStart;
+}
+
+void threadStats_restart(const enum threadLoop loop)
+{
+    if(loop < LOOP_NUM)
+        loops[loop].prevStart = -1;
+}
+
+int threadStats_get(const enum threadLoop loop, threadStats_t *stats)
+{
+    if(loop >= LOOP_NUM)
+        return -1;
+
+    memcpy(stats, &loops[loop].stats, sizeof(threadStats_t));
+    stats->period = loopPeriods[loop];
+
+    return 0;
+}
+
+void threadStats_reset()
+{
+    for(size_t i = 0; i < LOOP_NUM; i++)
+        atomic_store(&loops[i].clear, true);
+}
+
+void threadStats_dump(FILE *file)
+{
+    fprintf(file, "Loop   Period Iterations Last  Avg  Max Jitter Missed\n");
+
+    for(size_t i = 0; i < LOOP_NUM; i++)
+    {
+        threadStats_t stats;
+        threadStats_get(i, &stats);
+
+        fprintf(file, "%-6s %6lu %10lu %4lu %4lu %4lu %6lu %6lu\n",
+                loopNames[i],
+                (unsigned long) stats.period,
+                (unsigned long) stats.iterations,
+                (unsigned long) stats.lastDuration,
+                (unsigned long) stats.avgDuration,
+                (unsigned long) stats.maxDuration,
+                (unsigned long) stats.maxJitter,
+                (unsigned long) stats.missed);
+    }
+
+    fflush(file);
+}
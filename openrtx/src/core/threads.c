@@ -38,6 +38,10 @@
 #include <gps.h>
 #endif
 #include <voicePrompts.h>
+#include <thread_stats.h>
+#ifdef PLATFORM_LINUX
+#include <memory_profiling.h>
+#endif
 
 #if defined(PLATFORM_TTWRPLUS)
 #include <pmu.h>
@@ -69,6 +73,7 @@ void *ui_threadFunc(void *arg)
     while(state.devStatus != SHUTDOWN)
     {
         time = getTick();
+        threadStats_begin(LOOP_UI);
 
         if(input_scanKeyboard(&kbd_msg))
         {
@@ -104,6 +109,7 @@ void *ui_threadFunc(void *arg)
             // Copy new M17 CAN, source and destination addresses
             rtx_cfg.can = state.settings.m17_can;
             rtx_cfg.canRxEn = state.settings.m17_can_rx;
+            rtx_cfg.softDec = !state.settings.m17_hard_dec;
             strncpy(rtx_cfg.source_address,      state.settings.callsign, 10);
             strncpy(rtx_cfg.destination_address, state.settings.m17_dest, 10);
 
@@ -116,9 +122,11 @@ void *ui_threadFunc(void *arg)
         // Update UI and render on screen, if necessary
         if(ui_updateGUI() == true)
         {
-            gfx_render();
+            gfx_renderDirty();
         }
 
+        threadStats_end(LOOP_UI);
+
         // 40Hz update rate for keyboard and UI
         time += 25;
         sleepUntil(time);
@@ -138,10 +146,14 @@ void *main_thread(void *arg)
     (void) arg;
 
     long long time     = 0;
+    #ifdef CONFIG_THREAD_STATS_DUMP
+    long long lastDump = 0;
+    #endif
 
     while(state.devStatus != SHUTDOWN)
     {
         time = getTick();
+        threadStats_begin(LOOP_MAIN);
 
         #if defined(PLATFORM_TTWRPLUS)
         pmu_handleIRQ();
@@ -161,6 +173,20 @@ void *main_thread(void *arg)
         // Run state update task
         state_task();
 
+        threadStats_end(LOOP_MAIN);
+
+        // Periodically dump the timing statistics of the thread loops. The
+        // dump may block on the USB VCOM: restart the loop statistics to not
+        // account the delay as jitter or as a missed deadline.
+        #ifdef CONFIG_THREAD_STATS_DUMP
+        if((time - lastDump) >= CONFIG_THREAD_STATS_DUMP)
+        {
+            threadStats_dump(stdout);
+            threadStats_restart(LOOP_MAIN);
+            lastDump = time;
+        }
+        #endif
+
         // Run this loop once every 5ms
         time += 5;
         sleepUntil(time);
@@ -182,6 +208,8 @@ void *rtx_threadFunc(void *arg)
 
     rtx_init(&rtx_mutex);
 
+    // The timing of the RTX loop is marked by the operating modes, which
+    // know where they wait for the radio or the baseband streams
     while(state.devStatus == RUNNING)
     {
         rtx_task();
@@ -204,7 +232,9 @@ void create_threads()
     pthread_attr_t rtx_attr;
     pthread_attr_init(&rtx_attr);
 
-    #ifndef __ZEPHYR__
+    #if defined(PLATFORM_LINUX)
+    memprof_setThreadStack(&rtx_attr, "RTX", RTX_THREAD_STKSIZE);
+    #elif !defined(__ZEPHYR__)
     pthread_attr_setstacksize(&rtx_attr, RTX_THREAD_STKSIZE);
     #else
     void *rtx_thread_stack = malloc(RTX_THREAD_STKSIZE * sizeof(uint8_t));
@@ -225,7 +255,9 @@ void create_threads()
     pthread_attr_t ui_attr;
     pthread_attr_init(&ui_attr);
 
-    #ifndef __ZEPHYR__
+    #if defined(PLATFORM_LINUX)
+    memprof_setThreadStack(&ui_attr, "UI", UI_THREAD_STKSIZE);
+    #elif !defined(__ZEPHYR__)
     pthread_attr_setstacksize(&ui_attr, UI_THREAD_STKSIZE);
     #else
     void *ui_thread_stack = malloc(UI_THREAD_STKSIZE * sizeof(uint8_t));
@@ -34,6 +34,7 @@
 #include <ui/ui_default.h>
 #include <beeps.h>
 #include "interfaces/cps_io.h"
+#include "cps_cache.h"
 
 const uint16_t BOOT_MELODY[] = {400, 3, 600, 3, 800, 3, 0, 0};
 
@@ -449,7 +450,7 @@ bool vp_announceContactWithIndex(const uint16_t index, const vpQueueFlags_t flag
         return false;
 
     contact_t contact;
-    if (cps_readContact(&contact, index) == -1)
+    if (cpsCache_readContact(&contact, index) == -1)
         return false;
 
     vp_announceContact(&contact, flags);
@@ -502,7 +503,7 @@ void vp_announceBank(const uint16_t bank, const vpQueueFlags_t flags)
     if (state.bank_enabled)
     {
         bankHdr_t bank_hdr = {0};
-        cps_readBankHeader(&bank_hdr, bank);
+        cpsCache_readBankHeader(&bank_hdr, bank);
         vp_queueString(bank_hdr.name, vpAnnounceCommonSymbols);
     }
     else
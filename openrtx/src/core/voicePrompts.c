@@ -34,6 +34,10 @@
 #include <string.h>
 #include <beeps.h>
 #include <errno.h>
+#if defined(VP_USE_FILESYSTEM) && defined(PLATFORM_LINUX)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 static const uint32_t VOICE_PROMPTS_DATA_MAGIC   = 0x5056;  //'VP'
 static const uint32_t VOICE_PROMPTS_DATA_VERSION = 0x1000;  // v1000 OpenRTX
@@ -62,7 +66,7 @@ typedef struct
     uint16_t buffer[VP_SEQUENCE_BUF_SIZE];  // Buffer of individual prompt indices.
     uint16_t pos;                           // Index into above buffer.
     uint16_t length;                        // Number of entries in above buffer.
-    uint32_t c2DataStart;
+    const uint8_t *c2Data;                  // Codec2 data for current prompt.
     uint32_t c2DataIndex;                   // Index into current codec2 data
     uint32_t c2DataLength;                  // Length of codec2 data for current prompt.
 }
@@ -95,7 +99,7 @@ static vpSequence_t vpCurrentSequence =
 {
     .pos          = 0,
     .length       = 0,
-    .c2DataStart  = 0,
+    .c2Data       = NULL,
     .c2DataIndex  = 0,
     .c2DataLength = 0
 };
@@ -112,12 +116,84 @@ static bool       delayBeepUntilTick  = false;
 static pathId     vpAudioPath;
 static long long  vpStartTime;
 
-#ifdef VP_USE_FILESYSTEM
-static FILE *vpFile = NULL;
-#else
+// Voice prompt data, always memory resident: either linked in the firmware
+// image or loaded from the filesystem at initialisation.
+static const uint8_t *vpData     = NULL;
+static size_t         vpDataSize = 0;
+
+#ifndef VP_USE_FILESYSTEM
 extern unsigned char _vpdata_start;
 extern unsigned char _vpdata_end;
-unsigned char        *vpData = &_vpdata_start;
+#else
+/**
+ * \internal
+ * Load the voice prompt file in memory. On linux the file is mapped, so that
+ * its pages are shared with the page cache and loaded only when needed,
+ * elsewhere it is read once in a heap buffer.
+ *
+ * @param path: path of the voice prompt file.
+ */
+static void loadVpFile(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if(fp == NULL)
+        return;
+
+    fseek(fp, 0L, SEEK_END);
+    long size = ftell(fp);
+    if(size <= 0)
+    {
+        fclose(fp);
+        return;
+    }
+
+    #ifdef PLATFORM_LINUX
+    void *addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+    if(addr != MAP_FAILED)
+    {
+        vpData     = (const uint8_t *) addr;
+        vpDataSize = size;
+    }
+    #else
+    uint8_t *buf = (uint8_t *) malloc(size);
+    if(buf != NULL)
+    {
+        fseek(fp, 0L, SEEK_SET);
+        if(fread(buf, 1, size, fp) == (size_t) size)
+        {
+            vpData     = buf;
+            vpDataSize = size;
+        }
+        else
+        {
+            free(buf);
+        }
+    }
+    #endif
+
+    // Mapping stays valid also after the file has been closed
+    fclose(fp);
+}
+
+/**
+ * \internal
+ * Release the memory holding the voice prompt file.
+ */
+static void unloadVpFile()
+{
+    if(vpData == NULL)
+        return;
+
+    #ifdef PLATFORM_LINUX
+    munmap((void *) vpData, vpDataSize);
+    #else
+    free((void *) vpData);
+    #endif
+
+    vpData       = NULL;
+    vpDataSize   = 0;
+    vpDataLoaded = false;
+}
 #endif
 
 /**
@@ -128,12 +204,7 @@ unsigned char        *vpData = &_vpdata_start;
  */
 static void loadVpHeader(vpHeader_t *header)
 {
-    #ifdef VP_USE_FILESYSTEM
-    fseek(vpFile, 0L, SEEK_SET);
-    fread(header, sizeof(vpHeader_t), 1, vpFile);
-    #else
     memcpy(header, vpData, sizeof(vpHeader_t));
-    #endif
 }
 
 /**
@@ -142,54 +213,65 @@ static void loadVpHeader(vpHeader_t *header)
  */
 static void loadVpToC()
 {
-    #ifdef VP_USE_FILESYSTEM
-    fread(&tableOfContents, sizeof(tableOfContents), 1, vpFile);
-    size_t vpDataOffset = ftell(vpFile);
+    if(vpDataSize < (sizeof(vpHeader_t) + sizeof(tableOfContents)))
+        return;
 
-    if(vpDataOffset == (sizeof(vpHeader_t) + sizeof(tableOfContents)))
-        vpDataLoaded = true;
-    #else
-    uint8_t *tocPtr = vpData + sizeof(vpHeader_t);
-    memcpy(&tableOfContents, tocPtr, sizeof(tableOfContents));
+    memcpy(&tableOfContents, vpData + sizeof(vpHeader_t), sizeof(tableOfContents));
     vpDataLoaded = true;
-    #endif
 }
 
 /**
  * \internal
- * Load Codec2 data for a voice prompt.
+ * Get the Codec2 data of a voice prompt, without copying it.
  *
- * @param offset: offset relative to the start of the voice prompt data.
- * @param length: data length in bytes.
+ * @param prompt: index of the voice prompt.
+ * @param data: pointer to the start of the prompt data.
+ * @return length of the prompt data in bytes, zero if the prompt is not valid.
  */
-static void fetchCodec2Data(uint8_t *data, const size_t offset)
+static size_t getPromptData(const uint16_t prompt, const uint8_t **data)
 {
-    if (vpDataLoaded == false)
-        return;
+    if((vpDataLoaded == false) || (prompt >= (VOICE_PROMPTS_TOC_SIZE - 1)))
+        return 0;
 
-    #ifdef VP_USE_FILESYSTEM
-    if (vpFile == NULL)
-        return;
+    uint32_t begin = tableOfContents[prompt];
+    uint32_t end   = tableOfContents[prompt + 1];
+    if(end < begin)
+        return 0;
 
-    size_t start = sizeof(vpHeader_t)
-                 + sizeof(tableOfContents)
-                 + CODEC2_HEADER_SIZE;
+    size_t start  = sizeof(vpHeader_t)
+                  + sizeof(tableOfContents)
+                  + CODEC2_HEADER_SIZE
+                  + begin;
+    size_t length = ((end - begin) / 8) * 8;
 
-    fseek(vpFile, start + offset, SEEK_SET);
-    fread(data, 8, 1, vpFile);
-    #else
-    uint8_t *dataPtr = vpData
-                     + sizeof(vpHeader_t)
-                     + sizeof(tableOfContents)
-                     + CODEC2_HEADER_SIZE;
+    if((start + length) > vpDataSize)
+        return 0;
 
-    if((dataPtr + 8) >= &_vpdata_end)
+    *data = vpData + start;
+    return length;
+}
+
+/**
+ * \internal
+ * Resolve all the prompts of the current sequence and, when the data is mapped
+ * from a file, ask the kernel to bring it in memory before the playback.
+ */
+static void prefetchSequence()
+{
+    #if defined(VP_USE_FILESYSTEM) && defined(PLATFORM_LINUX)
+    const uintptr_t pageMask = (uintptr_t) sysconf(_SC_PAGESIZE) - 1;
+
+    for(uint16_t i = 0; i < vpCurrentSequence.length; i++)
     {
-        memset(data, 0x00, 8);
-        return;
-    }
+        const uint8_t *data;
+        size_t length = getPromptData(vpCurrentSequence.buffer[i], &data);
+        if(length == 0)
+            continue;
 
-    memcpy(data, dataPtr + offset, 8);
+        uintptr_t begin = ((uintptr_t) data) & ~pageMask;
+        uintptr_t end   = ((uintptr_t) data) + length;
+        madvise((void *) begin, end - begin, MADV_WILLNEED);
+    }
     #endif
 }
 
@@ -354,16 +436,16 @@ static bool beep_tick()
 void vp_init()
 {
     #ifdef VP_USE_FILESYSTEM
-    if(vpFile == NULL)
-        vpFile = fopen("voiceprompts.vpc", "r");
-
-    if(vpFile == NULL)
-        return;
+    if(vpData == NULL)
+        loadVpFile("voiceprompts.vpc");
     #else
-    if(&_vpdata_start == &_vpdata_end)
-        return;
+    vpData     = &_vpdata_start;
+    vpDataSize = &_vpdata_end - &_vpdata_start;
     #endif
 
+    if(vpDataSize < sizeof(vpHeader_t))
+        return;
+
     // Read header
     vpHeader_t header;
     loadVpHeader(&header);
@@ -399,7 +481,7 @@ void vp_terminate()
     codec_terminate();
 
     #ifdef VP_USE_FILESYSTEM
-    fclose(vpFile);
+    unloadVpFile();
     #endif
 }
 
@@ -556,6 +638,8 @@ void vp_play()
     if (vpCurrentSequence.length <= 0)
         return;
 
+    prefetchSequence();
+
     // TODO: remove this once switching to hardware-based I2C driver for AT1846S
     // management.
     vpStartTime = getTick();
@@ -584,7 +668,7 @@ void vp_tick()
         vpStartTime       = 0;
         voicePromptActive = true;
         enableSpkOutput();
-        codec_startDecode(vpAudioPath);
+        codec_startDecode(vpAudioPath, false);
     }
 
     if (voicePromptActive == false)
@@ -599,18 +683,16 @@ void vp_tick()
             int promptNumber = vpCurrentSequence.buffer[vpCurrentSequence.pos];
 
             vpCurrentSequence.c2DataIndex  = 0;
-            vpCurrentSequence.c2DataStart  = tableOfContents[promptNumber];
-            vpCurrentSequence.c2DataLength = ((tableOfContents[promptNumber + 1]
-                                           - tableOfContents[promptNumber])/8 * 8);
+            vpCurrentSequence.c2DataLength = getPromptData(promptNumber,
+                                                           &vpCurrentSequence.c2Data);
         }
 
         while (vpCurrentSequence.c2DataIndex < vpCurrentSequence.c2DataLength)
         {
-            // push the codec2 data in lots of 8 byte frames.
-            uint8_t c2Frame[8] = {0};
-
-            fetchCodec2Data(c2Frame, vpCurrentSequence.c2DataStart +
-                                     vpCurrentSequence.c2DataIndex);
+            // push the codec2 data in lots of 8 byte frames, straight from
+            // the voice prompt data.
+            const uint8_t *c2Frame = vpCurrentSequence.c2Data
+                                   + vpCurrentSequence.c2DataIndex;
 
             // Do not push codec2 data if audio path is closed or suspended
             if(audioPath_getStatus(vpAudioPath) != PATH_OPEN)
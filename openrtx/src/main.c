@@ -26,8 +26,13 @@
 #endif
 
 #ifdef PLATFORM_LINUX
+#include <pthread.h>
+#ifdef CONFIG_EMULATOR_HEADLESS
+#include <emulator/headless_engine.h>
+#else
 #include <emulator/sdl_engine.h>
 #endif
+#endif
 
 int main(void)
 {
@@ -55,7 +60,11 @@ int main(void)
     pthread_t openrtx_thread;
     pthread_create(&openrtx_thread, NULL, openrtx_run, NULL);
 
+    #ifdef CONFIG_EMULATOR_HEADLESS
+    headlessEngine_run();
+    #else
     sdlEngine_run();
+    #endif
     pthread_join(openrtx_thread, NULL);
 #endif
 }
@@ -21,6 +21,7 @@
  ***************************************************************************/
 
 #include <string>
+#include <cstring>
 #include <M17/M17Callsign.hpp>
 
 bool M17::encode_callsign(const std::string& callsign, call_t& encodedCall,
@@ -68,6 +69,14 @@ bool M17::encode_callsign(const std::string& callsign, call_t& encodedCall,
 }
 
 std::string M17::decode_callsign(const call_t& encodedCall)
+{
+    char callsign[M17_CALLSIGN_SIZE];
+    decode_callsign(encodedCall, callsign);
+
+    return std::string(callsign);
+}
+
+size_t M17::decode_callsign(const call_t& encodedCall, char *callsign)
 {
     // First of all, check if encoded address is a broadcast one
     bool isBroadcast = true;
@@ -80,7 +89,11 @@ std::string M17::decode_callsign(const call_t& encodedCall)
         }
     }
 
-    if(isBroadcast) return "ALL";
+    if(isBroadcast)
+    {
+        strcpy(callsign, "ALL");
+        return 3;
+    }
 
     /*
      * Address is not broadcast, decode it.
@@ -92,18 +105,40 @@ std::string M17::decode_callsign(const call_t& encodedCall)
     auto p = reinterpret_cast<uint8_t*>(&encoded);
     std::copy(encodedCall.rbegin(), encodedCall.rend(), p);
 
-    // Decode each base-40 digit and map them to the appriate character.
-    std::string result;
+    // Decode each base-40 digit and map them to the appriate character. Values
+    // not fitting in nine digits are not valid callsigns and get truncated.
     size_t index = 0;
 
-    while(encoded)
+    while(encoded && (index < (M17_CALLSIGN_SIZE - 1)))
     {
-        result.push_back(charMap[encoded % 40]);
+        callsign[index] = charMap[encoded % 40];
         index++;
         encoded /= 40;
     }
 
-    result[index] = '\0';
+    callsign[index] = '\0';
+
+    return index;
+}
+
+bool M17::compare_callsigns(const char *localCs, const char *incomingCs)
+{
+    if((strcmp(incomingCs, "ALL")  == 0) ||
+       (strcmp(incomingCs, "INFO") == 0) ||
+       (strcmp(incomingCs, "ECHO") == 0))
+        return true;
+
+    // Strip country prefixes up to two characters long
+    const char *slash = strchr(localCs, '/');
+    if((slash != NULL) && ((slash - localCs) <= 2))
+        localCs = slash + 1;
+
+    slash = strchr(incomingCs, '/');
+    if((slash != NULL) && ((slash - incomingCs) <= 2))
+        incomingCs = slash + 1;
+
+    if(strcmp(localCs, incomingCs) == 0)
+        return true;
 
-    return result;
+    return false;
 }
@@ -24,8 +24,10 @@
 #include <M17/M17DSP.hpp>
 #include <M17/M17Utils.hpp>
 #include <audio_stream.h>
+#include <thread_stats.h>
 #include <math.h>
 #include <cstring>
+#include <climits>
 #include <stdio.h>
 
 using namespace M17;
@@ -148,7 +150,7 @@ static inline void pushLog(const log_entry_t& e)
 #endif
 
 
-M17Demodulator::M17Demodulator()
+M17Demodulator::M17Demodulator() : basebandId(-1), basebandPath(-1)
 {
 
 }
@@ -169,6 +171,8 @@ void M17Demodulator::init()
     baseband_buffer = std::make_unique< int16_t[] >(2 * SAMPLE_BUF_SIZE);
     demodFrame      = std::make_unique< frame_t >();
     readyFrame      = std::make_unique< frame_t >();
+    demodSoftFrame  = std::make_unique< softFrame_t >();
+    readySoftFrame  = std::make_unique< softFrame_t >();
 
     reset();
 
@@ -192,6 +196,8 @@ void M17Demodulator::terminate()
     baseband_buffer.reset();
     demodFrame.reset();
     readyFrame.reset();
+    demodSoftFrame.reset();
+    readySoftFrame.reset();
 
     #ifdef ENABLE_DEMOD_LOG
     logRunning = false;
@@ -222,6 +228,11 @@ const frame_t& M17Demodulator::getFrame()
     return *readyFrame;
 }
 
+const softFrame_t& M17Demodulator::getSoftFrame()
+{
+    return *readySoftFrame;
+}
+
 bool M17Demodulator::isLocked()
 {
     return locked;
@@ -233,153 +244,175 @@ bool M17Demodulator::update(const bool invertPhase)
     if(audioPath_getStatus(basebandPath) != PATH_OPEN)
         return false;
 
-    // Read samples from the ADC
+    // Read samples from the ADC, waiting for them is not part of the RTX
+    // thread activity
+    threadStats_pause(LOOP_RTX);
     dataBlock_t baseband = inputStream_getData(basebandId);
-    if(baseband.data != NULL)
+    threadStats_resume(LOOP_RTX);
+    if(baseband.data == NULL)
+        return newFrame;
+
+    return update(baseband.data, baseband.len, invertPhase);
+}
+
+bool M17Demodulator::update(int16_t *samples, const size_t len,
+                            const bool invertPhase)
+{
+    // Apply DC removal filter
+    #ifdef CONFIG_DSP_FIXED_POINT
+    dsp_dcRemovalQ15(&dcrState, samples, len);
+    #else
+    dsp_dcRemoval(&dcrState, samples, len);
+    #endif
+
+    // Apply RRC on the whole block of samples, phase inversion is done
+    // through the filter gain.
+    const float rrcGain = invertPhase ? -1.0f : 1.0f;
+    rrc.process(samples, samples, len, rrcGain);
+
+    // Process samples
+    for(size_t i = 0; i < len; i++)
     {
-        // Apply DC removal filter
-        dsp_dcRemoval(&dcrState, baseband.data, baseband.len);
+        int16_t sample = samples[i];
 
-        // Process samples
-        for(size_t i = 0; i < baseband.len; i++)
-        {
-            // Apply RRC on the baseband sample
-            float           elem   = static_cast< float >(baseband.data[i]);
-            if(invertPhase) elem   = 0.0f - elem;
-            int16_t         sample = static_cast< int16_t >(M17::rrc_24k(elem));
+        // Update correlator and sample filter for correlation thresholds
+        correlator.sample(sample);
+        corrThreshold = sampleFilter(std::abs(sample));
 
-            // Update correlator and sample filter for correlation thresholds
-            correlator.sample(sample);
-            corrThreshold = sampleFilter(std::abs(sample));
+        switch(demodState)
+        {
+            case DemodState::INIT:
+            {
+                initCount -= 1;
+                if(initCount == 0)
+                    demodState = DemodState::UNLOCKED;
+            }
+                break;
 
-            switch(demodState)
+            case DemodState::UNLOCKED:
             {
-                case DemodState::INIT:
+                // The LSF syncword is the opposite of the stream one and gives
+                // a negative correlation peak. The packet syncword has no such
+                // counterpart, thus only positive peaks are considered.
+                int32_t syncThresh = static_cast< int32_t >(corrThreshold * 33);
+                int8_t  syncStatus = streamSync.update(correlator, syncThresh, -syncThresh);
+                int8_t  pktStatus  = packetSync.update(correlator, syncThresh, INT32_MIN);
+
+                if(syncStatus != 0)
                 {
-                    initCount -= 1;
-                    if(initCount == 0)
-                        demodState = DemodState::UNLOCKED;
+                    samplingPoint = streamSync.samplingIndex();
+                    demodState    = DemodState::SYNCED;
+                }
+                else if(pktStatus != 0)
+                {
+                    samplingPoint = packetSync.samplingIndex();
+                    demodState    = DemodState::SYNCED;
                 }
-                    break;
+            }
+                break;
 
-                case DemodState::UNLOCKED:
+            case DemodState::SYNCED:
+            {
+                // Set deviation, zero frame symbol count
+                outerDeviation = correlator.maxDeviation(samplingPoint);
+                frameIndex     = 0;
+
+                // Quantize the syncword taking data from the correlator
+                // memory.
+                for(size_t i = 0; i < SYNCWORD_SAMPLES; i++)
                 {
-                    int32_t syncThresh = static_cast< int32_t >(corrThreshold * 33.0f);
-                    int8_t  syncStatus = streamSync.update(correlator, syncThresh, -syncThresh);
+                    size_t  pos = (correlator.index() + i) % SYNCWORD_SAMPLES;
+                    int16_t val = correlator.data()[pos];
 
-                    if(syncStatus != 0)
-                        demodState = DemodState::SYNCED;
+                    if((pos % SAMPLES_PER_SYMBOL) == samplingPoint)
+                        updateFrame(val);
                 }
-                    break;
 
-                case DemodState::SYNCED:
+                if(syncwordDistance() == 0)
                 {
-                    // Set sampling point and deviation, zero frame symbol count
-                    samplingPoint  = streamSync.samplingIndex();
-                    outerDeviation = correlator.maxDeviation(samplingPoint);
-                    frameIndex     = 0;
-
-                    // Quantize the syncword taking data from the correlator
-                    // memory.
-                    for(size_t i = 0; i < SYNCWORD_SAMPLES; i++)
-                    {
-                        size_t  pos = (correlator.index() + i) % SYNCWORD_SAMPLES;
-                        int16_t val = correlator.data()[pos];
-
-                        if((pos % SAMPLES_PER_SYMBOL) == samplingPoint)
-                            updateFrame(val);
-                    }
+                    locked     = true;
+                    demodState = DemodState::LOCKED;
+                }
+                else
+                {
+                    demodState = DemodState::UNLOCKED;
+                }
+            }
+                break;
 
-                    uint8_t hd  = hammingDistance((*demodFrame)[0], STREAM_SYNC_WORD[0]);
-                            hd += hammingDistance((*demodFrame)[1], STREAM_SYNC_WORD[1]);
+            case DemodState::LOCKED:
+            {
+                // Quantize and update frame at each sampling point
+                if(sampleIndex == samplingPoint)
+                {
+                    updateFrame(sample);
 
-                    if(hd == 0)
+                    // When we have reached almost the end of a frame, switch
+                    // to syncpoint update.
+                    if(frameIndex == (M17_FRAME_SYMBOLS - M17_SYNCWORD_SYMBOLS/2))
                     {
-                        locked     = true;
-                        demodState = DemodState::LOCKED;
-                    }
-                    else
-                    {
-                        demodState = DemodState::UNLOCKED;
+                        demodState = DemodState::SYNC_UPDATE;
+                        syncCount  = SYNCWORD_SAMPLES * 2;
                     }
                 }
-                    break;
+            }
+                break;
+
+            case DemodState::SYNC_UPDATE:
+            {
+                // Keep filling the ongoing frame!
+                if(sampleIndex == samplingPoint)
+                    updateFrame(sample);
+
+                // Find the new correlation peak
+                int32_t syncThresh = static_cast< int32_t >(corrThreshold * 33);
+                int8_t  syncStatus = streamSync.update(correlator, syncThresh, -syncThresh);
+                int8_t  pktStatus  = packetSync.update(correlator, syncThresh, INT32_MIN);
 
-                case DemodState::LOCKED:
+                if((syncStatus != 0) || (pktStatus != 0))
                 {
-                    // Quantize and update frame at each sampling point
-                    if(sampleIndex == samplingPoint)
+                    // Correlation has to coincide with a syncword!
+                    if(frameIndex == M17_SYNCWORD_SYMBOLS)
                     {
-                        updateFrame(sample);
-
-                        // When we have reached almost the end of a frame, switch
-                        // to syncpoint update.
-                        if(frameIndex == (M17_FRAME_SYMBOLS - M17_SYNCWORD_SYMBOLS/2))
+                        // Valid sync found: update deviation and sample
+                        // point, then go back to locked state
+                        if(syncwordDistance() <= 1)
                         {
-                            demodState = DemodState::SYNC_UPDATE;
-                            syncCount  = SYNCWORD_SAMPLES * 2;
+                            outerDeviation = correlator.maxDeviation(samplingPoint);
+                            samplingPoint  = (syncStatus != 0) ? streamSync.samplingIndex()
+                                                               : packetSync.samplingIndex();
+                            missedSyncs    = 0;
+                            demodState     = DemodState::LOCKED;
+                            break;
                         }
                     }
                 }
-                    break;
 
-                case DemodState::SYNC_UPDATE:
+                // No syncword found within the window, increase the count
+                // of missed syncs and choose where to go. The lock is lost
+                // after four consecutive sync misses.
+                if(syncCount == 0)
                 {
-                    // Keep filling the ongoing frame!
-                    if(sampleIndex == samplingPoint)
-                        updateFrame(sample);
-
-                    // Find the new correlation peak
-                    int32_t syncThresh = static_cast< int32_t >(corrThreshold * 33.0f);
-                    int8_t  syncStatus = streamSync.update(correlator, syncThresh, -syncThresh);
-
-                    if(syncStatus != 0)
+                    if(missedSyncs >= 4)
                     {
-                        // Correlation has to coincide with a syncword!
-                        if(frameIndex == M17_SYNCWORD_SYMBOLS)
-                        {
-                            uint8_t hd  = hammingDistance((*demodFrame)[0], STREAM_SYNC_WORD[0]);
-                                    hd += hammingDistance((*demodFrame)[1], STREAM_SYNC_WORD[1]);
-
-                            // Valid sync found: update deviation and sample
-                            // point, then go back to locked state
-                            if(hd <= 1)
-                            {
-                                outerDeviation = correlator.maxDeviation(samplingPoint);
-                                samplingPoint  = streamSync.samplingIndex();
-                                missedSyncs    = 0;
-                                demodState     = DemodState::LOCKED;
-                                break;
-                            }
-                        }
+                        demodState = DemodState::UNLOCKED;
+                        locked     = false;
                     }
-
-                    // No syncword found within the window, increase the count
-                    // of missed syncs and choose where to go. The lock is lost
-                    // after four consecutive sync misses.
-                    if(syncCount == 0)
+                    else
                     {
-                        if(missedSyncs >= 4)
-                        {
-                            demodState = DemodState::UNLOCKED;
-                            locked     = false;
-                        }
-                        else
-                        {
-                            demodState = DemodState::LOCKED;
-                        }
-
-                        missedSyncs += 1;
+                        demodState = DemodState::LOCKED;
                     }
 
-                    syncCount -= 1;
+                    missedSyncs += 1;
                 }
-                    break;
-            }
 
-            sampleCount += 1;
-            sampleIndex  = (sampleIndex + 1) % SAMPLES_PER_SYMBOL;
+                syncCount -= 1;
+            }
+                break;
         }
+
+        sampleCount += 1;
+        sampleIndex  = (sampleIndex + 1) % SAMPLES_PER_SYMBOL;
     }
 
     return newFrame;
@@ -407,11 +440,24 @@ int8_t M17Demodulator::updateFrame(stream_sample_t sample)
     }
 
     setSymbol(*demodFrame, frameIndex, symbol);
+
+    // Soft decision: normalize the sample so that the outer symbols lie at
+    // +/-3 and the inner ones at +/-1. The first bit of a symbol is set for
+    // negative values, the second one for the outer symbols.
+    int32_t dev = (sample > 0) ? outerDeviation.first : -outerDeviation.second;
+    float   x   = 0.0f;
+    if(dev > 0)
+        x = 3.0f * static_cast< float >(sample) / static_cast< float >(dev);
+
+    (*demodSoftFrame)[2 * frameIndex]     = softBit(0.5f - (x * 0.5f));
+    (*demodSoftFrame)[2 * frameIndex + 1] = softBit((std::abs(x) - 1.0f) * 0.5f);
+
     frameIndex += 1;
 
     if(frameIndex >= M17_FRAME_SYMBOLS)
     {
         std::swap(readyFrame, demodFrame);
+        std::swap(readySoftFrame, demodSoftFrame);
         frameIndex = 0;
         newFrame   = true;
     }
@@ -419,6 +465,34 @@ int8_t M17Demodulator::updateFrame(stream_sample_t sample)
     return symbol;
 }
 
+uint16_t M17Demodulator::softBit(const float value)
+{
+    if(value <= 0.0f) return 0x0000;
+    if(value >= 1.0f) return 0xFFFF;
+
+    return static_cast< uint16_t >(value * 65535.0f);
+}
+
+uint8_t M17Demodulator::syncwordDistance()
+{
+    static constexpr std::array< syncw_t, 3 > syncwords =
+    {
+        LSF_SYNC_WORD, STREAM_SYNC_WORD, PACKET_SYNC_WORD
+    };
+
+    uint8_t minDistance = 0xFF;
+    for(const auto& syncword : syncwords)
+    {
+        uint8_t hd  = hammingDistance((*demodFrame)[0], syncword[0]);
+                hd += hammingDistance((*demodFrame)[1], syncword[1]);
+
+        if(hd < minDistance)
+            minDistance = hd;
+    }
+
+    return minDistance;
+}
+
 void M17Demodulator::reset()
 {
     sampleIndex = 0;
@@ -429,7 +503,12 @@ void M17Demodulator::reset()
     demodState  = DemodState::INIT;
     initCount   = RX_SAMPLE_RATE / 50;  // 50ms of init time
 
+    #ifdef CONFIG_DSP_FIXED_POINT
+    dsp_resetFilterStateQ15(&dcrState);
+    #else
     dsp_resetFilterState(&dcrState);
+    #endif
+    rrc.reset();
 }
 
 
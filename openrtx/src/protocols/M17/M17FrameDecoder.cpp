@@ -29,7 +29,10 @@
 
 using namespace M17;
 
-M17FrameDecoder::M17FrameDecoder() { }
+M17FrameDecoder::M17FrameDecoder()
+{
+    reset();
+}
 
 M17FrameDecoder::~M17FrameDecoder() { }
 
@@ -39,6 +42,11 @@ void M17FrameDecoder::reset()
     lsf.clear();
     lsfFromLich.clear();
     streamFrame.clear();
+    packetFrame.clear();
+    streamLsf.clear();
+    memset(&streamInfo, 0x00, sizeof(streamInfo));
+    event    = M17RxEvent::NONE;
+    inStream = false;
 }
 
 M17FrameType M17FrameDecoder::decodeFrame(const frame_t& frame)
@@ -50,8 +58,41 @@ M17FrameType M17FrameDecoder::decodeFrame(const frame_t& frame)
     std::copy(frame.begin() + 2, frame.end(), data.begin());
 
     // Re-correlating data is the same operation as decorrelating
-    decorrelate(data);
-    deinterleave(data);
+    decorrelateAndDeinterleave(data);
+
+    auto type = getFrameType(syncWord);
+
+    switch(type)
+    {
+        case M17FrameType::LINK_SETUP:
+            decodeLSF(data);
+            break;
+
+        case M17FrameType::STREAM:
+            decodeStream(data);
+            break;
+
+        case M17FrameType::PACKET:
+            decodePacket(data);
+            break;
+
+        default:
+            break;
+    }
+
+    return type;
+}
+
+M17FrameType M17FrameDecoder::decodeFrame(const frame_t& frame,
+                                          const softFrame_t& softFrame)
+{
+    std::array< uint8_t, 2 >   syncWord;
+    std::array< uint16_t, 368 > data;
+
+    std::copy_n(frame.begin(), 2, syncWord.begin());
+    std::copy(softFrame.begin() + 16, softFrame.end(), data.begin());
+
+    decorrelateAndDeinterleave(data);
 
     auto type = getFrameType(syncWord);
 
@@ -65,6 +106,10 @@ M17FrameType M17FrameDecoder::decodeFrame(const frame_t& frame)
             decodeStream(data);
             break;
 
+        case M17FrameType::PACKET:
+            decodePacket(data);
+            break;
+
         default:
             break;
     }
@@ -97,6 +142,15 @@ M17FrameType M17FrameDecoder::getFrameType(const std::array< uint8_t, 2 >& syncW
         minDistance = hammDistance;
     }
 
+    // Packet frame
+    hammDistance = hammingDistance(syncWord[0], PACKET_SYNC_WORD[0])
+                 + hammingDistance(syncWord[1], PACKET_SYNC_WORD[1]);
+    if(hammDistance < minDistance)
+    {
+        type = M17FrameType::PACKET;
+        minDistance = hammDistance;
+    }
+
     // Check value of minimum hamming distance found, if exceeds the allowed
     // limit consider the frame as of unknown type.
     if(minDistance > MAX_SYNC_HAMM_DISTANCE)
@@ -113,37 +167,18 @@ void M17FrameDecoder::decodeLSF(const std::array< uint8_t, 46 >& data)
 
     viterbi.decodePunctured(data, tmp, LSF_PUNCTURE);
     memcpy(&lsf.data, tmp.data(), tmp.size());
+    checkLsf();
 }
 
 void M17FrameDecoder::decodeStream(const std::array< uint8_t, 46 >& data)
 {
-    // Extract and unpack the LICH segment contained at beginning of frame
+    // Extract and process the LICH segment contained at beginning of frame
     lich_t lich;
-    std::array < uint8_t, 6 > lsfSegment;
-
     std::copy_n(data.begin(), lich.size(), lich.begin());
-    bool decodeOk = decodeLich(lsfSegment, lich);
 
-    if(decodeOk)
-    {
-        // Append LICH segment
-        uint8_t segmentNum  = lsfSegment[5];
-        uint8_t segmentSize = lsfSegment.size() - 1;
-        uint8_t *ptr = reinterpret_cast < uint8_t * >(&lsfFromLich.data);
-        ptr += segmentNum * segmentSize;
-        memcpy(ptr, lsfSegment.data(), segmentSize);
-
-        // Mark this segment as present
-        lsfSegmentMap |= 1 << segmentNum;
-
-        // Check if we have received all the six LICH segments
-        if(lsfSegmentMap == 0x3F)
-        {
-            if(lsfFromLich.valid()) lsf = lsfFromLich;
-            lsfSegmentMap = 0;
-            lsfFromLich.clear();
-        }
-    }
+    std::array< uint8_t, 6 > lsfSegment;
+    if(decodeLich(lsfSegment, lich))
+        updateLich(lsfSegment);
 
     // Extract and decode stream data
     std::array< uint8_t, 34 > punctured;
@@ -155,32 +190,201 @@ void M17FrameDecoder::decodeStream(const std::array< uint8_t, 46 >& data)
 
     viterbi.decodePunctured(punctured, tmp, DATA_PUNCTURE);
     memcpy(&streamFrame.data, tmp.data(), tmp.size());
+    checkEndOfStream();
+}
+
+void M17FrameDecoder::decodeLSF(const std::array< uint16_t, 368 >& data)
+{
+    std::array< uint8_t, sizeof(M17LinkSetupFrame) > tmp;
+
+    softViterbi.decodePunctured(data, tmp, LSF_PUNCTURE);
+    memcpy(&lsf.data, tmp.data(), tmp.size());
+    checkLsf();
+}
+
+void M17FrameDecoder::decodeStream(const std::array< uint16_t, 368 >& data)
+{
+    // Extract and process the LICH segment contained at beginning of frame,
+    // Golay blocks are decoded using their soft bits.
+    std::array< uint8_t, 6 > lsfSegment;
+    if(decodeLich(lsfSegment, data.data()))
+        updateLich(lsfSegment);
+
+    // Extract and decode stream data
+    std::array< uint16_t, 272 > punctured;
+    std::array< uint8_t, sizeof(M17StreamFrame) > tmp;
+
+    auto begin = data.begin();
+    begin     += sizeof(lich_t) * 8;
+    std::copy(begin, data.end(), punctured.begin());
+
+    softViterbi.decodePunctured(punctured, tmp, DATA_PUNCTURE);
+    memcpy(&streamFrame.data, tmp.data(), tmp.size());
+    checkEndOfStream();
+}
+
+void M17FrameDecoder::decodePacket(const std::array< uint8_t, 46 >& data)
+{
+    std::array< uint8_t, sizeof(M17PacketFrame) > tmp;
+
+    viterbi.decodePunctured(data, tmp, PACKET_PUNCTURE);
+    unpackPacket(tmp);
+}
+
+void M17FrameDecoder::decodePacket(const std::array< uint16_t, 368 >& data)
+{
+    std::array< uint8_t, sizeof(M17PacketFrame) > tmp;
+
+    softViterbi.decodePunctured(data, tmp, PACKET_PUNCTURE);
+    unpackPacket(tmp);
+}
+
+void M17FrameDecoder::unpackPacket(const std::array< uint8_t, sizeof(M17PacketFrame) >& decoded)
+{
+    /*
+     * A packet frame carries 206 data bits followed by four flush bits. The
+     * Viterbi decoder output is aligned to the end of the data bits, which
+     * thus start from the third bit of the output: shift everything left by
+     * two bits to obtain the payload followed by the metadata field.
+     */
+    uint8_t *ptr = reinterpret_cast < uint8_t * >(&packetFrame.data);
+
+    for(size_t i = 0; i < decoded.size(); i++)
+    {
+        uint8_t next = ((i + 1) < decoded.size()) ? decoded[i + 1] : 0;
+        ptr[i] = (decoded[i] << 2) | (next >> 6);
+    }
+}
+
+void M17FrameDecoder::updateLich(const std::array< uint8_t, 6 >& lsfSegment)
+{
+    // Append LICH segment
+    uint8_t segmentNum  = lsfSegment[5];
+    uint8_t segmentSize = lsfSegment.size() - 1;
+    uint8_t *ptr = reinterpret_cast < uint8_t * >(&lsfFromLich.data);
+    ptr += segmentNum * segmentSize;
+    memcpy(ptr, lsfSegment.data(), segmentSize);
+
+    // Mark this segment as present
+    lsfSegmentMap |= 1 << segmentNum;
+
+    // Check if we have received all the six LICH segments
+    if(lsfSegmentMap == 0x3F)
+    {
+        if(lsfFromLich.valid())
+        {
+            lsf = lsfFromLich;
+            checkLsf();
+        }
+
+        lsfSegmentMap = 0;
+        lsfFromLich.clear();
+    }
+}
+
+void M17FrameDecoder::checkLsf()
+{
+    if(lsf.valid() == false)
+        return;
+
+    // A packet mode LSF announces a new packet and does not start a stream
+    streamType_t type = lsf.getType();
+    bool packet = (type.fields.dataMode == M17_DATAMODE_PACKET);
+
+    // Same LSF of the current stream, nothing to do
+    if(inStream && (packet == false) &&
+       (memcmp(&lsf.data, &streamLsf.data, sizeof(lsf.data)) == 0))
+        return;
+
+    if(packet)
+    {
+        event    = M17RxEvent::PACKET_START;
+        inStream = false;
+    }
+    else
+    {
+        event    = inStream ? M17RxEvent::LSF_CHANGED : M17RxEvent::STREAM_START;
+        inStream = true;
+    }
+
+    streamLsf       = lsf;
+    streamInfo.type = type;
+    decode_callsign(lsf.data.dst, streamInfo.dst);
+    decode_callsign(lsf.data.src, streamInfo.src);
+
+    streamInfo.extended = (streamInfo.type.fields.encType    == M17_ENCRYPTION_NONE) &&
+                          (streamInfo.type.fields.encSubType == M17_META_EXTD_CALLSIGN);
+    if(streamInfo.extended)
+    {
+        const meta_t& meta = lsf.data.meta;
+        decode_callsign(meta.extended_call_sign.call1, streamInfo.extCall1);
+        decode_callsign(meta.extended_call_sign.call2, streamInfo.extCall2);
+    }
+    else
+    {
+        streamInfo.extCall1[0] = '\0';
+        streamInfo.extCall2[0] = '\0';
+    }
+}
+
+void M17FrameDecoder::checkEndOfStream()
+{
+    if(inStream && streamFrame.isLastFrame())
+    {
+        event    = M17RxEvent::STREAM_END;
+        inStream = false;
+    }
 }
 
 bool M17FrameDecoder::decodeLich(std::array < uint8_t, 6 >& segment,
                             const lich_t& lich)
 {
     /*
-     * Extract and unpack the LICH segment contained in the frame header.
+     * NOTE: LICH data is stored in big-endian format, swap and shift after
+     * memcpy convert it to little-endian.
+     */
+    std::array< uint16_t, 4 > blocks;
+    uint32_t block = 0;
+
+    for(size_t i = 0; i < 4; i++)
+    {
+        memcpy(&block, lich.data() + 3*i, 3);
+        block     = __builtin_bswap32(block) >> 8;
+        blocks[i] = golay24_decode(block);
+    }
+
+    return unpackLich(segment, blocks);
+}
+
+bool M17FrameDecoder::decodeLich(std::array < uint8_t, 6 >& segment,
+                                 const uint16_t *softLich)
+{
+    std::array< uint16_t, 4 > blocks;
+
+    for(size_t i = 0; i < 4; i++)
+        blocks[i] = Golay24::softDecode(softLich + 24*i);
+
+    return unpackLich(segment, blocks);
+}
+
+bool M17FrameDecoder::unpackLich(std::array < uint8_t, 6 >& segment,
+                                 const std::array< uint16_t, 4 >& blocks)
+{
+    /*
+     * Unpack the LICH segment contained in the frame header.
      * The LICH segment is composed of four blocks of Golay(24,12) encoded data
      * and carries five bytes of the original Link Setup Frame. The sixth byte
      * is the segment number, allowing to determine the correct position of the
      * segment when reassembling the LSF.
-     *
-     * NOTE: LICH data is stored in big-endian format, swap and shift after
-     * memcpy convert it to little-endian.
      */
 
     segment.fill(0x00);
 
-    size_t   index = 0;
-    uint32_t block = 0;
+    size_t index = 0;
 
     for(size_t i = 0; i < 4; i++)
     {
-        memcpy(&block, lich.data() + 3*i, 3);
-        block = __builtin_bswap32(block) >> 8;
-        uint16_t decoded = golay24_decode(block);
+        uint16_t decoded = blocks[i];
 
         // Unrecoverable error, abort decoding
         if(decoded == 0xFFFF)
@@ -68,8 +68,7 @@ void M17FrameEncoder::encodeLsf(M17LinkSetupFrame& lsf, frame_t& output)
 
     std::array<uint8_t, 46> punctured;
     puncture(encoded, punctured, LSF_PUNCTURE);
-    interleave(punctured);
-    decorrelate(punctured);
+    interleaveAndDecorrelate(punctured);
 
     // Copy data to output buffer, prepended with sync word.
     auto it = std::copy(LSF_SYNC_WORD.begin(), LSF_SYNC_WORD.end(),
@@ -106,8 +105,7 @@ uint16_t M17FrameEncoder::encodeStreamFrame(const payload_t& payload,
     // Increment LICH counter after copy
     currentLich = (currentLich + 1) % lichSegments.size();
 
-    interleave(frame);
-    decorrelate(frame);
+    interleaveAndDecorrelate(frame);
 
     // Copy data to output buffer, prepended with sync word.
     auto oIt = std::copy(STREAM_SYNC_WORD.begin(), STREAM_SYNC_WORD.end(),
@@ -117,6 +115,27 @@ uint16_t M17FrameEncoder::encodeStreamFrame(const payload_t& payload,
     return streamFrame.getFrameNumber();
 }
 
+void M17FrameEncoder::encodePacketFrame(const M17PacketFrame& packetFrame,
+                                        frame_t& output)
+{
+    // Encode frame: the 206 data bits are followed by the two zero padding
+    // bits of the metadata byte and then by the flush bits, giving the 210 bits
+    // expected by the protocol specification.
+    std::array<uint8_t, 53> encoded;
+    encoder.reset();
+    encoder.encode(packetFrame.getData(), encoded.data(), sizeof(M17PacketFrame));
+    encoded[52] = encoder.flush();
+
+    std::array<uint8_t, 46> frame;
+    puncture(encoded, frame, PACKET_PUNCTURE);
+    interleaveAndDecorrelate(frame);
+
+    // Copy data to output buffer, prepended with sync word.
+    auto it = std::copy(PACKET_SYNC_WORD.begin(), PACKET_SYNC_WORD.end(),
+                        output.begin());
+    std::copy(frame.begin(), frame.end(), it);
+}
+
 void M17::M17FrameEncoder::encodeEotFrame(M17::frame_t& output)
 {
     for(size_t i = 0; i < output.size(); i += 2)
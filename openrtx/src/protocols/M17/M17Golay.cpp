@@ -33,87 +33,212 @@ static constexpr uint16_t encode_matrix[12] =
     0xd99, 0x3da, 0x7b4, 0xf68, 0x63b, 0xc75
 };
 
-
 /*
- * Data decoding matrix for Golay(24,12) code with generator polynomial 0xC75
+ * The checksum is linear in the data bits, thus it can be computed combining
+ * the checksums of the lower and upper six bits, each taken from a table of
+ * 64 entries. The syndrome of a received codeword is used as index of a table
+ * containing the error pattern of minimum weight having that syndrome. Error
+ * patterns of more than three bits cannot be corrected and are marked as
+ * invalid.
+ *
+ * Flash constrained targets can select a compact syndrome table, storing for
+ * each entry the positions of the bit errors in five bits each instead of
+ * the full error pattern.
  */
-static constexpr uint16_t decode_matrix[12] =
-{
-    0xc75, 0x49f, 0x93e, 0x6e3, 0xdc6, 0xf13,
-    0xab9, 0x1ed, 0x3da, 0x7b4, 0xf68, 0xa4f
-};
 
-
-uint16_t Golay24::calcChecksum(const uint16_t& value)
+struct ChecksumTable
 {
-    uint16_t checksum = 0;
+    uint16_t low[64];
+    uint16_t high[64];
 
-    for(uint8_t i = 0; i < 12; i++)
+    constexpr ChecksumTable() : low(), high()
     {
-        if(value & (1 << i))
+        for(uint8_t i = 0; i < 64; i++)
         {
-            checksum ^= encode_matrix[i];
+            for(uint8_t j = 0; j < 6; j++)
+            {
+                if(i & (1 << j))
+                {
+                    low[i]  ^= encode_matrix[j];
+                    high[i] ^= encode_matrix[j + 6];
+                }
+            }
         }
     }
+};
 
-    return checksum;
+static constexpr ChecksumTable checksumTable;
+
+static constexpr uint16_t checksum(const uint16_t value)
+{
+    return checksumTable.low[value & 0x3F]
+         ^ checksumTable.high[(value >> 6) & 0x3F];
 }
 
+#ifndef CONFIG_M17_GOLAY_COMPACT
 
-/**
- * Detect and correct errors in a Golay(24,12) codeword.
- *
- * @param codeword: input codeword.
- * @return bitmask corresponding to detected bit errors in the codeword, or
- * 0xFFFFFFFF if bit errors are unrecoverable.
+using syndromeEntry_t = uint32_t;
+static constexpr syndromeEntry_t INVALID_ENTRY = 0xFFFFFFFF;
+
+#else
+
+/*
+ * Compact entry: three positions of five bits each, position 24 marks an
+ * unused slot. An all-ones entry marks an uncorrectable syndrome.
  */
-uint32_t Golay24::detectErrors(const uint32_t& codeword)
-{
-    uint16_t data   = codeword >> 12;
-    uint16_t parity = codeword & 0xFFF;
+using syndromeEntry_t = uint16_t;
+static constexpr syndromeEntry_t INVALID_ENTRY = 0xFFFF;
 
-    uint16_t syndrome = parity ^ calcChecksum(data);
+#endif
 
-    if(__builtin_popcount(syndrome) <= 3)
-    {
-        return syndrome;
-    }
+struct SyndromeTable
+{
+    syndromeEntry_t entries[4096];
 
-    for(uint8_t i = 0; i<12; i++)
+    constexpr SyndromeTable() : entries()
     {
-        uint16_t e = 1 << i;
-        uint16_t coded_error = encode_matrix[i];
+        for(uint16_t i = 0; i < 4096; i++)
+            entries[i] = INVALID_ENTRY;
 
-        if(__builtin_popcount(syndrome^coded_error) <= 2)
+        // Enumerate all the error patterns of up to three bits. Position 24 is
+        // a placeholder for "no error" allowing to cover also lower weights.
+        for(uint8_t a = 0; a <= 24; a++)
         {
-            return (e << 12) | (syndrome ^ coded_error);
+            for(uint8_t b = a; b <= 24; b++)
+            {
+                for(uint8_t c = b; c <= 24; c++)
+                {
+                    // Skip repeated positions, apart from the placeholder
+                    if(((a == b) && (a != 24)) || ((b == c) && (b != 24)))
+                        continue;
+
+                    uint32_t error = bit(a) | bit(b) | bit(c);
+                    uint16_t syndrome = (error & 0xFFF)
+                                      ^ checksum((error >> 12) & 0xFFF);
+
+                    #ifndef CONFIG_M17_GOLAY_COMPACT
+                    entries[syndrome] = error;
+                    #else
+                    entries[syndrome] = (a << 10) | (b << 5) | c;
+                    #endif
+                }
+            }
         }
     }
 
+    static constexpr uint32_t bit(const uint8_t pos)
+    {
+        return (pos < 24) ? (1UL << pos) : 0;
+    }
+};
+
+static constexpr SyndromeTable syndromeTable;
 
-    uint16_t inv_syndrome = 0;
-    for(uint8_t i = 0; i < 12; i++)
+
+uint16_t Golay24::calcChecksum(const uint16_t& value)
+{
+    return checksum(value);
+}
+
+uint32_t Golay24::detectErrors(const uint32_t& codeword)
+{
+    uint16_t data     = (codeword >> 12) & 0xFFF;
+    uint16_t parity   = codeword & 0xFFF;
+    uint16_t syndrome = parity ^ checksum(data);
+
+    syndromeEntry_t entry = syndromeTable.entries[syndrome];
+
+    #ifndef CONFIG_M17_GOLAY_COMPACT
+    return entry;
+    #else
+    if(entry == INVALID_ENTRY)
+        return 0xFFFFFFFF;
+
+    return SyndromeTable::bit((entry >> 10) & 0x1F)
+         | SyndromeTable::bit((entry >> 5)  & 0x1F)
+         | SyndromeTable::bit(entry & 0x1F);
+    #endif
+}
+
+uint16_t Golay24::softDecode(const uint16_t *softBits)
+{
+    // Hard decisions and reliability of each bit, the first soft bit is the
+    // most significant one of the codeword.
+    uint32_t hard = 0;
+    uint16_t reliability[24];
+
+    for(uint8_t i = 0; i < 24; i++)
     {
-        if(syndrome & (1 << i))
+        uint16_t value = softBits[i];
+        uint8_t  pos   = 23 - i;
+
+        if(value > 0x7FFF)
         {
-            inv_syndrome ^= decode_matrix[i];
+            hard |= (1UL << pos);
+            reliability[pos] = value - 0x7FFF;
+        }
+        else
+        {
+            reliability[pos] = 0x7FFF - value;
         }
     }
 
-    if(__builtin_popcount(inv_syndrome) <= 3)
+    // Find the least reliable bits
+    uint8_t weakest[CHASE_BITS];
+    for(uint8_t i = 0; i < CHASE_BITS; i++)
     {
-        return inv_syndrome << 12;
+        weakest[i] = 24;
+        for(uint8_t pos = 0; pos < 24; pos++)
+        {
+            bool taken = false;
+            for(uint8_t j = 0; j < i; j++)
+                taken |= (weakest[j] == pos);
+
+            if(taken)
+                continue;
+
+            if((weakest[i] == 24) || (reliability[pos] < reliability[weakest[i]]))
+                weakest[i] = pos;
+        }
     }
 
-    for(uint8_t i = 0; i < 12; i++ )
+    // Hard decode all the test patterns obtained by flipping the least
+    // reliable bits, keeping the candidate codeword closest to the received
+    // soft bits.
+    uint32_t best       = 0xFFFFFFFF;
+    uint32_t bestMetric = 0xFFFFFFFF;
+
+    for(uint8_t pattern = 0; pattern < (1 << CHASE_BITS); pattern++)
     {
-        uint16_t e = 1 << i;
-        uint16_t coding_error = decode_matrix[i];
-        if(__builtin_popcount(inv_syndrome ^ coding_error) <= 2 )
+        uint32_t test = hard;
+        for(uint8_t i = 0; i < CHASE_BITS; i++)
+        {
+            if(pattern & (1 << i))
+                test ^= (1UL << weakest[i]);
+        }
+
+        uint32_t errors = detectErrors(test);
+        if(errors == 0xFFFFFFFF)
+            continue;
+
+        uint32_t candidate = test ^ errors;
+        uint32_t diff      = candidate ^ hard;
+        uint32_t metric    = 0;
+        for(uint8_t pos = 0; pos < 24; pos++)
+        {
+            if(diff & (1UL << pos))
+                metric += reliability[pos];
+        }
+
+        if(metric < bestMetric)
         {
-            return ((inv_syndrome ^ coding_error) << 12) | e;
+            best       = candidate;
+            bestMetric = metric;
         }
     }
 
-    return 0xFFFFFFFF;
+    if(best == 0xFFFFFFFF)
+        return 0xFFFF;
+
+    return (best >> 12) & 0x0FFF;
 }
@@ -24,6 +24,7 @@
 #include <M17/M17Modulator.hpp>
 #include <M17/M17Utils.hpp>
 #include <M17/M17DSP.hpp>
+#include <thread_stats.h>
 
 #if defined(PLATFORM_LINUX)
 #include <stdio.h>
@@ -52,6 +53,7 @@ void M17Modulator::init()
     baseband_buffer = std::make_unique< int16_t[] >(2 * M17_FRAME_SAMPLES);
     idleBuffer      = baseband_buffer.get();
     txRunning       = false;
+    rrc.reset();
     #if defined(PLATFORM_MD3x0) || defined(PLATFORM_MDUV3x0)
     pwmComp.reset();
     #endif
@@ -153,23 +155,18 @@ void M17Modulator::invertPhase(const bool status)
 
 void M17Modulator::symbolsToBaseband()
 {
-    memset(idleBuffer, 0x00, M17_FRAME_SAMPLES * sizeof(stream_sample_t));
-
-    for(size_t i = 0; i < symbols.size(); i++)
-    {
-        idleBuffer[i * 10] = symbols[i];
-    }
+    // Upsample and filter the whole frame in a single pass, signal phase
+    // inversion is done through the filter gain.
+    const float gain = invPhase ? -M17_RRC_GAIN : M17_RRC_GAIN;
+    rrc.process(symbols.data(), idleBuffer, symbols.size(), gain);
 
+    #if defined(PLATFORM_MD3x0) || defined(PLATFORM_MDUV3x0)
     for(size_t i = 0; i < M17_FRAME_SAMPLES; i++)
     {
         float elem    = static_cast< float >(idleBuffer[i]);
-        elem          = M17::rrc_48k(elem * M17_RRC_GAIN) - M17_RRC_OFFSET;
-        #if defined(PLATFORM_MD3x0) || defined(PLATFORM_MDUV3x0)
-        elem          = pwmComp(elem);
-        #endif
-        if(invPhase) elem = 0.0f - elem;    // Invert signal phase
-        idleBuffer[i] = static_cast< int16_t >(elem);
+        idleBuffer[i] = static_cast< int16_t >(pwmComp(elem));
     }
+    #endif
 }
 
 #ifndef PLATFORM_LINUX
@@ -178,8 +175,11 @@ void M17Modulator::sendBaseband()
     if(txRunning == false) return;
     if(audioPath_getStatus(outPath) != PATH_OPEN) return;
 
-    // Transmission is ongoing, syncronise with stream end before proceeding
+    // Transmission is ongoing, syncronise with stream end before proceeding.
+    // Waiting for the output stream is not part of the RTX thread activity.
+    threadStats_pause(LOOP_RTX);
     outputStream_sync(outStream, true);
+    threadStats_resume(LOOP_RTX);
     idleBuffer = outputStream_getIdleBuffer(outStream);
 }
 #else
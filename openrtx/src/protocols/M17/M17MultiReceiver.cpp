@@ -0,0 +1,204 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <M17/M17MultiReceiver.hpp>
+#include <sched.h>
+#include <errno.h>
+
+using namespace M17;
+
+M17MultiReceiver::M17MultiReceiver(const size_t numWorkers,
+                                   const bool softDecoding) :
+    numWorkers(numWorkers > 0 ? numWorkers : 1), softDecoding(softDecoding),
+    running(false), stopRequest(false), activeWorkers(0)
+{
+
+}
+
+M17MultiReceiver::~M17MultiReceiver()
+{
+    stop();
+
+    for(auto& ch : channels)
+    {
+        ch->demodulator.terminate();
+        fclose(ch->source);
+    }
+}
+
+int M17MultiReceiver::addChannel(const char *path, const bool invertPhase)
+{
+    if(running)
+        return -EBUSY;
+
+    if(channels.size() >= UINT8_MAX)
+        return -ENOSPC;
+
+    FILE *fp = fopen(path, "rb");
+    if(fp == NULL)
+        return -ENOENT;
+
+    std::unique_ptr< Channel > ch(new Channel());
+    ch->source      = fp;
+    ch->invertPhase = invertPhase;
+    ch->locked      = false;
+    ch->done        = false;
+    ch->demodulator.init();
+    ch->decoder.reset();
+
+    channels.push_back(std::move(ch));
+
+    return channels.size() - 1;
+}
+
+bool M17MultiReceiver::start()
+{
+    if(running)
+        return true;
+
+    stopRequest   = false;
+    activeWorkers = numWorkers;
+    workers.resize(numWorkers);
+
+    for(size_t i = 0; i < numWorkers; i++)
+    {
+        workers[i].rx    = this;
+        workers[i].index = i;
+
+        if(pthread_create(&workers[i].thread, NULL, workerFunc, &workers[i]) != 0)
+        {
+            // Stop the threads started so far
+            activeWorkers -= (numWorkers - i);
+            workers.resize(i);
+            running = true;
+            stop();
+            return false;
+        }
+    }
+
+    running = true;
+    return true;
+}
+
+void M17MultiReceiver::stop()
+{
+    if(running == false)
+        return;
+
+    stopRequest = true;
+
+    for(auto& w : workers)
+        pthread_join(w.thread, NULL);
+
+    workers.clear();
+    running = false;
+}
+
+bool M17MultiReceiver::isRunning()
+{
+    return activeWorkers.load() > 0;
+}
+
+bool M17MultiReceiver::getFrame(M17RxFrame& frame)
+{
+    return outQueue.pop(frame);
+}
+
+void *M17MultiReceiver::workerFunc(void *arg)
+{
+    WorkerCtx *ctx = reinterpret_cast< WorkerCtx * >(arg);
+    ctx->rx->work(ctx->index);
+
+    return NULL;
+}
+
+void M17MultiReceiver::work(const size_t worker)
+{
+    bool pending = true;
+
+    // Round-robin over the channels assigned to this worker, one block of
+    // samples each, until all of them are exhausted.
+    while(pending && (stopRequest == false))
+    {
+        pending = false;
+
+        for(size_t i = worker; i < channels.size(); i += numWorkers)
+        {
+            if(channels[i]->done)
+                continue;
+
+            if(processChannel(i))
+                pending = true;
+            else
+                channels[i]->done = true;
+        }
+    }
+
+    activeWorkers -= 1;
+}
+
+bool M17MultiReceiver::processChannel(const size_t index)
+{
+    Channel& ch = *channels[index];
+
+    size_t len = fread(ch.samples, sizeof(int16_t), 960, ch.source);
+    if(len == 0)
+        return false;
+
+    bool newFrame = ch.demodulator.update(ch.samples, len, ch.invertPhase);
+    bool lock     = ch.demodulator.isLocked();
+
+    // Reset frame decoder when transitioning from unlocked to locked state.
+    if((lock == true) && (ch.locked == false))
+        ch.decoder.reset();
+
+    ch.locked = lock;
+
+    if((lock == false) || (newFrame == false))
+        return true;
+
+    M17FrameType type;
+    const frame_t& frame = ch.demodulator.getFrame();
+
+    if(softDecoding)
+        type = ch.decoder.decodeFrame(frame, ch.demodulator.getSoftFrame());
+    else
+        type = ch.decoder.decodeFrame(frame);
+
+    if((type != M17FrameType::LINK_SETUP) && (type != M17FrameType::STREAM))
+        return true;
+
+    M17RxFrame rxFrame;
+    rxFrame.channel     = index;
+    rxFrame.type        = type;
+    rxFrame.lsf         = ch.decoder.getLsf();
+    rxFrame.streamFrame = ch.decoder.getStreamFrame();
+
+    // Do not lose frames when the consumer is slow, wait for a free slot.
+    while(outQueue.push(rxFrame) == false)
+    {
+        if(stopRequest)
+            break;
+
+        sched_yield();
+    }
+
+    return true;
+}
@@ -0,0 +1,139 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <cstring>
+#include <M17/M17Packet.hpp>
+#include <crc.h>
+
+using namespace M17;
+
+M17Packet::M17Packet() : buffer(nullptr), length(0), nextFrame(0),
+                         status(M17PacketStatus::ERROR)
+{
+
+}
+
+M17Packet::~M17Packet()
+{
+
+}
+
+bool M17Packet::load(uint8_t *packet, const size_t size)
+{
+    buffer = packet;
+    length = 0;
+
+    if((size == 0) || (size > M17_PACKET_MAX_SIZE))
+        return false;
+
+    // CRC is appended in big-endian format
+    uint16_t crc     = crc_m17(buffer, size);
+    buffer[size]     = crc >> 8;
+    buffer[size + 1] = crc & 0xFF;
+    length           = size + 2;
+
+    return true;
+}
+
+size_t M17Packet::numFrames() const
+{
+    return (length + M17_PACKET_FRAME_BYTES - 1) / M17_PACKET_FRAME_BYTES;
+}
+
+void M17Packet::getFrame(const size_t index, M17PacketFrame& frame) const
+{
+    size_t offset = index * M17_PACKET_FRAME_BYTES;
+    size_t count  = length - offset;
+
+    frame.clear();
+
+    if(count > M17_PACKET_FRAME_BYTES)
+    {
+        count = M17_PACKET_FRAME_BYTES;
+        frame.setFrameNumber(index);
+    }
+    else
+    {
+        frame.lastFrame(count);
+    }
+
+    memcpy(frame.payload().data(), buffer + offset, count);
+}
+
+void M17Packet::reset(uint8_t *packet)
+{
+    buffer       = packet;
+    length       = 0;
+    nextFrame    = 0;
+    status       = M17PacketStatus::INCOMPLETE;
+}
+
+M17PacketStatus M17Packet::append(const M17PacketFrame& frame)
+{
+    if(status != M17PacketStatus::INCOMPLETE)
+        return status;
+
+    size_t count = M17_PACKET_FRAME_BYTES;
+
+    if(frame.isLastFrame())
+    {
+        count = frame.getCounter();
+        if((count == 0) || (count > M17_PACKET_FRAME_BYTES))
+            count = 0;
+    }
+    else if((frame.getCounter() != nextFrame) ||
+            (nextFrame >= (M17_PACKET_MAX_FRAMES - 1)))
+    {
+        // Lost frame or too many frames
+        count = 0;
+    }
+
+    if(count == 0)
+    {
+        status = M17PacketStatus::ERROR;
+        return status;
+    }
+
+    memcpy(buffer + length, frame.payload().data(), count);
+    length    += count;
+    nextFrame += 1;
+
+    if(frame.isLastFrame() == false)
+        return status;
+
+    // Packet complete: at least the protocol type and the CRC are required
+    status = M17PacketStatus::ERROR;
+    if(length >= 3)
+    {
+        uint16_t crc = (buffer[length - 2] << 8) | buffer[length - 1];
+        if(crc_m17(buffer, length - 2) == crc)
+            status = M17PacketStatus::COMPLETE;
+    }
+
+    return status;
+}
+
+size_t M17Packet::size() const
+{
+    if(length < 2)
+        return 0;
+
+    return length - 2;
+}
@@ -22,6 +22,7 @@
 #include <interfaces/delays.h>
 #include <interfaces/radio.h>
 #include <OpMode_FM.hpp>
+#include <thread_stats.h>
 #include <rtx.h>
 
 #if defined(PLATFORM_TTWRPLUS)
@@ -84,6 +85,8 @@ void OpMode_FM::update(rtxStatus_t *const status, const bool newCfg)
 {
     (void) newCfg;
 
+    threadStats_begin(LOOP_RTX);
+
     #if defined(PLATFORM_TTWRPLUS)
     // Set output volume by changing the HR_C6000 DAC gain
     _setVolume();
@@ -184,6 +187,8 @@ void OpMode_FM::update(rtxStatus_t *const status, const bool newCfg)
             break;
     }
 
+    threadStats_end(LOOP_RTX);
+
     // Sleep thread for 30ms for 33Hz update rate
     sleepFor(0u, 30u);
 }
@@ -25,6 +25,7 @@
 #include <M17/M17Callsign.hpp>
 #include <OpMode_M17.hpp>
 #include <audio_codec.h>
+#include <thread_stats.h>
 #include <errno.h>
 #include <rtx.h>
 
@@ -38,9 +39,17 @@ extern mod17Calib_t mod17CalData;
 using namespace std;
 using namespace M17;
 
+static_assert(M17PKT_MAX_SIZE == M17_PACKET_MAX_SIZE, "Packet size mismatch");
+static_assert(M17PKT_BUF_SIZE == M17_PACKET_BUF_SIZE, "Packet size mismatch");
+
+// Time the channel has to be free before transmitting a queued packet, in ms
+static constexpr long long PACKET_TX_HOLDOFF = 500;
+
 OpMode_M17::OpMode_M17() : startRx(false), startTx(false), locked(false),
-                           dataValid(false), extendedCall(false),
-                           invertTxPhase(false), invertRxPhase(false)
+                           dataValid(false), callMatch(false),
+                           invertTxPhase(false), invertRxPhase(false),
+                           rxSlot(NULL), txSlot(NULL), txFrame(0),
+                           lastBusy(0)
 {
 
 }
@@ -57,9 +66,13 @@ void OpMode_M17::enable()
     demodulator.init();
     locked       = false;
     dataValid    = false;
-    extendedCall = false;
+    callMatch    = false;
     startRx      = true;
     startTx      = false;
+    rxSlot       = NULL;
+    txSlot       = NULL;
+    txFrame      = 0;
+    lastBusy     = 0;
 }
 
 void OpMode_M17::disable()
@@ -74,11 +87,25 @@ void OpMode_M17::disable()
     radio_disableRtx();
     modulator.terminate();
     demodulator.terminate();
+
+    if(rxSlot != NULL)
+        m17Packet_release(rxSlot);
+
+    if(txSlot != NULL)
+        m17Packet_release(txSlot);
+
+    rxSlot = NULL;
+    txSlot = NULL;
 }
 
 void OpMode_M17::update(rtxStatus_t *const status, const bool newCfg)
 {
-    (void) newCfg;
+    threadStats_begin(LOOP_RTX);
+
+    // Local callsign or CAN may have changed while receiving a stream
+    if(newCfg && decoder.streamActive())
+        updateCallMatch(status);
+
     #if defined(PLATFORM_MD3x0) || defined(PLATFORM_MDUV3x0)
     //
     // Invert TX phase for all MDx models.
@@ -115,7 +142,10 @@ void OpMode_M17::update(rtxStatus_t *const status, const bool newCfg)
             break;
 
         case TX:
-            txState(status);
+            if(txSlot != NULL)
+                txPacketState(status);
+            else
+                txState(status);
             break;
 
         default:
@@ -143,6 +173,8 @@ void OpMode_M17::update(rtxStatus_t *const status, const bool newCfg)
             platform_ledOff(RED);
             break;
     }
+
+    threadStats_end(LOOP_RTX);
 }
 
 void OpMode_M17::offState(rtxStatus_t *const status)
@@ -165,9 +197,23 @@ void OpMode_M17::offState(rtxStatus_t *const status)
         return;
     }
 
+    // Transmit the packet waiting to be sent, if any
+    if(m17Packet_txPending() && (status->txDisable == 0))
+    {
+        txSlot = m17Packet_getTx();
+        if(txSlot != NULL)
+        {
+            startTx = true;
+            status->opStatus = TX;
+            return;
+        }
+    }
+
     // Sleep for 30ms if there is nothing else to do in order to prevent the
     // rtx thread looping endlessly and locking up all the other tasks
+    threadStats_pause(LOOP_RTX);
     sleepFor(0, 30);
+    threadStats_resume(LOOP_RTX);
 }
 
 void OpMode_M17::rxState(rtxStatus_t *const status)
@@ -178,7 +224,8 @@ void OpMode_M17::rxState(rtxStatus_t *const status)
 
         radio_enableRx();
 
-        startRx = false;
+        startRx  = false;
+        lastBusy = getTick();
     }
 
     bool newData = demodulator.update(invertRxPhase);
@@ -197,64 +244,66 @@ void OpMode_M17::rxState(rtxStatus_t *const status)
         if(newData)
         {
             auto& frame   = demodulator.getFrame();
-            auto  type    = decoder.decodeFrame(frame);
-            auto  lsf     = decoder.getLsf();
-            status->lsfOk = lsf.valid();
+            auto  type    = M17FrameType::UNKNOWN;
 
-            if(status->lsfOk)
-            {
-                dataValid = true;
+            if(status->softDec)
+                type = decoder.decodeFrame(frame, demodulator.getSoftFrame());
+            else
+                type = decoder.decodeFrame(frame);
 
-                // Retrieve stream source and destination data
-                std::string dst = lsf.getDestination();
-                std::string src = lsf.getSource();
+            // Decode the stream information only when the LSF changes
+            M17RxEvent event = decoder.getEvent();
+            if((event == M17RxEvent::STREAM_START) ||
+               (event == M17RxEvent::LSF_CHANGED))
+            {
+                updateStreamInfo(status);
+            }
 
-                // Retrieve extended callsign data
-                streamType_t streamType = lsf.getType();
+            // As with any valid LSF, the stream information stays valid until
+            // lock is lost, also after the end of the stream. Packets carry no
+            // audio and do not open the audio path.
+            if((event == M17RxEvent::STREAM_START) ||
+               (event == M17RxEvent::LSF_CHANGED))
+            {
+                status->lsfOk = true;
+                dataValid     = true;
+            }
 
-                if((streamType.fields.encType    == M17_ENCRYPTION_NONE) &&
-                   (streamType.fields.encSubType == M17_META_EXTD_CALLSIGN))
-                {
-                    extendedCall = true;
-
-                    meta_t& meta = lsf.metadata();
-                    std::string exCall1 = decode_callsign(meta.extended_call_sign.call1);
-                    std::string exCall2 = decode_callsign(meta.extended_call_sign.call2);
-
-                    //
-                    // The source callsign only contains the last link when
-                    // receiving extended callsign data: in order to always store
-                    // the true source of a transmission, we need to store the first
-                    // extended callsign in M17_src.
-                    //
-                    strncpy(status->M17_src,  exCall1.c_str(), 10);
-                    strncpy(status->M17_refl, exCall2.c_str(), 10);
-
-                    extendedCall = true;
-                }
+            if(event == M17RxEvent::PACKET_START)
+                status->lsfOk = true;
 
-                // Set source and destination fields.
-                // If we have received an extended callsign the src will be the RF link address
-                // The M17_src will already be stored from the extended callsign
-                strncpy(status->M17_dst, dst.c_str(), 10);
+            // A new packet starts, reassemble it directly in a free slot
+            if(event == M17RxEvent::PACKET_START)
+            {
+                updateStreamInfo(status);
 
-                if(extendedCall)
-                    strncpy(status->M17_link, src.c_str(), 10);
-                else
-                    strncpy(status->M17_src, src.c_str(), 10);
+                if(rxSlot == NULL)
+                    rxSlot = m17Packet_allocRx();
 
-                // Check CAN on RX, if enabled.
-                // If check is disabled, force match to true.
-                bool canMatch =  (streamType.fields.CAN == status->can)
-                              || (status->canRxEn == false);
+                if(rxSlot != NULL)
+                {
+                    rxPacket.reset(rxSlot->data);
+                    strncpy(rxSlot->src, status->M17_src, sizeof(rxSlot->src));
+                    strncpy(rxSlot->dst, status->M17_dst, sizeof(rxSlot->dst));
+                }
+            }
 
-                // Check if the destination callsign of the incoming transmission
-                // matches with ours
-                bool callMatch = compareCallsigns(std::string(status->source_address), dst);
+            if((type == M17FrameType::PACKET) && (rxSlot != NULL))
+            {
+                auto pktStatus = rxPacket.append(decoder.getPacketFrame());
+                if((pktStatus == M17PacketStatus::COMPLETE) && callMatch)
+                {
+                    rxSlot->size = rxPacket.size();
+                    m17Packet_publishRx(rxSlot);
+                    rxSlot = NULL;
+                }
+            }
 
+            if(dataValid)
+            {
                 // Open audio path only if CAN and callsign match
                 uint8_t pthSts = audioPath_getStatus(rxAudioPath);
-                if((pthSts == PATH_CLOSED) && (canMatch == true) && (callMatch == true))
+                if((pthSts == PATH_CLOSED) && (callMatch == true))
                 {
                     rxAudioPath = audioPath_request(SOURCE_MCU, SINK_SPK, PRIO_RX);
                     pthSts = audioPath_getStatus(rxAudioPath);
@@ -265,19 +314,36 @@ void OpMode_M17::rxState(rtxStatus_t *const status)
                 {
                     // (re)start codec2 module if not already up
                     if(codec_running() == false)
-                        codec_startDecode(rxAudioPath);
+                        codec_startDecode(rxAudioPath, true);
 
                     M17StreamFrame sf = decoder.getStreamFrame();
                     codec_pushFrame(sf.payload().data(),     false);
                     codec_pushFrame(sf.payload().data() + 8, false);
                 }
+
+                // No more audio: do not conceal the frames after the last one
+                if(event == M17RxEvent::STREAM_END)
+                    codec_endStream();
             }
         }
     }
 
     locked = lock;
 
-    if(platform_getPttStatus())
+    // The channel is busy when an M17 signal or a carrier above the squelch
+    // level are received. With the squelch fully open only M17 signals count.
+    rssi_t squelch = -127 + (status->sqlLevel * 66) / 15;
+    bool   carrier = (status->sqlLevel > 0) && (rtx_getRssi() > squelch);
+    if(locked || carrier)
+        lastBusy = getTick();
+
+    // Switch to TX on PTT press or to send a packet, once the channel has been
+    // free for a while
+    bool chFree     = (getTick() - lastBusy) >= PACKET_TX_HOLDOFF;
+    bool sendPacket = chFree && m17Packet_txPending()
+                   && (status->txDisable == 0);
+
+    if(platform_getPttStatus() || sendPacket)
     {
         demodulator.stopBasebandSampling();
         locked = false;
@@ -289,12 +355,18 @@ void OpMode_M17::rxState(rtxStatus_t *const status)
     {
         status->lsfOk = false;
         dataValid     = false;
-        extendedCall  = false;
+        callMatch     = false;
         status->M17_link[0] = '\0';
         status->M17_refl[0] = '\0';
 
         codec_stop(rxAudioPath);
         audioPath_release(rxAudioPath);
+
+        if(rxSlot != NULL)
+        {
+            m17Packet_release(rxSlot);
+            rxSlot = NULL;
+        }
     }
 }
 
@@ -339,8 +411,10 @@ void OpMode_M17::txState(rtxStatus_t *const status)
     bool      lastFrame = false;
 
     // Wait until there are 16 bytes of compressed speech, then send them
+    threadStats_pause(LOOP_RTX);
     codec_popFrame(dataFrame.data(),     true);
     codec_popFrame(dataFrame.data() + 8, true);
+    threadStats_resume(LOOP_RTX);
 
     if(platform_getPttStatus() == false)
     {
@@ -360,25 +434,100 @@ void OpMode_M17::txState(rtxStatus_t *const status)
     }
 }
 
-bool OpMode_M17::compareCallsigns(const std::string& localCs,
-                                  const std::string& incomingCs)
+void OpMode_M17::txPacketState(rtxStatus_t *const status)
 {
-    if((incomingCs == "ALL") || (incomingCs == "INFO") || (incomingCs == "ECHO"))
-        return true;
+    frame_t m17Frame;
 
-    std::string truncatedLocal(localCs);
-    std::string truncatedIncoming(incomingCs);
+    if(startTx)
+    {
+        startTx = false;
+        txFrame = 0;
 
-    int slashPos = localCs.find_first_of('/');
-    if(slashPos <= 2)
-        truncatedLocal = localCs.substr(slashPos + 1);
+        std::string src(status->source_address);
+        std::string dst(txSlot->dst);
+        M17LinkSetupFrame lsf;
 
-    slashPos = incomingCs.find_first_of('/');
-    if(slashPos <= 2)
-        truncatedIncoming = incomingCs.substr(slashPos + 1);
+        lsf.clear();
+        lsf.setSource(src);
+        if(!dst.empty()) lsf.setDestination(dst);
+
+        streamType_t type;
+        type.fields.dataMode = M17_DATAMODE_PACKET;     // Packet
+        type.fields.dataType = M17_DATATYPE_DATA;       // Data
+        type.fields.CAN      = status->can;             // Channel access number
+
+        lsf.setType(type);
+        lsf.updateCrc();
+
+        // The packet CRC is appended in place, right after the packet content
+        txPacket.load(txSlot->data, txSlot->size);
+
+        encoder.reset();
+        encoder.encodeLsf(lsf, m17Frame);
+
+        radio_enableTx();
+
+        modulator.invertPhase(invertTxPhase);
+        modulator.start();
+        modulator.sendPreamble();
+        modulator.sendFrame(m17Frame);
+    }
+
+    M17PacketFrame packetFrame;
+    txPacket.getFrame(txFrame, packetFrame);
+    encoder.encodePacketFrame(packetFrame, m17Frame);
+    modulator.sendFrame(m17Frame);
+    txFrame += 1;
+
+    if(txFrame >= txPacket.numFrames())
+    {
+        encoder.encodeEotFrame(m17Frame);
+        modulator.sendFrame(m17Frame);
+        modulator.stop();
+
+        m17Packet_release(txSlot);
+        txSlot  = NULL;
+        startRx = true;
+        status->opStatus = OFF;
+    }
+}
+
+void OpMode_M17::updateStreamInfo(rtxStatus_t *const status)
+{
+    const M17StreamInfo& info = decoder.getStreamInfo();
+
+    // Set source and destination fields.
+    // When receiving extended callsign data, the source callsign only contains
+    // the last link: in order to always store the true source of a
+    // transmission, the first extended callsign is stored in M17_src.
+    strncpy(status->M17_dst, info.dst, 10);
+
+    if(info.extended)
+    {
+        strncpy(status->M17_src,  info.extCall1, 10);
+        strncpy(status->M17_refl, info.extCall2, 10);
+        strncpy(status->M17_link, info.src,      10);
+    }
+    else
+    {
+        strncpy(status->M17_src, info.src, 10);
+        status->M17_link[0] = '\0';
+        status->M17_refl[0] = '\0';
+    }
+
+    updateCallMatch(status);
+}
+
+void OpMode_M17::updateCallMatch(const rtxStatus_t *const status)
+{
+    const M17StreamInfo& info = decoder.getStreamInfo();
 
-    if(truncatedLocal == truncatedIncoming)
-        return true;
+    // Check CAN on RX, if enabled.
+    // If check is disabled, force match to true.
+    bool canMatch =  (info.type.fields.CAN == status->can)
+                  || (status->canRxEn == false);
 
-    return false;
+    // Check if the destination callsign of the incoming transmission
+    // matches with ours
+    callMatch = canMatch && compare_callsigns(status->source_address, info.dst);
 }
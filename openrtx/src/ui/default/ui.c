@@ -67,10 +67,12 @@
 #include <stdlib.h>
 #include <math.h>
 #include <ui/ui_default.h>
+#include <ui/ui_widgets.h>
 #include <rtx.h>
 #include <interfaces/platform.h>
 #include <interfaces/display.h>
 #include <interfaces/cps_io.h>
+#include <cps_cache.h>
 #include <interfaces/nvmem.h>
 #include <interfaces/delays.h>
 #include <string.h>
@@ -180,7 +182,8 @@ const char * settings_m17_items[] =
 {
     "Callsign",
     "CAN",
-    "CAN RX Check"
+    "CAN RX Check",
+    "Soft Decoding"
 };
 
 const char * settings_accessibility_items[] =
@@ -284,6 +287,8 @@ static ui_state_t ui_state;
 static bool macro_menu = false;
 static bool layout_ready = false;
 static bool redraw_needed = true;
+static uint8_t drawn_screen = 0xFF;
+static bool drawn_macro = false;
 
 static bool standby = false;
 static long long last_event_tick = 0;
@@ -601,13 +606,13 @@ static int _ui_fsm_loadChannel(int16_t channel_index, bool *sync_rtx)
     if(state.bank_enabled)
     {
         bankHdr_t bank = { 0 };
-        cps_readBankHeader(&bank, state.bank);
+        cpsCache_readBankHeader(&bank, state.bank);
         if((channel_index < 0) || (channel_index >= bank.ch_count))
             return -1;
         channel_index = cps_readBankData(state.bank, channel_index);
     }
 
-    int result = cps_readChannel(&channel, channel_index);
+    int result = cpsCache_readChannel(&channel, channel_index);
     // Read successful and channel is valid
     if((result != -1) && _ui_channel_valid(&channel))
     {
@@ -1826,23 +1831,23 @@ void ui_updateFSM(bool *sync_rtx)
                 {
                     if(state.ui_screen == MENU_BANK)
                     {
-                        bankHdr_t bank;
+                        char name[CPS_STR_SIZE];
                         // manu_selected is 0-based
                         // bank 0 means "All Channel" mode
                         // banks (1, n) are mapped to banks (0, n-1)
-                        if(cps_readBankHeader(&bank, ui_state.menu_selected) != -1)
+                        if(cpsCache_getBankName(name, sizeof(name), ui_state.menu_selected) != -1)
                             ui_state.menu_selected += 1;
                     }
                     else if(state.ui_screen == MENU_CHANNEL)
                     {
-                        channel_t channel;
-                        if(cps_readChannel(&channel, ui_state.menu_selected + 1) != -1)
+                        char name[CPS_STR_SIZE];
+                        if(cpsCache_getChannelName(name, sizeof(name), ui_state.menu_selected + 1) != -1)
                             ui_state.menu_selected += 1;
                     }
                     else if(state.ui_screen == MENU_CONTACTS)
                     {
-                        contact_t contact;
-                        if(cps_readContact(&contact, ui_state.menu_selected + 1) != -1)
+                        char name[CPS_STR_SIZE];
+                        if(cpsCache_getContactName(name, sizeof(name), ui_state.menu_selected + 1) != -1)
                             ui_state.menu_selected += 1;
                     }
                 }
@@ -1858,7 +1863,7 @@ void ui_updateFSM(bool *sync_rtx)
                         else
                         {
                             state.bank_enabled = true;
-                            result = cps_readBankHeader(&newbank, ui_state.menu_selected - 1);
+                            result = cpsCache_readBankHeader(&newbank, ui_state.menu_selected - 1);
                         }
                         if(result != -1)
                         {
@@ -2319,6 +2324,20 @@ void ui_updateFSM(bool *sync_rtx)
                                 ui_state.edit_mode = !ui_state.edit_mode;
                             else if(msg.keys & KEY_ESC)
                                 ui_state.edit_mode = false;
+                            break;
+                        case M17_SOFT_DEC:
+                            if(msg.keys & KEY_LEFT || msg.keys & KEY_RIGHT ||
+                                (ui_state.edit_mode &&
+                                 (msg.keys & KEY_DOWN || msg.keys & KNOB_LEFT ||
+                                  msg.keys & KEY_UP || msg.keys & KNOB_RIGHT)))
+                            {
+                                state.settings.m17_hard_dec =
+                                    !state.settings.m17_hard_dec;
+                            }
+                            else if(msg.keys & KEY_ENTER)
+                                ui_state.edit_mode = !ui_state.edit_mode;
+                            else if(msg.keys & KEY_ESC)
+                                ui_state.edit_mode = false;
                     }
                 }
                 else
@@ -2490,6 +2509,19 @@ bool ui_updateGUI()
         _ui_calculateLayout(&layout);
         layout_ready = true;
     }
+
+    // Retained widgets stay on screen as long as the same page is shown:
+    // start from a blank screen when the page changes or the macro menu
+    // is being drawn over it.
+    if((last_state.ui_screen != drawn_screen) || macro_menu || drawn_macro)
+    {
+        gfx_clearScreen();
+        widget_invalidateAll();
+        drawn_screen = last_state.ui_screen;
+    }
+
+    drawn_macro = macro_menu;
+
     // Draw current GUI page
     switch(last_state.ui_screen)
     {
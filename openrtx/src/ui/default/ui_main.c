@@ -20,9 +20,12 @@
 
 #include <interfaces/platform.h>
 #include <interfaces/cps_io.h>
+#include <cps_cache.h>
+#include <cps_index.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <ui/ui_default.h>
+#include <ui/ui_widgets.h>
 #include <string.h>
 #include <ui/ui_strings.h>
 #include <utils.h>
@@ -35,29 +38,93 @@ void _ui_drawMainBackground()
     gfx_drawHLine(CONFIG_SCREEN_HEIGHT - layout.bottom_h - 1, layout.hline_h, color_grey);
 }
 
+// Widgets of the main screens
+#ifdef CONFIG_RTC
+static uiValue_t clockField;
+#endif
+#ifdef CONFIG_BAT_NONE
+static uiLabel_t voltageLabel;
+#else
+static uiBox_t   batteryBox;
+#endif
+static uiBox_t   lockBox;
+static uiLabel_t line1Label;
+static uiLabel_t line2Label;
+static uiLabel_t line3Label;
+static uiLabel_t line4Label;
+static uiBox_t   modeSymbols;
+static uiLabel_t freqLabel;
+static uiBox_t   meterBox;
+
+// Key of the current main screen layout
+static uint32_t mainLayout;
+
+/**
+ * \internal
+ * Fields of the radio state determining which widgets are shown on the main
+ * screens, when any of them changes the screen is cleared and all the widgets
+ * are redrawn.
+ */
+static uint32_t _ui_getMainLayout(ui_state_t *ui_state)
+{
+    uint32_t key = last_state.ui_screen;
+    key = (key << 4) | last_state.channel.mode;
+    key = (key << 1) | (ui_state->input_locked ? 1 : 0);
+
+    #ifdef CONFIG_M17
+    rtxStatus_t status = rtx_getCurrentStatus();
+    if(status.opMode == OPMODE_M17)
+    {
+        key = (key << 1) | (status.lsfOk ? 1 : 0);
+        key = (key << 1) | ((status.M17_link[0] != '\0') ? 1 : 0);
+        key = (key << 1) | ((status.M17_refl[0] != '\0') ? 1 : 0);
+    }
+    #endif
+
+    return key;
+}
+
+static void _ui_updateMainLayout(ui_state_t *ui_state)
+{
+    uint32_t key = _ui_getMainLayout(ui_state);
+    if(key == mainLayout)
+        return;
+
+    gfx_clearScreen();
+    widget_invalidateAll();
+    mainLayout = key;
+}
+
 void _ui_drawMainTop(ui_state_t * ui_state)
 {
 #ifdef CONFIG_RTC
     // Print clock on top bar
     datetime_t local_time = utcToLocalTime(last_state.time,
                                            last_state.settings.utc_timezone);
-    gfx_print(layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
-              color_white, "%02d:%02d:%02d", local_time.hour,
-              local_time.minute, local_time.second);
+    uint32_t seconds = (local_time.hour * 3600) + (local_time.minute * 60)
+                     + local_time.second;
+    widget_value(&clockField, seconds, layout.top_pos, layout.top_font,
+                 TEXT_ALIGN_CENTER, color_white, "%02d:%02d:%02d",
+                 local_time.hour, local_time.minute, local_time.second);
 #endif
     // If the radio has no built-in battery, print input voltage
 #ifdef CONFIG_BAT_NONE
-    gfx_print(layout.top_pos, layout.top_font, TEXT_ALIGN_RIGHT,
-              color_white,"%.1fV", last_state.v_bat);
+    widget_label(&voltageLabel, layout.top_pos, layout.top_font,
+                 TEXT_ALIGN_RIGHT, color_white, "%.1fV", last_state.v_bat);
 #else
     // Otherwise print battery icon on top bar, use 4 px padding
     uint16_t bat_width = CONFIG_SCREEN_WIDTH / 9;
     uint16_t bat_height = layout.top_h - (layout.status_v_pad * 2);
     point_t bat_pos = {CONFIG_SCREEN_WIDTH - bat_width - layout.horizontal_pad,
                        layout.status_v_pad};
-    gfx_drawBattery(bat_pos, bat_width, bat_height, last_state.charge);
+    if(widget_box(&batteryBox, bat_pos, bat_width, bat_height,
+                  &last_state.charge, sizeof(last_state.charge)))
+        gfx_drawBattery(bat_pos, bat_width, bat_height, last_state.charge);
 #endif
-    if (ui_state->input_locked == true)
+    // Lock symbol is part of the screen layout
+    point_t origin = {0, 0};
+    if((ui_state->input_locked == true) &&
+       widget_box(&lockBox, origin, 0, 0, NULL, 0))
       gfx_drawSymbol(layout.top_pos, layout.top_symbol_size, TEXT_ALIGN_LEFT,
                      color_white, SYMBOL_LOCK);
 }
@@ -66,9 +133,9 @@ void _ui_drawBankChannel()
 {
     // Print Bank number, channel number and Channel name
     uint16_t b = (last_state.bank_enabled) ? last_state.bank : 0;
-    gfx_print(layout.line1_pos, layout.line1_font, TEXT_ALIGN_CENTER,
-              color_white, "%01d-%03d: %.12s",
-              b, last_state.channel_index + 1, last_state.channel.name);
+    widget_label(&line1Label, layout.line1_pos, layout.line1_font,
+                 TEXT_ALIGN_CENTER, color_white, "%01d-%03d: %.12s",
+                 b, last_state.channel_index + 1, last_state.channel.name);
 }
 
 void _ui_drawModeInfo(ui_state_t* ui_state)
@@ -103,21 +170,21 @@ void _ui_drawModeInfo(ui_state_t* ui_state)
             if (tone_tx_enable || tone_rx_enable)
             {
                 uint16_t tone = ctcss_tone[last_state.channel.fm.txTone];
-                gfx_print(layout.line2_pos, layout.line2_font, TEXT_ALIGN_CENTER,
-                          color_white, "%s %d.%d %s", bw_str, (tone / 10),
-                          (tone % 10), encdec_str);
+                widget_label(&line2Label, layout.line2_pos, layout.line2_font,
+                             TEXT_ALIGN_CENTER, color_white, "%s %d.%d %s",
+                             bw_str, (tone / 10), (tone % 10), encdec_str);
             }
             else
             {
-                gfx_print(layout.line2_pos, layout.line2_font, TEXT_ALIGN_CENTER,
-                          color_white, "%s", bw_str );
+                widget_label(&line2Label, layout.line2_pos, layout.line2_font,
+                             TEXT_ALIGN_CENTER, color_white, "%s", bw_str);
             }
             break;
 
         case OPMODE_DMR:
             // Print talkgroup
-            gfx_print(layout.line2_pos, layout.line2_font, TEXT_ALIGN_CENTER,
-                    color_white, "DMR TG%s", "");
+            widget_label(&line2Label, layout.line2_pos, layout.line2_font,
+                         TEXT_ALIGN_CENTER, color_white, "DMR TG%s", "");
             break;
 
         #ifdef CONFIG_M17
@@ -128,38 +195,57 @@ void _ui_drawModeInfo(ui_state_t* ui_state)
 
             if(rtxStatus.lsfOk)
             {
+                // Symbols are part of the screen layout, draw them once
+                point_t origin = {0, 0};
+                bool drawSymbols = widget_box(&modeSymbols, origin, 0, 0,
+                                              NULL, 0);
+
                 // Destination address
-                gfx_drawSymbol(layout.line2_pos, layout.line2_symbol_size, TEXT_ALIGN_LEFT,
-                               color_white, SYMBOL_CALL_RECEIVED);
+                if(drawSymbols)
+                    gfx_drawSymbol(layout.line2_pos, layout.line2_symbol_size, TEXT_ALIGN_LEFT,
+                                   color_white, SYMBOL_CALL_RECEIVED);
+
+                widget_label(&line2Label, layout.line2_pos, layout.line2_font,
+                             TEXT_ALIGN_CENTER, color_white, "%s",
+                             rtxStatus.M17_dst);
 
-                gfx_print(layout.line2_pos, layout.line2_font, TEXT_ALIGN_CENTER,
-                          color_white, "%s", rtxStatus.M17_dst);
+                // Source address, replaced by the contact name if known
+                if(drawSymbols)
+                    gfx_drawSymbol(layout.line1_pos, layout.line1_symbol_size, TEXT_ALIGN_LEFT,
+                                   color_white, SYMBOL_CALL_MADE);
 
-                // Source address
-                gfx_drawSymbol(layout.line1_pos, layout.line1_symbol_size, TEXT_ALIGN_LEFT,
-                               color_white, SYMBOL_CALL_MADE);
+                const char *src = rtxStatus.M17_src;
+                char srcName[CPS_STR_SIZE];
+                int  contact = cpsIndex_findM17Contact(rtxStatus.M17_src);
+                if((contact >= 0) &&
+                   (cpsCache_getContactName(srcName, sizeof(srcName), contact) == 0))
+                    src = srcName;
 
-                gfx_print(layout.line1_pos, layout.line2_font, TEXT_ALIGN_CENTER,
-                          color_white, "%s", rtxStatus.M17_src);
+                widget_label(&line1Label, layout.line1_pos, layout.line2_font,
+                             TEXT_ALIGN_CENTER, color_white, "%s", src);
 
                 // RF link (if present)
                 if(rtxStatus.M17_link[0] != '\0')
                 {
-                    gfx_drawSymbol(layout.line4_pos, layout.line3_symbol_size, TEXT_ALIGN_LEFT,
-                                   color_white, SYMBOL_ACCESS_POINT);
+                    if(drawSymbols)
+                        gfx_drawSymbol(layout.line4_pos, layout.line3_symbol_size, TEXT_ALIGN_LEFT,
+                                       color_white, SYMBOL_ACCESS_POINT);
 
-                    gfx_print(layout.line4_pos, layout.line2_font, TEXT_ALIGN_CENTER,
-                              color_white, "%s", rtxStatus.M17_link);
+                    widget_label(&line4Label, layout.line4_pos,
+                                 layout.line2_font, TEXT_ALIGN_CENTER,
+                                 color_white, "%s", rtxStatus.M17_link);
                 }
 
                 // Reflector (if present)
                 if(rtxStatus.M17_refl[0] != '\0')
                 {
-                    gfx_drawSymbol(layout.line3_pos, layout.line4_symbol_size, TEXT_ALIGN_LEFT,
-                                   color_white, SYMBOL_NETWORK);
+                    if(drawSymbols)
+                        gfx_drawSymbol(layout.line3_pos, layout.line4_symbol_size, TEXT_ALIGN_LEFT,
+                                       color_white, SYMBOL_NETWORK);
 
-                    gfx_print(layout.line3_pos, layout.line2_font, TEXT_ALIGN_CENTER,
-                              color_white, "%s", rtxStatus.M17_refl);
+                    widget_label(&line3Label, layout.line3_pos,
+                                 layout.line2_font, TEXT_ALIGN_CENTER,
+                                 color_white, "%s", rtxStatus.M17_refl);
                 }
             }
             else
@@ -177,8 +263,8 @@ void _ui_drawModeInfo(ui_state_t* ui_state)
                         dst = rtxStatus.destination_address;
                 }
 
-                gfx_print(layout.line2_pos, layout.line2_font, TEXT_ALIGN_CENTER,
-                          color_white, "M17 #%s", dst);
+                widget_label(&line2Label, layout.line2_pos, layout.line2_font,
+                             TEXT_ALIGN_CENTER, color_white, "M17 #%s", dst);
             }
             break;
         }
@@ -196,8 +282,8 @@ void _ui_drawFrequency()
     sniprintf(freq_str, sizeof(freq_str), "%lu.%06lu", (freq / 1000000lu), (freq % 1000000lu));
     stripTrailingZeroes(freq_str);
 
-    gfx_print(layout.line3_large_pos, layout.line3_large_font, TEXT_ALIGN_CENTER,
-              color_white, "%s", freq_str);
+    widget_label(&freqLabel, layout.line3_large_pos, layout.line3_large_font,
+                 TEXT_ALIGN_CENTER, color_white, "%s", freq_str);
 }
 
 void _ui_drawVFOMiddleInput(ui_state_t* ui_state)
@@ -211,10 +297,10 @@ void _ui_drawVFOMiddleInput(ui_state_t* ui_state)
     {
         if(ui_state->input_position == 0)
         {
-            gfx_print(layout.line2_pos, layout.input_font, TEXT_ALIGN_CENTER,
-                      color_white, ">Rx:%03lu.%04lu",
-                      (unsigned long)ui_state->new_rx_frequency/1000000,
-                      (unsigned long)(ui_state->new_rx_frequency%1000000)/100);
+            widget_label(&line2Label, layout.line2_pos, layout.input_font,
+                         TEXT_ALIGN_CENTER, color_white, ">Rx:%03lu.%04lu",
+                         (unsigned long)ui_state->new_rx_frequency/1000000,
+                         (unsigned long)(ui_state->new_rx_frequency%1000000)/100);
         }
         else
         {
@@ -222,59 +308,81 @@ void _ui_drawVFOMiddleInput(ui_state_t* ui_state)
             if(ui_state->input_position == 1)
                 strcpy(ui_state->new_rx_freq_buf, ">Rx:___.____");
             ui_state->new_rx_freq_buf[insert_pos] = input_char;
-            gfx_print(layout.line2_pos, layout.input_font, TEXT_ALIGN_CENTER,
-                      color_white, ui_state->new_rx_freq_buf);
+            widget_label(&line2Label, layout.line2_pos, layout.input_font,
+                         TEXT_ALIGN_CENTER, color_white, "%s",
+                         ui_state->new_rx_freq_buf);
         }
-        gfx_print(layout.line3_large_pos, layout.input_font, TEXT_ALIGN_CENTER,
-                  color_white, " Tx:%03lu.%04lu",
-                  (unsigned long)last_state.channel.tx_frequency/1000000,
-                  (unsigned long)(last_state.channel.tx_frequency%1000000)/100);
+        widget_label(&freqLabel, layout.line3_large_pos, layout.input_font,
+                     TEXT_ALIGN_CENTER, color_white, " Tx:%03lu.%04lu",
+                     (unsigned long)last_state.channel.tx_frequency/1000000,
+                     (unsigned long)(last_state.channel.tx_frequency%1000000)/100);
     }
     else if(ui_state->input_set == SET_TX)
     {
-        gfx_print(layout.line2_pos, layout.input_font, TEXT_ALIGN_CENTER,
-                  color_white, " Rx:%03lu.%04lu",
-                  (unsigned long)ui_state->new_rx_frequency/1000000,
-                  (unsigned long)(ui_state->new_rx_frequency%1000000)/100);
+        widget_label(&line2Label, layout.line2_pos, layout.input_font,
+                     TEXT_ALIGN_CENTER, color_white, " Rx:%03lu.%04lu",
+                     (unsigned long)ui_state->new_rx_frequency/1000000,
+                     (unsigned long)(ui_state->new_rx_frequency%1000000)/100);
         // Replace Rx frequency with underscorses
         if(ui_state->input_position == 0)
         {
-            gfx_print(layout.line3_large_pos, layout.input_font, TEXT_ALIGN_CENTER,
-                      color_white, ">Tx:%03lu.%04lu",
-                      (unsigned long)ui_state->new_rx_frequency/1000000,
-                      (unsigned long)(ui_state->new_rx_frequency%1000000)/100);
+            widget_label(&freqLabel, layout.line3_large_pos, layout.input_font,
+                         TEXT_ALIGN_CENTER, color_white, ">Tx:%03lu.%04lu",
+                         (unsigned long)ui_state->new_rx_frequency/1000000,
+                         (unsigned long)(ui_state->new_rx_frequency%1000000)/100);
         }
         else
         {
             if(ui_state->input_position == 1)
                 strcpy(ui_state->new_tx_freq_buf, ">Tx:___.____");
             ui_state->new_tx_freq_buf[insert_pos] = input_char;
-            gfx_print(layout.line3_large_pos, layout.input_font, TEXT_ALIGN_CENTER,
-                      color_white, ui_state->new_tx_freq_buf);
+            widget_label(&freqLabel, layout.line3_large_pos, layout.input_font,
+                         TEXT_ALIGN_CENTER, color_white, "%s",
+                         ui_state->new_tx_freq_buf);
         }
     }
 }
 
-void _ui_drawMainBottom()
+/**
+ * \internal
+ * Radio state the bottom bar meter is drawn from.
+ */
+typedef struct
+{
+    rssi_t  rssi;
+    uint8_t mode;
+    uint8_t squelch;
+    uint8_t volume;
+    uint8_t mic_level;
+}
+meterState_t;
+
+static void _ui_getMeterState(meterState_t *meter)
+{
+    memset(meter, 0x00, sizeof(meterState_t));
+    meter->rssi      = last_state.rssi;
+    meter->mode      = last_state.channel.mode;
+    meter->squelch   = last_state.settings.sqlLevel;
+    meter->volume    = last_state.volume;
+    meter->mic_level = platform_getMicLevel();
+}
+
+static void _ui_drawMeter(const meterState_t *meter)
 {
     // Squelch bar
-    rssi_t   rssi = last_state.rssi;
-    uint8_t  squelch = last_state.settings.sqlLevel;
-    uint8_t  volume = last_state.volume;
     uint16_t meter_width = CONFIG_SCREEN_WIDTH - 2 * layout.horizontal_pad;
     uint16_t meter_height = layout.bottom_h;
     point_t meter_pos = { layout.horizontal_pad,
                           CONFIG_SCREEN_HEIGHT - meter_height - layout.bottom_pad};
-    uint8_t mic_level = platform_getMicLevel();
-    switch(last_state.channel.mode)
+    switch(meter->mode)
     {
         case OPMODE_FM:
             gfx_drawSmeter(meter_pos,
                            meter_width,
                            meter_height,
-                           rssi,
-                           squelch,
-                           volume,
+                           meter->rssi,
+                           meter->squelch,
+                           meter->volume,
                            true,
                            yellow_fab413);
             break;
@@ -282,9 +390,9 @@ void _ui_drawMainBottom()
             gfx_drawSmeterLevel(meter_pos,
                                 meter_width,
                                 meter_height,
-                                rssi,
-                                mic_level,
-                                volume,
+                                meter->rssi,
+                                meter->mic_level,
+                                meter->volume,
                                 true);
             break;
         #ifdef CONFIG_M17
@@ -292,18 +400,38 @@ void _ui_drawMainBottom()
             gfx_drawSmeterLevel(meter_pos,
                                 meter_width,
                                 meter_height,
-                                rssi,
-                                mic_level,
-                                volume,
+                                meter->rssi,
+                                meter->mic_level,
+                                meter->volume,
                                 true);
             break;
         #endif
     }
 }
 
+void _ui_drawMainBottom()
+{
+    meterState_t meter;
+    _ui_getMeterState(&meter);
+    _ui_drawMeter(&meter);
+}
+
+static void _ui_updateMainBottom()
+{
+    meterState_t meter;
+    _ui_getMeterState(&meter);
+
+    // Meter scale labels are printed right below the bars and may exceed
+    // the meter width, redraw the whole bottom bar when the state changes.
+    point_t box_pos = {0, CONFIG_SCREEN_HEIGHT - layout.bottom_h - layout.bottom_pad};
+    if(widget_box(&meterBox, box_pos, CONFIG_SCREEN_WIDTH, layout.bottom_h + 1,
+                  &meter, sizeof(meter)))
+        _ui_drawMeter(&meter);
+}
+
 void _ui_drawMainVFO(ui_state_t* ui_state)
 {
-    gfx_clearScreen();
+    _ui_updateMainLayout(ui_state);
     _ui_drawMainTop(ui_state);
     _ui_drawModeInfo(ui_state);
 
@@ -314,20 +442,20 @@ void _ui_drawMainVFO(ui_state_t* ui_state)
     #endif
         _ui_drawFrequency();
 
-    _ui_drawMainBottom();
+    _ui_updateMainBottom();
 }
 
 void _ui_drawMainVFOInput(ui_state_t* ui_state)
 {
-    gfx_clearScreen();
+    _ui_updateMainLayout(ui_state);
     _ui_drawMainTop(ui_state);
     _ui_drawVFOMiddleInput(ui_state);
-    _ui_drawMainBottom();
+    _ui_updateMainBottom();
 }
 
 void _ui_drawMainMEM(ui_state_t* ui_state)
 {
-    gfx_clearScreen();
+    _ui_updateMainLayout(ui_state);
     _ui_drawMainTop(ui_state);
     _ui_drawModeInfo(ui_state);
 
@@ -341,5 +469,5 @@ void _ui_drawMainMEM(ui_state_t* ui_state)
         _ui_drawFrequency();
     }
 
-    _ui_drawMainBottom();
+    _ui_updateMainBottom();
 }
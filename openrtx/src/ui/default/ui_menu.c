@@ -24,8 +24,9 @@
 #include <inttypes.h>
 #include <utils.h>
 #include <ui/ui_default.h>
+#include <ui/ui_widgets.h>
 #include <interfaces/nvmem.h>
-#include <interfaces/cps_io.h>
+#include <cps_cache.h>
 #include <interfaces/platform.h>
 #include <interfaces/delays.h>
 #include <memory_profiling.h>
@@ -44,6 +45,10 @@ static char priorSelectedMenuValue[MAX_ENTRY_LEN] = "\0";
 static bool priorEditMode = false;
 static uint32_t lastValueUpdate=0;
 
+// Widgets of the menu list screens
+static uiLabel_t menuTitle;
+static uiList_t  menuList;
+
 const char *display_timer_values[] =
 {
     "Off",
@@ -161,26 +166,41 @@ void _ui_drawMenuList(uint8_t selected, int (*getCurrentEntry)(char *buf, uint8_
     // Number of menu entries that fit in the screen height
     uint8_t entries_in_screen = (CONFIG_SCREEN_HEIGHT - 1 - pos.y) / layout.menu_h + 1;
     uint8_t scroll = 0;
+    // If selection is off the screen, scroll screen
+    if(selected >= entries_in_screen)
+        scroll = selected - entries_in_screen + 1;
+
+    // Nothing to do if neither the selection nor the visible entries changed
+    if(widget_listUpdate(&menuList, scroll, selected) == false)
+        return;
+
     char entry_buf[MAX_ENTRY_LEN] = "";
     color_t text_color = color_white;
     for(int item=0, result=0; (result == 0) && (pos.y < CONFIG_SCREEN_HEIGHT); item++)
     {
-        // If selection is off the screen, scroll screen
-        if(selected >= entries_in_screen)
-            scroll = selected - entries_in_screen + 1;
+        // Skip the entries whose content and selection state did not change
+        if(widget_listEntryDirty(&menuList, item + scroll) == false)
+        {
+            pos.y += layout.menu_h;
+            continue;
+        }
+
         // Call function pointer to get current menu entry string
         result = (*getCurrentEntry)(entry_buf, sizeof(entry_buf), item+scroll);
         if(result != -1)
         {
+            // Fill the entry area, compensating for text height: draw a
+            // rectangle under selected item, clear the others
+            point_t rect_pos = {0, pos.y - layout.menu_h + 3};
+            color_t rect_color = color_black;
             text_color = color_white;
             if(item + scroll == selected)
             {
                 text_color = color_black;
-                // Draw rectangle under selected item, compensating for text height
-                point_t rect_pos = {0, pos.y - layout.menu_h + 3};
-                gfx_drawRect(rect_pos, CONFIG_SCREEN_WIDTH, layout.menu_h, color_white, true);
+                rect_color = color_white;
                 announceMenuItemIfNeeded(entry_buf, NULL, false);
             }
+            gfx_drawRect(rect_pos, CONFIG_SCREEN_WIDTH, layout.menu_h, rect_color, true);
             gfx_print(pos, layout.menu_font, TEXT_ALIGN_LEFT, text_color, entry_buf);
             pos.y += layout.menu_h;
         }
@@ -434,6 +454,11 @@ int _ui_getM17ValueName(char *buf, uint8_t max_len, uint8_t index)
                                                            currentLanguage->on :
                                                            currentLanguage->off);
             break;
+        case M17_SOFT_DEC:
+            sniprintf(buf, max_len, "%s", (last_state.settings.m17_hard_dec) ?
+                                                           currentLanguage->off :
+                                                           currentLanguage->on);
+            break;
     }
 
     return 0;
@@ -562,68 +587,53 @@ int _ui_getBankName(char *buf, uint8_t max_len, uint8_t index)
     }
     else
     {
-        bankHdr_t bank;
-        result = cps_readBankHeader(&bank, index - 1);
-        if(result != -1)
-            sniprintf(buf, max_len, "%s", bank.name);
+        result = cpsCache_getBankName(buf, max_len, index - 1);
     }
     return result;
 }
 
 int _ui_getChannelName(char *buf, uint8_t max_len, uint8_t index)
 {
-    channel_t channel;
-    int result = cps_readChannel(&channel, index);
-    if(result != -1)
-        sniprintf(buf, max_len, "%s", channel.name);
-    return result;
+    return cpsCache_getChannelName(buf, max_len, index);
 }
 
 int _ui_getContactName(char *buf, uint8_t max_len, uint8_t index)
 {
-    contact_t contact;
-    int result = cps_readContact(&contact, index);
-    if(result != -1)
-        sniprintf(buf, max_len, "%s", contact.name);
-    return result;
+    return cpsCache_getContactName(buf, max_len, index);
 }
 
 void _ui_drawMenuTop(ui_state_t* ui_state)
 {
-    gfx_clearScreen();
     // Print "Menu" on top bar
-    gfx_print(layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
-              color_white, currentLanguage->menu);
+    widget_label(&menuTitle, layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
+                 color_white, "%s", currentLanguage->menu);
     // Print menu entries
     _ui_drawMenuList(ui_state->menu_selected, _ui_getMenuTopEntryName);
 }
 
 void _ui_drawMenuBank(ui_state_t* ui_state)
 {
-    gfx_clearScreen();
     // Print "Bank" on top bar
-    gfx_print(layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
-              color_white, currentLanguage->banks);
+    widget_label(&menuTitle, layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
+                 color_white, "%s", currentLanguage->banks);
     // Print bank entries
     _ui_drawMenuList(ui_state->menu_selected, _ui_getBankName);
 }
 
 void _ui_drawMenuChannel(ui_state_t* ui_state)
 {
-    gfx_clearScreen();
     // Print "Channel" on top bar
-    gfx_print(layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
-              color_white, currentLanguage->channels);
+    widget_label(&menuTitle, layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
+                 color_white, "%s", currentLanguage->channels);
     // Print channel entries
     _ui_drawMenuList(ui_state->menu_selected, _ui_getChannelName);
 }
 
 void _ui_drawMenuContacts(ui_state_t* ui_state)
 {
-    gfx_clearScreen();
     // Print "Contacts" on top bar
-    gfx_print(layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
-              color_white, currentLanguage->contacts);
+    widget_label(&menuTitle, layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
+                 color_white, "%s", currentLanguage->contacts);
     // Print contact entries
     _ui_drawMenuList(ui_state->menu_selected, _ui_getContactName);
 }
@@ -730,20 +740,18 @@ void _ui_drawMenuGPS()
 
 void _ui_drawMenuSettings(ui_state_t* ui_state)
 {
-    gfx_clearScreen();
     // Print "Settings" on top bar
-    gfx_print(layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
-              color_white, currentLanguage->settings);
+    widget_label(&menuTitle, layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
+                 color_white, "%s", currentLanguage->settings);
     // Print menu entries
     _ui_drawMenuList(ui_state->menu_selected, _ui_getSettingsEntryName);
 }
 
 void _ui_drawMenuBackupRestore(ui_state_t* ui_state)
 {
-    gfx_clearScreen();
     // Print "Backup & Restore" on top bar
-    gfx_print(layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
-              color_white, currentLanguage->backupAndRestore);
+    widget_label(&menuTitle, layout.top_pos, layout.top_font, TEXT_ALIGN_CENTER,
+                 color_white, "%s", currentLanguage->backupAndRestore);
     // Print menu entries
     _ui_drawMenuList(ui_state->menu_selected, _ui_getBackupRestoreEntryName);
 }
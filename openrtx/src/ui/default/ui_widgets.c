@@ -0,0 +1,184 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN,                            *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <ui/ui_widgets.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+static const color_t background = {0, 0, 0, 255};
+
+// Current screen epoch, zero is reserved for never rendered widgets
+static uint16_t epoch = 1;
+
+
+static inline bool sameColor(const color_t a, const color_t b)
+{
+    return (a.r == b.r) && (a.g == b.g) && (a.b == b.b) && (a.alpha == b.alpha);
+}
+
+static uint32_t hash(uint32_t hash, const void *data, const size_t len)
+{
+    // 32 bit FNV-1a
+    const uint8_t *ptr = (const uint8_t *) data;
+
+    for(size_t i = 0; i < len; i++)
+    {
+        hash ^= ptr[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+static bool updateLabel(uiLabel_t *label, point_t pos, fontSize_t font,
+                        textAlign_t align, color_t color, const char *text)
+{
+    bool onScreen = (label->epoch == epoch);
+
+    if(onScreen                          &&
+       (label->pos.x == pos.x)           &&
+       (label->pos.y == pos.y)           &&
+       (label->font  == font)            &&
+       (label->align == align)           &&
+       sameColor(label->color, color)    &&
+       (strcmp(label->text, text) == 0))
+    {
+        return false;
+    }
+
+    // Erase the old text by drawing it again with the background color, this
+    // touches only the pixels actually belonging to the label.
+    if(onScreen)
+        gfx_printBuffer(label->pos, label->font, label->align, background,
+                        label->text);
+
+    gfx_printBuffer(pos, font, align, color, text);
+
+    label->epoch = epoch;
+    label->pos   = pos;
+    label->font  = font;
+    label->align = align;
+    label->color = color;
+    strncpy(label->text, text, sizeof(label->text) - 1);
+    label->text[sizeof(label->text) - 1] = '\0';
+
+    return true;
+}
+
+void widget_invalidateAll()
+{
+    epoch += 1;
+    if(epoch == 0)
+        epoch = 1;
+}
+
+bool widget_label(uiLabel_t *label, point_t pos, fontSize_t font,
+                  textAlign_t align, color_t color, const char *fmt, ...)
+{
+    char text[sizeof(label->text)];
+
+    va_list ap;
+    va_start(ap, fmt);
+    vsniprintf(text, sizeof(text), fmt, ap);
+    va_end(ap);
+
+    return updateLabel(label, pos, font, align, color, text);
+}
+
+bool widget_value(uiValue_t *field, uint32_t value, point_t pos,
+                  fontSize_t font, textAlign_t align, color_t color,
+                  const char *fmt, ...)
+{
+    const uiLabel_t *label = &field->label;
+
+    if((label->epoch == epoch)           &&
+       (field->value == value)           &&
+       (label->pos.x == pos.x)           &&
+       (label->pos.y == pos.y)           &&
+       (label->font  == font)            &&
+       (label->align == align)           &&
+       sameColor(label->color, color))
+    {
+        return false;
+    }
+
+    char text[sizeof(label->text)];
+
+    va_list ap;
+    va_start(ap, fmt);
+    vsniprintf(text, sizeof(text), fmt, ap);
+    va_end(ap);
+
+    field->value = value;
+    return updateLabel(&field->label, pos, font, align, color, text);
+}
+
+bool widget_box(uiBox_t *box, point_t pos, uint16_t width, uint16_t height,
+                const void *content, size_t len)
+{
+    uint32_t h = 2166136261u;
+    h = hash(h, &pos, sizeof(pos));
+    h = hash(h, &width, sizeof(width));
+    h = hash(h, &height, sizeof(height));
+    if(content != NULL)
+        h = hash(h, content, len);
+
+    bool onScreen = (box->epoch == epoch);
+    if(onScreen && (box->hash == h))
+        return false;
+
+    if(onScreen && (width > 0) && (height > 0))
+        gfx_drawRect(pos, width, height, background, true);
+
+    box->epoch = epoch;
+    box->hash  = h;
+
+    return true;
+}
+
+bool widget_listUpdate(uiList_t *list, uint8_t first, uint8_t selected)
+{
+    if((list->epoch != epoch) || (list->first != first))
+    {
+        list->epoch    = epoch;
+        list->first    = first;
+        list->selected = selected;
+        list->full     = true;
+
+        return true;
+    }
+
+    list->full         = false;
+    list->prevSelected = list->selected;
+    list->selected     = selected;
+
+    return (list->prevSelected != selected);
+}
+
+bool widget_listEntryDirty(const uiList_t *list, uint8_t index)
+{
+    if(list->full)
+        return true;
+
+    if(list->prevSelected == list->selected)
+        return false;
+
+    return (index == list->selected) || (index == list->prevSelected);
+}
@@ -95,7 +95,8 @@ const char *m17_items[] =
 {
     "Callsign",
     "CAN",
-    "CAN RX Check"
+    "CAN RX Check",
+    "Soft Decoding"
 };
 
 const char *module17_items[] =
@@ -695,6 +696,9 @@ void ui_updateFSM(bool *sync_rtx)
                             case M_CAN_RX:
                                 state.settings.m17_can_rx = !state.settings.m17_can_rx;
                                 break;
+                            case M_SOFT_DEC:
+                                state.settings.m17_hard_dec = !state.settings.m17_hard_dec;
+                                break;
                             default:
                                 state.ui_screen = SETTINGS_M17;
                         }
@@ -709,6 +713,9 @@ void ui_updateFSM(bool *sync_rtx)
                             case M_CAN_RX:
                                 state.settings.m17_can_rx = !state.settings.m17_can_rx;
                                 break;
+                            case M_SOFT_DEC:
+                                state.settings.m17_hard_dec = !state.settings.m17_hard_dec;
+                                break;
                             default:
                                 state.ui_screen = SETTINGS_M17;
                         }
@@ -202,6 +202,9 @@ int _ui_getM17ValueName(char *buf, uint8_t max_len, uint8_t index)
         case M_CAN_RX:
             snprintf(buf, max_len, "%s", (last_state.settings.m17_can_rx) ? "on" : "off");
             break;
+        case M_SOFT_DEC:
+            snprintf(buf, max_len, "%s", (last_state.settings.m17_hard_dec) ? "off" : "on");
+            break;
     }
 
     return 0;
@@ -0,0 +1,48 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#ifndef CPS_BATCH_H
+#define CPS_BATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * \internal Get where a range of raw codeplug entries has to be read inside
+ * the output array of a batched read, to be then converted in place.
+ *
+ * The raw entries are placed at the end of the output array: as long as a raw
+ * entry is not larger than a converted one, converting the entries front to
+ * back never overwrites a raw entry not yet converted. Each raw entry has to
+ * be copied out before converting it, since the two may overlap.
+ *
+ * @param out: output array.
+ * @param outSize: size of an output entry.
+ * @param rawSize: size of a raw entry, not greater than outSize.
+ * @param count: number of entries.
+ * @return pointer to the memory area where the raw entries have to be read.
+ */
+static inline void *cps_rawBuffer(void *out, const size_t outSize,
+                                  const size_t rawSize, const uint16_t count)
+{
+    return ((uint8_t *) out) + (count * (outSize - rawSize));
+}
+
+#endif /* CPS_BATCH_H */
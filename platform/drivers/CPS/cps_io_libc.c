@@ -19,26 +19,633 @@
  ***************************************************************************/
 
 #include <interfaces/cps_io.h>
+#include <cps_cache.h>
 #include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <time.h>
+#include <crc.h>
 
-#define CPS_CHUNK_SIZE 1024
+/*
+ * Codeplug v0.2 layout:
+ * - the codeplug header, whose counters hold the length of the snapshot tables;
+ * - a snapshot descriptor;
+ * - one fixed size slot for each record ID, made by the record type followed
+ *   by the record data;
+ * - the contact, channel and bank tables, as arrays of record IDs;
+ * - for each bank, in bank order, the number of channels followed by the
+ *   record IDs of the channels;
+ * - the journal, a sequence of entries describing the modifications made to
+ *   the codeplug after the snapshot was written.
+ *
+ * Records are identified by IDs which never change while the codeplug is open:
+ * channels refer to contacts and banks refer to channels by ID, thus inserting
+ * or deleting an entry only changes the order of a table and never requires to
+ * renumber the references. Each modification is appended to the journal as a
+ * single write, together with the new record data, and applied to the tables
+ * kept in RAM. IDs of deleted records are recycled through a free list.
+ *
+ * The journal is replayed when the codeplug is opened and merged into a new
+ * snapshot when the codeplug is closed or when it grows too much. The new
+ * snapshot is written and flushed to disk in a temporary file which then
+ * replaces the codeplug, so that an interrupted compaction leaves either the
+ * old or the new codeplug intact. Codeplugs in
+ * the v0.1 format are converted when opened.
+ *
+ * NOTE: all the functions opening or modifying the codeplug have to invalidate
+ * the codeplug cache.
+ */
+
+/**
+ * Minimum journal size triggering a compaction, the journal is compacted also
+ * when it grows bigger than the snapshot.
+ */
+#ifndef CONFIG_CPS_JOURNAL_SIZE
+#define CONFIG_CPS_JOURNAL_SIZE 65536
+#endif
+
+#define CPS_NO_RECORD  0xFFFF
+#define CPS_READ_SLOTS 16
+
+enum recordType
+{
+    REC_FREE    = 0,
+    REC_CONTACT = 1,
+    REC_CHANNEL = 2,
+    REC_BANK    = 3,
+    REC_NUM
+};
+
+enum journalOp
+{
+    OP_WRITE      = 0,    // Write record data
+    OP_INSERT     = 1,    // Insert a new record in a table
+    OP_DELETE     = 2,    // Delete a record from a table
+    OP_WRITE_REF  = 3,    // Write a channel reference of a bank
+    OP_INSERT_REF = 4,    // Insert a channel reference in a bank
+    OP_DELETE_REF = 5     // Delete a channel reference from a bank
+};
+
+/**
+ * Data of a codeplug record.
+ */
+typedef union
+{
+    contact_t contact;
+    channel_t channel;
+    bankHdr_t bank;
+}
+__attribute__((packed)) cpsRecord_t;
+
+/**
+ * Snapshot descriptor, following the codeplug header.
+ */
+typedef struct
+{
+    uint16_t id_count;          //< Number of record slots
+    uint32_t journal_offset;    //< Offset of the first journal entry
+}
+__attribute__((packed)) cpsSnapshot_t;
+
+/**
+ * Journal entry, followed by len bytes of record data.
+ */
+typedef struct
+{
+    uint8_t  op;                //< Operation
+    uint8_t  type;              //< Type of the record or of the table
+    uint16_t bank;              //< Bank record ID, for channel references
+    uint16_t pos;               //< Position inside the table or the bank
+    uint16_t id;                //< Record ID or referenced channel ID
+    uint16_t len;               //< Length of the record data
+    uint16_t crc;               //< CRC of entry and data, computed with crc = 0
+}
+__attribute__((packed)) cpsJournalEntry_t;
+
+/**
+ * Ordered list of record IDs.
+ */
+typedef struct
+{
+    uint16_t *ids;
+    uint16_t  count;
+    uint32_t  size;
+}
+idList_t;
+
+/**
+ * In-RAM descriptor of a record.
+ */
+typedef struct
+{
+    uint32_t offset;    // Offset of the current record data in the file
+    uint16_t pos;       // Position inside its table
+    uint8_t  type;      // Record type
+    idList_t refs;      // Channels of a bank
+}
+record_t;
+
+#define SLOT_SIZE     (1 + sizeof(cpsRecord_t))
+#define RECORDS_START (sizeof(cps_header_t) + sizeof(cpsSnapshot_t))
+
+static FILE         *cps_file = NULL;
+static char         *cps_path = NULL;
+static bool          loaded   = false;
+static cps_header_t  cps_header;
+static record_t     *records    = NULL;
+static uint16_t      numRecords = 0;
+static uint32_t      recordsSize = 0;
+static idList_t      tables[REC_NUM];   // Entry REC_FREE holds the free IDs
+static bool          posValid[REC_NUM];
+static uint32_t      journalStart;
+static uint32_t      journalEnd;
+
+static int _compact();
 
-static FILE *cps_file = NULL;
 const char *default_author = "Codeplug author.";
 const char *default_descr = "Codeplug description.";
 
+
+static size_t recordSize(const uint8_t type)
+{
+    switch(type)
+    {
+        case REC_CONTACT: return sizeof(contact_t);
+        case REC_CHANNEL: return sizeof(channel_t);
+        case REC_BANK:    return sizeof(bankHdr_t);
+        default:          return 0;
+    }
+}
+
+static int listReserve(idList_t *list, uint32_t count)
+{
+    if(count <= list->size)
+        return 0;
+
+    uint32_t size = (list->size == 0) ? 16 : list->size;
+    while(size < count)
+        size *= 2;
+
+    uint16_t *ids = (uint16_t *) realloc(list->ids, size * sizeof(uint16_t));
+    if(ids == NULL)
+        return -1;
+
+    list->ids  = ids;
+    list->size = size;
+    return 0;
+}
+
+static int listInsert(idList_t *list, uint16_t pos, uint16_t id)
+{
+    if((pos > list->count) || (list->count == UINT16_MAX))
+        return -1;
+
+    if(listReserve(list, list->count + 1) < 0)
+        return -1;
+
+    memmove(&list->ids[pos + 1], &list->ids[pos],
+            (list->count - pos) * sizeof(uint16_t));
+    list->ids[pos] = id;
+    list->count   += 1;
+    return 0;
+}
+
+static int listRemove(idList_t *list, uint16_t pos)
+{
+    if(pos >= list->count)
+        return -1;
+
+    list->count -= 1;
+    memmove(&list->ids[pos], &list->ids[pos + 1],
+            (list->count - pos) * sizeof(uint16_t));
+    return 0;
+}
+
+static void listFree(idList_t *list)
+{
+    free(list->ids);
+    memset(list, 0x00, sizeof(idList_t));
+}
+
+/**
+ * Internal: drop the in-RAM tables.
+ */
+static void _resetTables()
+{
+    for(uint32_t id = 0; id < numRecords; id++)
+        listFree(&records[id].refs);
+
+    for(int i = 0; i < REC_NUM; i++)
+    {
+        listFree(&tables[i]);
+        posValid[i] = false;
+    }
+
+    free(records);
+    records      = NULL;
+    numRecords   = 0;
+    recordsSize  = 0;
+    journalStart = 0;
+    journalEnd   = 0;
+    loaded       = false;
+}
+
+/**
+ * Internal: make room for a given number of record IDs.
+ */
+static int _reserveRecords(uint32_t count)
+{
+    if((count <= recordsSize) && (records != NULL))
+        return 0;
+
+    uint32_t size = (recordsSize == 0) ? 64 : recordsSize;
+    while(size < count)
+        size *= 2;
+
+    record_t *r = (record_t *) realloc(records, size * sizeof(record_t));
+    if(r == NULL)
+        return -1;
+
+    records     = r;
+    recordsSize = size;
+    return 0;
+}
+
+/**
+ * Internal: get the ID which will be assigned to the next new record.
+ */
+static int _nextRecord()
+{
+    idList_t *freeIds = &tables[REC_FREE];
+    if(freeIds->count > 0)
+        return freeIds->ids[freeIds->count - 1];
+
+    if(numRecords == CPS_NO_RECORD)
+        return -1;
+
+    return numRecords;
+}
+
+/**
+ * Internal: assign a record ID, removing it from the free list.
+ *
+ * @param id: record ID.
+ * @return 0 on success, -1 on failure
+ */
+static int _claimRecord(uint16_t id)
+{
+    if(id == CPS_NO_RECORD)
+        return -1;
+
+    if(id >= numRecords)
+    {
+        if(_reserveRecords(id + 1) < 0)
+            return -1;
+
+        memset(&records[numRecords], 0x00,
+               (id + 1 - numRecords) * sizeof(record_t));
+
+        // IDs skipped over are free
+        for(uint32_t i = numRecords; i < id; i++)
+            listInsert(&tables[REC_FREE], tables[REC_FREE].count, i);
+
+        numRecords = id + 1;
+        return 0;
+    }
+
+    if(records[id].type != REC_FREE)
+        return -1;
+
+    // Free IDs are taken from the end of the list, search from there
+    idList_t *freeIds = &tables[REC_FREE];
+    for(uint16_t i = freeIds->count; i > 0; i--)
+    {
+        if(freeIds->ids[i - 1] == id)
+            return listRemove(freeIds, i - 1);
+    }
+
+    // Deleted contacts are recycled only by compaction
+    return -1;
+}
+
+/**
+ * Internal: refresh the table positions stored in the record descriptors.
+ */
+static void _updatePositions(const uint8_t type)
+{
+    if(posValid[type])
+        return;
+
+    const idList_t *table = &tables[type];
+    for(uint16_t pos = 0; pos < table->count; pos++)
+        records[table->ids[pos]].pos = pos;
+
+    posValid[type] = true;
+}
+
+static bool _isRecord(const uint16_t id, const uint8_t type)
+{
+    return (id < numRecords) && (records[id].type == type);
+}
+
+static bool _getContactRef(const channel_t *channel, uint16_t *ref)
+{
+    switch(channel->mode)
+    {
+        case OPMODE_DMR:
+            *ref = channel->dmr.contact_index;
+            return true;
+
+        case OPMODE_M17:
+            *ref = channel->m17.contact_index;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+static void _setContactRef(channel_t *channel, const uint16_t ref)
+{
+    if(channel->mode == OPMODE_DMR)
+        channel->dmr.contact_index = ref;
+    else if(channel->mode == OPMODE_M17)
+        channel->m17.contact_index = ref;
+}
+
+/**
+ * Internal: get the position of a contact from its ID, references to deleted
+ * contacts are mapped to CPS_NO_RECORD, which is not a valid position.
+ */
+static uint16_t _contactPos(const uint16_t id)
+{
+    if(_isRecord(id, REC_CONTACT) == false)
+        return CPS_NO_RECORD;
+
+    _updatePositions(REC_CONTACT);
+    return records[id].pos;
+}
+
+/**
+ * Internal: read the current data of a record.
+ */
+static int _readRecord(const uint16_t id, void *data)
+{
+    size_t size = recordSize(records[id].type);
+
+    if(fseek(cps_file, records[id].offset, SEEK_SET) != 0)
+        return -1;
+
+    if(fread(data, size, 1, cps_file) != 1)
+        return -1;
+
+    return 0;
+}
+
+/**
+ * Internal: read the current data of a range of records of a table. Records
+ * stored in consecutive snapshot slots are read together.
+ *
+ * @param type: table type.
+ * @param data: array of records to be populated.
+ * @param first: position of the first record inside the table.
+ * @param count: number of records to read.
+ * @return number of records read, -1 on failure
+ */
+static int _readRecords(const uint8_t type, void *data, uint16_t first,
+                        uint16_t count)
+{
+    uint8_t         buf[CPS_READ_SLOTS * SLOT_SIZE];
+    const idList_t *table = &tables[type];
+    const size_t    size  = recordSize(type);
+    uint8_t        *out   = (uint8_t *) data;
+
+    if((loaded == false) || (first >= table->count))
+        return -1;
+
+    if(count > (table->count - first))
+        count = table->count - first;
+
+    for(uint16_t i = 0; i < count; )
+    {
+        const uint16_t *ids    = &table->ids[first + i];
+        uint32_t        offset = records[ids[0]].offset;
+        uint16_t        run    = 1;
+
+        while((run < CPS_READ_SLOTS) && ((i + run) < count) &&
+              (records[ids[run]].offset == offset + (run * SLOT_SIZE)))
+            run++;
+
+        size_t len = ((run - 1) * SLOT_SIZE) + size;
+        if((fseek(cps_file, offset, SEEK_SET) != 0) ||
+           (fread(buf, len, 1, cps_file) != 1))
+            return (i > 0) ? i : -1;
+
+        for(uint16_t j = 0; j < run; j++)
+            memcpy(out + ((i + j) * size), buf + (j * SLOT_SIZE), size);
+
+        i += run;
+    }
+
+    return count;
+}
+
+/**
+ * Internal: release a deleted record.
+ */
+static int _releaseRecord(const uint16_t id)
+{
+    uint8_t type = records[id].type;
+
+    if(type == REC_CHANNEL)
+    {
+        // Drop the deleted channel from all the banks
+        const idList_t *banks = &tables[REC_BANK];
+        for(uint16_t i = 0; i < banks->count; i++)
+        {
+            idList_t *refs = &records[banks->ids[i]].refs;
+            for(uint16_t j = refs->count; j > 0; j--)
+            {
+                if(refs->ids[j - 1] == id)
+                    listRemove(refs, j - 1);
+            }
+        }
+    }
+
+    listFree(&records[id].refs);
+    records[id].type = REC_FREE;
+
+    // Channels may still refer to a deleted contact: its ID can be reused only
+    // after the references have been cleared by a compaction.
+    if(type == REC_CONTACT)
+        return 0;
+
+    return listInsert(&tables[REC_FREE], tables[REC_FREE].count, id);
+}
+
+/**
+ * Internal: apply a journal entry to the in-RAM tables.
+ *
+ * @param entry: journal entry.
+ * @param offset: offset, in the file, of the record data.
+ * @return 0 on success, -1 on failure
+ */
+static int _apply(const cpsJournalEntry_t *entry, const uint32_t offset)
+{
+    idList_t *table = NULL;
+    idList_t *refs  = NULL;
+
+    if((entry->type == REC_FREE) || (entry->type >= REC_NUM))
+        return -1;
+
+    table = &tables[entry->type];
+    if(entry->op >= OP_WRITE_REF)
+    {
+        if((entry->type != REC_BANK) || !_isRecord(entry->bank, REC_BANK))
+            return -1;
+
+        refs = &records[entry->bank].refs;
+    }
+
+    switch(entry->op)
+    {
+        case OP_WRITE:
+            if((_isRecord(entry->id, entry->type) == false) ||
+               (entry->len != recordSize(entry->type)))
+                return -1;
+
+            records[entry->id].offset = offset;
+            break;
+
+        case OP_INSERT:
+            if((entry->pos > table->count) ||
+               (entry->len != recordSize(entry->type)))
+                return -1;
+
+            if(_claimRecord(entry->id) < 0)
+                return -1;
+
+            memset(&records[entry->id], 0x00, sizeof(record_t));
+            records[entry->id].type   = entry->type;
+            records[entry->id].offset = offset;
+
+            if(listInsert(table, entry->pos, entry->id) < 0)
+            {
+                _releaseRecord(entry->id);
+                return -1;
+            }
+
+            posValid[entry->type] = false;
+            break;
+
+        case OP_DELETE:
+            if((entry->pos >= table->count) ||
+               (table->ids[entry->pos] != entry->id))
+                return -1;
+
+            // Make room for the released ID before changing the tables
+            if(listReserve(&tables[REC_FREE], tables[REC_FREE].count + 1) < 0)
+                return -1;
+
+            listRemove(table, entry->pos);
+            posValid[entry->type] = false;
+
+            if(_releaseRecord(entry->id) < 0)
+                return -1;
+            break;
+
+        case OP_WRITE_REF:
+            if((entry->pos >= refs->count) ||
+               (_isRecord(entry->id, REC_CHANNEL) == false))
+                return -1;
+
+            refs->ids[entry->pos] = entry->id;
+            break;
+
+        case OP_INSERT_REF:
+            if(_isRecord(entry->id, REC_CHANNEL) == false)
+                return -1;
+
+            return listInsert(refs, entry->pos, entry->id);
+
+        case OP_DELETE_REF:
+            return listRemove(refs, entry->pos);
+
+        default:
+            return -1;
+    }
+
+    return 0;
+}
+
+static uint16_t _entryCrc(cpsJournalEntry_t *entry, const void *data)
+{
+    uint8_t buf[sizeof(cpsJournalEntry_t) + sizeof(cpsRecord_t)];
+
+    entry->crc = 0;
+    memcpy(buf, entry, sizeof(cpsJournalEntry_t));
+    if(entry->len > 0)
+        memcpy(buf + sizeof(cpsJournalEntry_t), data, entry->len);
+
+    return crc_ccitt(buf, sizeof(cpsJournalEntry_t) + entry->len);
+}
+
+/**
+ * Internal: replay the journal, stopping at the first damaged or invalid
+ * entry, which is discarded together with all the following ones.
+ *
+ * @return 0 on success, -1 if the discarded entries cannot be removed
+ */
+static int _replay()
+{
+    cpsJournalEntry_t entry;
+    cpsRecord_t       data;
+    uint32_t          offset = journalStart;
+
+    fseek(cps_file, offset, SEEK_SET);
+    while(fread(&entry, sizeof(cpsJournalEntry_t), 1, cps_file) == 1)
+    {
+        if(entry.len > sizeof(cpsRecord_t))
+            break;
+
+        if((entry.len > 0) && (fread(&data, entry.len, 1, cps_file) != 1))
+            break;
+
+        uint16_t crc = entry.crc;
+        if(_entryCrc(&entry, &data) != crc)
+            break;
+
+        if(_apply(&entry, offset + sizeof(cpsJournalEntry_t)) < 0)
+            break;
+
+        offset += sizeof(cpsJournalEntry_t) + entry.len;
+        fseek(cps_file, offset, SEEK_SET);
+    }
+
+    // Drop the discarded entries, new ones will be appended from here. If left
+    // in place, they could be replayed after the new entries.
+    journalEnd = offset;
+    fseek(cps_file, 0, SEEK_END);
+    if(ftell(cps_file) <= (long) journalEnd)
+        return 0;
+
+    fflush(cps_file);
+    return ftruncate(fileno(cps_file), journalEnd);
+}
+
 /**
  * Internal: read and validate codeplug header
  *
  * @param header: pointer to the header struct to be populated
  * @return 0 on success, -1 on failure
  */
-int _readHeader(cps_header_t *header)
+static int _readHeader(cps_header_t *header)
 {
     fseek(cps_file, 0L, SEEK_SET);
-    fread(header, sizeof(cps_header_t), 1, cps_file);
+    if(fread(header, sizeof(cps_header_t), 1, cps_file) != 1)
+        return -1;
     // Validate magic number
     if(header->magic != CPS_MAGIC)
         return -1;
@@ -50,183 +657,549 @@ int _readHeader(cps_header_t *header)
 }
 
 /**
- * Internal: write codeplug header
+ * Internal: load the tables of a v0.1 codeplug, assigning to the records the
+ * same IDs they would have in a compacted v0.2 codeplug.
+ *
+ * @return 0 on success, -1 on failure
+ */
+static int _loadV1()
+{
+    uint32_t ctCount = cps_header.ct_count;
+    uint32_t chCount = cps_header.ch_count;
+    uint32_t count   = ctCount + chCount + cps_header.b_count;
+    uint32_t ctStart = sizeof(cps_header_t);
+    uint32_t chStart = ctStart + (ctCount * sizeof(contact_t));
+    uint32_t bOffs   = chStart + (chCount * sizeof(channel_t));
+    uint32_t bStart  = bOffs + (cps_header.b_count * sizeof(uint32_t));
+
+    if((count >= CPS_NO_RECORD) || (_reserveRecords(count) < 0))
+        return -1;
+
+    memset(records, 0x00, count * sizeof(record_t));
+    numRecords = count;
+
+    if((listReserve(&tables[REC_CONTACT], ctCount) < 0) ||
+       (listReserve(&tables[REC_CHANNEL], chCount) < 0) ||
+       (listReserve(&tables[REC_BANK], cps_header.b_count) < 0))
+        return -1;
+
+    for(uint16_t i = 0; i < ctCount; i++)
+    {
+        records[i].type   = REC_CONTACT;
+        records[i].offset = ctStart + (i * sizeof(contact_t));
+        tables[REC_CONTACT].ids[i] = i;
+    }
+
+    for(uint16_t i = 0; i < chCount; i++)
+    {
+        uint16_t id = ctCount + i;
+        records[id].type   = REC_CHANNEL;
+        records[id].offset = chStart + (i * sizeof(channel_t));
+        tables[REC_CHANNEL].ids[i] = id;
+    }
+
+    tables[REC_CONTACT].count = ctCount;
+    tables[REC_CHANNEL].count = chCount;
+
+    for(uint16_t i = 0; i < cps_header.b_count; i++)
+    {
+        uint16_t  id = ctCount + chCount + i;
+        uint32_t  offset;
+        bankHdr_t bank;
+
+        fseek(cps_file, bOffs + (i * sizeof(uint32_t)), SEEK_SET);
+        if(fread(&offset, sizeof(uint32_t), 1, cps_file) != 1)
+            return -1;
+
+        fseek(cps_file, bStart + offset, SEEK_SET);
+        if(fread(&bank, sizeof(bankHdr_t), 1, cps_file) != 1)
+            return -1;
+
+        records[id].type   = REC_BANK;
+        records[id].offset = bStart + offset;
+        tables[REC_BANK].ids[i] = id;
+        tables[REC_BANK].count += 1;
+
+        idList_t *refs = &records[id].refs;
+        if(listReserve(refs, bank.ch_count) < 0)
+            return -1;
+
+        for(uint16_t j = 0; j < bank.ch_count; j++)
+        {
+            uint32_t ch;
+            if(fread(&ch, sizeof(uint32_t), 1, cps_file) != 1)
+                return -1;
+
+            if(ch < chCount)
+                refs->ids[refs->count++] = ctCount + ch;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Internal: load the codeplug snapshot and replay the journal.
  *
- * @param header: header struct to be written
  * @return 0 on success, -1 on failure
  */
-int _writeHeader(cps_header_t header)
+static int _load()
 {
-    fseek(cps_file, 0L, SEEK_SET);
-    fwrite(&header, sizeof(cps_header_t), 1, cps_file);
+    cpsSnapshot_t snapshot;
+    uint8_t       slot[SLOT_SIZE];
+
+    _resetTables();
+
+    if(_readHeader(&cps_header) < 0)
+        return -1;
+
+    if((cps_header.version_number & 0x00ff) < 2)
+    {
+        if(_loadV1() < 0)
+            return -1;
+
+        loaded = true;
+        return 0;
+    }
+
+    if(fread(&snapshot, sizeof(cpsSnapshot_t), 1, cps_file) != 1)
+        return -1;
+
+    if((snapshot.id_count == CPS_NO_RECORD) ||
+       (_reserveRecords(snapshot.id_count) < 0))
+        return -1;
+
+    memset(records, 0x00, snapshot.id_count * sizeof(record_t));
+    numRecords = snapshot.id_count;
+
+    for(uint16_t id = 0; id < numRecords; id++)
+    {
+        if(fread(slot, SLOT_SIZE, 1, cps_file) != 1)
+            return -1;
+
+        records[id].type   = slot[0];
+        records[id].offset = RECORDS_START + (id * SLOT_SIZE) + 1;
+
+        if(slot[0] == REC_FREE)
+            listInsert(&tables[REC_FREE], tables[REC_FREE].count, id);
+    }
+
+    const uint16_t counts[REC_NUM] =
+    {
+        0, cps_header.ct_count, cps_header.ch_count, cps_header.b_count
+    };
+
+    for(uint8_t type = REC_CONTACT; type < REC_NUM; type++)
+    {
+        idList_t *table = &tables[type];
+        if(listReserve(table, counts[type]) < 0)
+            return -1;
+
+        if(fread(table->ids, sizeof(uint16_t), counts[type], cps_file) != counts[type])
+            return -1;
+
+        table->count = counts[type];
+        for(uint16_t i = 0; i < table->count; i++)
+        {
+            if(_isRecord(table->ids[i], type) == false)
+                return -1;
+        }
+    }
+
+    for(uint16_t i = 0; i < cps_header.b_count; i++)
+    {
+        idList_t *refs = &records[tables[REC_BANK].ids[i]].refs;
+        uint16_t  count;
+
+        if(fread(&count, sizeof(uint16_t), 1, cps_file) != 1)
+            return -1;
+
+        if(listReserve(refs, count) < 0)
+            return -1;
+
+        if(fread(refs->ids, sizeof(uint16_t), count, cps_file) != count)
+            return -1;
+
+        refs->count = count;
+        for(uint16_t j = 0; j < count; j++)
+        {
+            if(_isRecord(refs->ids[j], REC_CHANNEL) == false)
+                return -1;
+        }
+    }
+
+    journalStart = snapshot.journal_offset;
+    int ret = _replay();
+    loaded  = true;
+
+    // Discarded entries which cannot be truncated away are removed by writing
+    // a new snapshot, whose journal is empty
+    if(ret < 0)
+        return _compact();
+
     return 0;
 }
 
 /**
- * Internal: push down data at a given offset by a given amount
+ * Internal: flush to disk the directory containing the codeplug, to make
+ * persistent the creation or the renaming of a file inside it.
  *
- * @param offset: offset at which to start to push down data
- * @param amount: amount of free space to be created
  * @return 0 on success, -1 on failure
  */
-
-int _pushDown(uint32_t offset, uint32_t amount)
+static int _syncDir()
 {
-    // Get end of file
-    fseek(cps_file, 0, SEEK_END);
-    long end = ftell(cps_file);
-    // If offset equals end, just return
-    if (offset == end)
-        return 0;
-    // Move data downwards in chunks of fixed size
-    char buffer[CPS_CHUNK_SIZE] = { 0 };
-    for(int i = 1; i <= ((end - offset) / CPS_CHUNK_SIZE); i++)
-    {
-        fseek(cps_file, end - i * CPS_CHUNK_SIZE, SEEK_SET);
-        fread(buffer, CPS_CHUNK_SIZE, 1, cps_file);
-        fseek(cps_file, end - i * CPS_CHUNK_SIZE + amount, SEEK_SET);
-        fwrite(buffer, CPS_CHUNK_SIZE, 1, cps_file);
+    char *dir = strdup(cps_path);
+    if(dir == NULL)
+        return -1;
+
+    const char *path  = ".";
+    char       *slash = strrchr(dir, '/');
+    if(slash == dir)
+    {
+        path = "/";
     }
-    // Once initial offset is reached, move the last incomplete block
-    fseek(cps_file, offset, SEEK_SET);
-    fread(buffer, (end - offset) % CPS_CHUNK_SIZE, 1, cps_file);
-    fseek(cps_file, offset + amount, SEEK_SET);
-    fwrite(buffer, (end - offset) % CPS_CHUNK_SIZE, 1, cps_file);
-    fseek(cps_file, offset, SEEK_SET);
-    return 0;
+    else if(slash != NULL)
+    {
+        *slash = '\0';
+        path   = dir;
+    }
+
+    int ret = -1;
+    int fd  = open(path, O_RDONLY);
+    if(fd >= 0)
+    {
+        ret = fsync(fd);
+        close(fd);
+    }
+
+    free(dir);
+    return ret;
 }
 
 /**
- * Internal: updates the contact numbering after a contact addition or removal
+ * Internal: merge the journal into a new snapshot. The records are renumbered
+ * in table order, contacts first, and dangling contact references are cleared
+ * by setting them to CPS_NO_RECORD.
  *
- * @param pos: position at which the new contact was inserted or removed
- * @param add: if true a contact was inserted, otherwise it was removed
  * @return 0 on success, -1 on failure
  */
-int _updateCtNumbering(uint16_t pos, bool add)
+static int _compact()
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
+    const uint16_t ctCount = tables[REC_CONTACT].count;
+    const uint16_t chCount = tables[REC_CHANNEL].count;
+    const uint16_t bCount  = tables[REC_BANK].count;
+    const uint32_t count   = ctCount + chCount + bCount;
+
+    if(count >= CPS_NO_RECORD)
+        return -1;
+
+    size_t pathLen = strlen(cps_path);
+    char  *tmpPath = (char *) malloc(pathLen + 5);
+    if(tmpPath == NULL)
+        return -1;
+
+    memcpy(tmpPath, cps_path, pathLen);
+    memcpy(tmpPath + pathLen, ".tmp", 5);
+
+    FILE *out = fopen(tmpPath, "w");
+    if(out == NULL)
+    {
+        free(tmpPath);
         return -1;
-    for(int i = 0; i < header.ch_count; i++)
+    }
+
+    _updatePositions(REC_CONTACT);
+    _updatePositions(REC_CHANNEL);
+
+    cps_header_t newHeader = cps_header;
+    newHeader.version_number = CPS_VERSION_MAJOR << 8 | CPS_VERSION_MINOR;
+    newHeader.ct_count = ctCount;
+    newHeader.ch_count = chCount;
+    newHeader.b_count  = bCount;
+
+    uint32_t listSize = count + bCount;
+    for(uint16_t i = 0; i < bCount; i++)
+        listSize += records[tables[REC_BANK].ids[i]].refs.count;
+
+    cpsSnapshot_t snapshot;
+    snapshot.id_count       = count;
+    snapshot.journal_offset = RECORDS_START + (count * SLOT_SIZE)
+                            + (listSize * sizeof(uint16_t));
+
+    bool ok = (fwrite(&newHeader, sizeof(cps_header_t), 1, out) == 1) &&
+              (fwrite(&snapshot, sizeof(cpsSnapshot_t), 1, out) == 1);
+
+    // Records, in table order
+    for(uint8_t type = REC_CONTACT; ok && (type < REC_NUM); type++)
     {
-        channel_t c = { 0 };
-        cps_readChannel(&c, i);
-        if (c.mode == OPMODE_M17 && c.m17.contact_index >= pos)
+        const idList_t *table = &tables[type];
+        for(uint16_t i = 0; ok && (i < table->count); i++)
         {
-            if (add)
-                c.m17.contact_index++;
-            else
-                c.m17.contact_index--;
-            cps_writeChannel(c, i);
+            uint16_t id = table->ids[i];
+            uint8_t  slot[SLOT_SIZE] = { 0 };
+            cpsRecord_t *data = (cpsRecord_t *) &slot[1];
+
+            slot[0] = type;
+            if(_readRecord(id, data) < 0)
+            {
+                ok = false;
+                break;
+            }
+
+            uint16_t ref;
+            if((type == REC_CHANNEL) && _getContactRef(&data->channel, &ref))
+                _setContactRef(&data->channel, _contactPos(ref));
+
+            if(type == REC_BANK)
+                data->bank.ch_count = records[id].refs.count;
+
+            ok = (fwrite(slot, SLOT_SIZE, 1, out) == 1);
         }
-        if (c.mode == OPMODE_DMR && c.dmr.contact_index >= pos)
+    }
+
+    // Tables, with the new IDs
+    for(uint16_t id = 0; ok && (id < count); id++)
+        ok = (fwrite(&id, sizeof(uint16_t), 1, out) == 1);
+
+    for(uint16_t i = 0; ok && (i < bCount); i++)
+    {
+        const idList_t *refs = &records[tables[REC_BANK].ids[i]].refs;
+        ok = (fwrite(&refs->count, sizeof(uint16_t), 1, out) == 1);
+
+        for(uint16_t j = 0; ok && (j < refs->count); j++)
         {
-            if (add)
-                c.dmr.contact_index++;
-            else
-                c.dmr.contact_index--;
-            cps_writeChannel(c, i);
+            uint16_t id = ctCount + records[refs->ids[j]].pos;
+            ok = (fwrite(&id, sizeof(uint16_t), 1, out) == 1);
         }
     }
-    return 0;
+
+    // The new snapshot has to be on disk before replacing the codeplug
+    ok = ok && (fflush(out) == 0) && (fsync(fileno(out)) == 0);
+    fclose(out);
+    ok = ok && (_syncDir() == 0);
+
+    if(ok == false)
+    {
+        remove(tmpPath);
+        free(tmpPath);
+        return -1;
+    }
+
+    fclose(cps_file);
+    int ret = rename(tmpPath, cps_path);
+    free(tmpPath);
+
+    if(ret == 0)
+        _syncDir();
+
+    cps_file = fopen(cps_path, "r+");
+    if(cps_file == NULL)
+    {
+        _resetTables();
+        return -1;
+    }
+
+    // The old codeplug is still in place and the tables are still valid
+    if(ret != 0)
+        return -1;
+
+    return _load();
 }
 
 /**
- * Internal: updates the channel numbering after a channel addition or removal
+ * Internal: append an entry to the journal and apply it.
  *
- * @param pos: position at which the new channel was inserted or removed
- * @param add: if true a channel was inserted, otherwise it was removed
+ * @param entry: journal entry.
+ * @param data: record data, of entry->len bytes.
  * @return 0 on success, -1 on failure
  */
-int _updateChNumbering(uint16_t pos, bool add)
+static int _append(cpsJournalEntry_t *entry, const void *data)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
+    entry->crc = _entryCrc(entry, data);
+
+    fseek(cps_file, journalEnd, SEEK_SET);
+    if(fwrite(entry, sizeof(cpsJournalEntry_t), 1, cps_file) != 1)
         return -1;
-    for(int i = 0; i < header.b_count; i++)
+
+    if((entry->len > 0) && (fwrite(data, entry->len, 1, cps_file) != 1))
+        return -1;
+
+    fflush(cps_file);
+
+    uint32_t prevEnd = journalEnd;
+    uint32_t offset  = journalEnd + sizeof(cpsJournalEntry_t);
+    journalEnd = offset + entry->len;
+
+    // Entry rejected, for example for lack of memory: remove it from the file,
+    // otherwise the replay would stop there and discard all the entries
+    // appended after it.
+    if(_apply(entry, offset) < 0)
     {
-        bankHdr_t b_header = { 0 };
-        cps_readBankHeader(&b_header, i);
-        for(int j = 0; j < b_header.ch_count; j++)
-        {
-            int32_t ch = cps_readBankData(i, j);
-            if (ch >= pos)
-            {
-                if (add)
-                    ch++;
-                else
-                    ch--;
-                cps_writeBankData(ch, i, j);
-            }
-        }
+        journalEnd = prevEnd;
+        ftruncate(fileno(cps_file), journalEnd);
+        return -1;
     }
+
+    // A failed compaction leaves the journal in place, the entry is safe
+    uint32_t journalSize = journalEnd - journalStart;
+    if((journalSize > CONFIG_CPS_JOURNAL_SIZE) && (journalSize > journalStart))
+        _compact();
+
     return 0;
 }
 
+static int _writeRecord(const uint8_t type, const void *data, uint16_t pos)
+{
+    if((loaded == false) || (pos >= tables[type].count))
+        return -1;
+
+    cpsJournalEntry_t entry = { 0 };
+    entry.op   = OP_WRITE;
+    entry.type = type;
+    entry.id   = tables[type].ids[pos];
+    entry.len  = recordSize(type);
+
+    return _append(&entry, data);
+}
+
+static int _insertRecord(const uint8_t type, const void *data, uint16_t pos)
+{
+    if((loaded == false) || (pos > tables[type].count))
+        return -1;
+
+    int id = _nextRecord();
+    if(id < 0)
+        return -1;
+
+    cpsJournalEntry_t entry = { 0 };
+    entry.op   = OP_INSERT;
+    entry.type = type;
+    entry.pos  = pos;
+    entry.id   = id;
+    entry.len  = recordSize(type);
+
+    return _append(&entry, data);
+}
+
+static int _deleteRecord(const uint8_t type, uint16_t pos)
+{
+    if((loaded == false) || (pos >= tables[type].count))
+        return -1;
+
+    cpsJournalEntry_t entry = { 0 };
+    entry.op   = OP_DELETE;
+    entry.type = type;
+    entry.pos  = pos;
+    entry.id   = tables[type].ids[pos];
+
+    return _append(&entry, NULL);
+}
+
+static int _bankRef(const uint8_t op, uint32_t ch, uint16_t bank_pos,
+                    uint16_t pos)
+{
+    if((loaded == false) || (bank_pos >= tables[REC_BANK].count))
+        return -1;
+
+    uint16_t bank = tables[REC_BANK].ids[bank_pos];
+    uint16_t count = records[bank].refs.count;
+
+    if(pos > count)
+        return -1;
+
+    if((op != OP_INSERT_REF) && (pos == count))
+        return -1;
+
+    cpsJournalEntry_t entry = { 0 };
+    entry.op   = op;
+    entry.type = REC_BANK;
+    entry.bank = bank;
+    entry.pos  = pos;
+
+    if(op != OP_DELETE_REF)
+    {
+        if(ch >= tables[REC_CHANNEL].count)
+            return -1;
+
+        entry.id = tables[REC_CHANNEL].ids[ch];
+    }
+
+    return _append(&entry, NULL);
+}
+
 /**
- * Internal: get bank data offset
- *
- * @param pos: position of the bank to be read
- * @return the offset in the file where the bank data is stored, -1 if error
+ * Internal: convert the contact reference of a channel from a position to a
+ * record ID.
  */
-long _getBankDataOffset(uint16_t pos)
+static channel_t _channelToRecord(channel_t channel)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
-        return -1;
-    if (pos >= header.b_count + 1)
-        return -1;
-    if (pos == header.b_count)
-    {
-        // No bank is present, no offset to read
-        if (header.b_count == 0)
-            return ftell(cps_file) +
-                   header.ct_count * sizeof(contact_t) +
-                   header.ch_count * sizeof(channel_t) +
-                   sizeof(uint32_t);
-        // Read last bank offset
-        fseek(cps_file,
-              header.ct_count * sizeof(contact_t) +
-              header.ch_count * sizeof(channel_t) +
-              (header.b_count - 1) * sizeof(uint32_t),
-              SEEK_CUR);
-        uint32_t offset = 0;
-        fread(&offset, sizeof(uint32_t), 1, cps_file);
-        long bdata_pos = ftell(cps_file);
-        bankHdr_t last_bank = { 0 };
-        cps_readBankHeader(&last_bank, header.b_count - 1);
-        return bdata_pos + offset + sizeof(bankHdr_t) + last_bank.ch_count * sizeof(uint32_t);
+    uint16_t ref;
+    if(_getContactRef(&channel, &ref))
+    {
+        if(ref < tables[REC_CONTACT].count)
+            ref = tables[REC_CONTACT].ids[ref];
+        else
+            ref = CPS_NO_RECORD;
+
+        _setContactRef(&channel, ref);
     }
-    fseek(cps_file,
-          header.ct_count * sizeof(contact_t) +
-          header.ch_count * sizeof(channel_t) +
-          pos * sizeof(uint32_t),
-          SEEK_CUR);
-    uint32_t offset = 0;
-    fread(&offset, sizeof(uint32_t), 1, cps_file);
-    return ftell(cps_file) +
-           (header.b_count - pos - 1) * sizeof(uint32_t) +
-           offset;
+
+    return channel;
 }
 
 int cps_open(char *cps_name)
 {
+    cpsCache_invalidate();
+
     if (!cps_name)
         cps_name = "default.rtxc";
     cps_file = fopen(cps_name, "r+");
     if (!cps_file)
         return -1;
+
+    free(cps_path);
+    cps_path = strdup(cps_name);
+    if (!cps_path)
+        return -1;
+
+    // Damaged codeplugs are left untouched and all the accesses fail
+    if (_load() < 0)
+    {
+        _resetTables();
+        return 0;
+    }
+
+    // Convert codeplugs in the previous format
+    if ((cps_header.version_number & 0x00ff) < CPS_VERSION_MINOR)
+    {
+        if (_compact() < 0)
+            _resetTables();
+    }
+
     return 0;
 }
 
 void cps_close()
 {
-    fclose(cps_file);
+    cpsCache_invalidate();
+
+    if (!cps_file)
+        return;
+
+    if (loaded && (journalEnd > journalStart))
+        _compact();
+
+    _resetTables();
+    if (cps_file)
+        fclose(cps_file);
+
+    cps_file = NULL;
 }
 
 int cps_create(char *cps_name)
 {
+    cpsCache_invalidate();
+
     // Clear or create cps file
     FILE *new_cps = NULL;
     if (!cps_name)
@@ -246,257 +1219,193 @@ int cps_create(char *cps_name)
     header.ch_count = 0;
     header.b_count = 0;
     fwrite(&header, sizeof(cps_header_t), 1, new_cps);
+    // Write an empty snapshot
+    cpsSnapshot_t snapshot = { 0 };
+    snapshot.journal_offset = RECORDS_START;
+    fwrite(&snapshot, sizeof(cpsSnapshot_t), 1, new_cps);
     fclose(new_cps);
     return 0;
 }
 
 int cps_readContact(contact_t *contact, uint16_t pos)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
-        return -1;
-    if (pos >= header.ct_count)
+    if (!loaded || (pos >= tables[REC_CONTACT].count))
         return -1;
-    fseek(cps_file, pos * sizeof(contact_t), SEEK_CUR);
-    fread(contact, sizeof(contact_t), 1, cps_file);
-    return 0;
+
+    return _readRecord(tables[REC_CONTACT].ids[pos], contact);
 }
 
 int cps_readChannel(channel_t *channel, uint16_t pos)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
+    if (!loaded || (pos >= tables[REC_CHANNEL].count))
         return -1;
-    if (pos >= header.ch_count)
+
+    if (_readRecord(tables[REC_CHANNEL].ids[pos], channel) < 0)
         return -1;
-    fseek(cps_file,
-          header.ct_count * sizeof(contact_t) +
-          pos * sizeof(channel_t),
-          SEEK_CUR);
-    fread(channel, sizeof(channel_t), 1, cps_file);
+
+    uint16_t ref;
+    if (_getContactRef(channel, &ref))
+        _setContactRef(channel, _contactPos(ref));
+
     return 0;
 }
 
 int cps_readBankHeader(bankHdr_t *b_header, uint16_t pos)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
-        return -1;
-    if (pos >= header.b_count)
-        return -1;
-    fseek(cps_file,
-          header.ct_count * sizeof(contact_t) +
-          header.ch_count * sizeof(channel_t) +
-          pos * sizeof(uint32_t),
-          SEEK_CUR);
-    uint32_t offset = 0;
-    fread(&offset, sizeof(uint32_t), 1, cps_file);
-    fseek(cps_file, (header.b_count - pos - 1) * sizeof(uint32_t) + offset, SEEK_CUR);
-    fread(b_header, sizeof(bankHdr_t), 1, cps_file);
+    if (!loaded || (pos >= tables[REC_BANK].count))
+        return -1;
+
+    uint16_t id = tables[REC_BANK].ids[pos];
+    if (_readRecord(id, b_header) < 0)
+        return -1;
+
+    b_header->ch_count = records[id].refs.count;
     return 0;
 }
 
 int cps_readBankData(uint16_t bank_pos, uint16_t pos)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
+    if (!loaded || (bank_pos >= tables[REC_BANK].count))
         return -1;
-    if (bank_pos >= header.b_count)
-        return -1;
-    fseek(cps_file,
-          header.ct_count * sizeof(contact_t) +
-          header.ch_count * sizeof(channel_t) +
-          bank_pos * sizeof(uint32_t),
-          SEEK_CUR);
-    uint32_t offset = 0;
-    fread(&offset, sizeof(uint32_t), 1, cps_file);
-    fseek(cps_file, (header.b_count - bank_pos - 1) * sizeof(uint32_t) + offset, SEEK_CUR);
-    bankHdr_t b_header = { 0 };
-    fread(&b_header, sizeof(bankHdr_t), 1, cps_file);
-    if (pos >= b_header.ch_count)
+
+    const idList_t *refs = &records[tables[REC_BANK].ids[bank_pos]].refs;
+    if (pos >= refs->count)
         return -1;
-    fseek(cps_file, pos * sizeof(uint32_t), SEEK_CUR);
-    uint32_t ch_index = 0;
-    fread(&ch_index, sizeof(uint32_t), 1, cps_file);
-    return ch_index;
+
+    _updatePositions(REC_CHANNEL);
+    return records[refs->ids[pos]].pos;
 }
 
-int cps_writeContact(contact_t contact, uint16_t pos)
+int cps_readContacts(contact_t *contacts, uint16_t first, uint16_t count)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
+    return _readRecords(REC_CONTACT, contacts, first, count);
+}
+
+int cps_readChannels(channel_t *channels, uint16_t first, uint16_t count)
+{
+    int ret = _readRecords(REC_CHANNEL, channels, first, count);
+
+    for(int i = 0; i < ret; i++)
+    {
+        uint16_t ref;
+        if (_getContactRef(&channels[i], &ref))
+            _setContactRef(&channels[i], _contactPos(ref));
+    }
+
+    return ret;
+}
+
+int cps_readBankChannels(uint16_t *channels, uint16_t bank_pos, uint16_t first,
+                         uint16_t count)
+{
+    if (!loaded || (bank_pos >= tables[REC_BANK].count))
         return -1;
-    if (pos >= header.ct_count)
+
+    const idList_t *refs = &records[tables[REC_BANK].ids[bank_pos]].refs;
+    if (first >= refs->count)
         return -1;
-    fseek(cps_file, pos * sizeof(contact_t), SEEK_CUR);
-    fwrite(&contact, sizeof(contact_t), 1, cps_file);
-    return 0;
+
+    if (count > (refs->count - first))
+        count = refs->count - first;
+
+    _updatePositions(REC_CHANNEL);
+    for (uint16_t i = 0; i < count; i++)
+        channels[i] = records[refs->ids[first + i]].pos;
+
+    return count;
+}
+
+int cps_writeContact(contact_t contact, uint16_t pos)
+{
+    cpsCache_invalidate();
+
+    return _writeRecord(REC_CONTACT, &contact, pos);
 }
 
 int cps_writeChannel(channel_t channel, uint16_t pos)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
-        return -1;
-    if (pos >= header.ch_count)
+    cpsCache_invalidate();
+
+    if (!loaded)
         return -1;
-    fseek(cps_file,
-          header.ct_count * sizeof(contact_t) +
-          pos * sizeof(channel_t),
-          SEEK_CUR);
-    fwrite(&channel, sizeof(channel_t), 1, cps_file);
-    return 0;
+
+    channel = _channelToRecord(channel);
+    return _writeRecord(REC_CHANNEL, &channel, pos);
 }
 
 int cps_writeBankHeader(bankHdr_t b_header, uint16_t pos)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
-        return -1;
-    if (pos >= header.b_count)
-        return -1;
-    fseek(cps_file,
-          header.ct_count * sizeof(contact_t) +
-          header.ch_count * sizeof(channel_t) +
-          pos * sizeof(uint32_t),
-          SEEK_CUR);
-    uint32_t offset = 0;
-    fread(&offset, sizeof(uint32_t), 1, cps_file);
-    fseek(cps_file, header.b_count - pos * sizeof(uint32_t) + offset, SEEK_CUR);
-    fwrite(&b_header, sizeof(bankHdr_t), 1, cps_file);
-    return 0;
+    cpsCache_invalidate();
+
+    return _writeRecord(REC_BANK, &b_header, pos);
 }
 
 int cps_writeBankData(uint32_t ch, uint16_t bank_pos, uint16_t pos)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
-        return -1;
-    if (pos >= header.b_count + 1)
-        return -1;
-    fseek(cps_file,
-          header.ct_count * sizeof(contact_t) +
-          header.ch_count * sizeof(channel_t) +
-          bank_pos * sizeof(uint32_t),
-          SEEK_CUR);
-    uint32_t offset = 0;
-    fread(&offset, sizeof(uint32_t), 1, cps_file);
-    fseek(cps_file, (header.b_count - bank_pos - 1) * sizeof(uint32_t) + offset, SEEK_CUR);
-    bankHdr_t b_header = { 0 };
-    fread(&b_header, sizeof(bankHdr_t), 1, cps_file);
-    if (pos >= b_header.ch_count)
-        return -1;
-    fseek(cps_file, pos * sizeof(uint32_t), SEEK_CUR);
-    fwrite(&ch, sizeof(uint32_t), 1, cps_file);
-    return 0;
+    cpsCache_invalidate();
+
+    return _bankRef(OP_WRITE_REF, ch, bank_pos, pos);
 }
 
 int cps_insertContact(contact_t contact, uint16_t pos)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
-        return -1;
-    if (pos >= header.ct_count + 1)
-        return -1;
-    long ct_pos = ftell(cps_file) + pos * sizeof(contact_t);
-    _pushDown(ct_pos, sizeof(contact_t));
-    fwrite(&contact, sizeof(contact_t), 1, cps_file);
-    header.ct_count++;
-    _writeHeader(header);
-    if (_updateCtNumbering(pos, true))
-        return -1;
-    return 0;
+    cpsCache_invalidate();
+
+    return _insertRecord(REC_CONTACT, &contact, pos);
 }
 
 int cps_insertChannel(channel_t channel, uint16_t pos)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
-        return -1;
-    if (pos >= header.ch_count + 1)
-        return -1;
-    long ch_pos = ftell(cps_file) +
-                  header.ct_count * sizeof(contact_t) +
-                  pos * sizeof(channel_t);
-    _pushDown(ch_pos, sizeof(channel_t));
-    fwrite(&channel, sizeof(channel_t), 1, cps_file);
-    header.ch_count++;
-    _writeHeader(header);
-    _updateChNumbering(pos, true);
-    return 0;
+    cpsCache_invalidate();
+
+    if (!loaded)
+        return -1;
+
+    channel = _channelToRecord(channel);
+    return _insertRecord(REC_CHANNEL, &channel, pos);
 }
 
 int cps_insertBankHeader(bankHdr_t b_header, uint16_t pos)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
-        return -1;
-    if (pos >= header.b_count + 1)
-        return -1;
-    fseek(cps_file,
-          header.ct_count * sizeof(contact_t) +
-          header.ch_count * sizeof(channel_t) +
-          pos * sizeof(uint32_t),
-          SEEK_CUR);
-    long b_offset_pos = ftell(cps_file);
-    uint32_t b_offset = _getBankDataOffset(pos) - _getBankDataOffset(0);
-    // Read position of the new offset
-    _pushDown(b_offset_pos, sizeof(uint32_t));
-    fwrite(&b_offset, sizeof(uint32_t), 1, cps_file);
-    // Update all the offsets following the moved bank
-    for(int i = 0; i < header.b_count - pos; i++)
-    {
-        long p = ftell(cps_file);
-        uint32_t o = 0;
-        fread(&o, sizeof(uint32_t), 1, cps_file);
-        fseek(cps_file, p, SEEK_SET);
-        o += sizeof(bankHdr_t);
-        fwrite(&o, sizeof(uint32_t), 1, cps_file);
-    }
-    header.b_count++;
-    _writeHeader(header);
-    _pushDown(_getBankDataOffset(pos), sizeof(bankHdr_t));
-    fwrite(&b_header, sizeof(bankHdr_t), 1, cps_file);
-    return 0;
+    cpsCache_invalidate();
+
+    b_header.ch_count = 0;
+    return _insertRecord(REC_BANK, &b_header, pos);
 }
 
 int cps_insertBankData(uint32_t ch, uint16_t bank_pos, uint16_t pos)
 {
-    cps_header_t header = { 0 };
-    if (_readHeader(&header))
-        return -1;
-    if (bank_pos >= header.b_count)
-        return -1;
-    fseek(cps_file,
-          header.ct_count * sizeof(contact_t) +
-          header.ch_count * sizeof(channel_t) +
-          bank_pos * sizeof(uint32_t),
-          SEEK_CUR);
-    uint32_t offset = 0;
-    fread(&offset, sizeof(uint32_t), 1, cps_file);
-    // Update all the offsets following the moved bank
-    for(int i = 0; i < header.b_count - bank_pos - 1; i++)
-    {
-        long p = ftell(cps_file);
-        uint32_t o = 0;
-        fread(&o, sizeof(uint32_t), 1, cps_file);
-        fseek(cps_file, p, SEEK_SET);
-        o += sizeof(uint32_t);
-        fwrite(&o, sizeof(uint32_t), 1, cps_file);
-    }
-    // Update bank header
-    fseek(cps_file, offset, SEEK_CUR);
-    bankHdr_t b_header = { 0 };
-    long h_pos = ftell(cps_file);
-    fread(&b_header, sizeof(bankHdr_t), 1, cps_file);
-    if (pos >= b_header.ch_count + 1)
-        return -1;
-    b_header.ch_count++;
-    fseek(cps_file, h_pos, SEEK_SET);
-    fwrite(&b_header, sizeof(bankHdr_t), 1, cps_file);
-    fseek(cps_file, pos * sizeof(uint32_t), SEEK_CUR);
-    long p = ftell(cps_file);
-    _pushDown(p, sizeof(uint32_t));
-    fwrite(&ch, sizeof(uint32_t), 1, cps_file);
-    return 0;
+    cpsCache_invalidate();
+
+    return _bankRef(OP_INSERT_REF, ch, bank_pos, pos);
+}
+
+int cps_deleteContact(uint16_t pos)
+{
+    cpsCache_invalidate();
+
+    return _deleteRecord(REC_CONTACT, pos);
+}
+
+int cps_deleteChannel(channel_t channel, uint16_t pos)
+{
+    (void) channel;
+
+    cpsCache_invalidate();
+
+    return _deleteRecord(REC_CHANNEL, pos);
+}
+
+int cps_deleteBankHeader(uint16_t pos)
+{
+    cpsCache_invalidate();
+
+    return _deleteRecord(REC_BANK, pos);
+}
+
+int cps_deleteBankData(uint16_t bank_pos, uint16_t pos)
+{
+    cpsCache_invalidate();
+
+    return _bankRef(OP_DELETE_REF, 0, bank_pos, pos);
 }
@@ -27,6 +27,7 @@
 #include "AT24Cx.h"
 #include "W25Qx.h"
 #include "cps_data_GDx.h"
+#include "cps_batch.h"
 
 //static const uint32_t zoneBaseAddr        = 0x149e0;  /**< Base address of zones                */
 //static const uint32_t vfoChannelBaseAddr  = 0x7590;   /**< Base address of VFO channel          */
@@ -56,100 +57,72 @@ static void _addStringTerminator(char *buf, uint8_t max_len)
 
 
 /**
- * This function does not apply to address-based codeplugs
- */
-int cps_open(char *cps_name)
-{
-
-    (void) cps_name;
-    return 0;
-}
-
-/**
- * This function does not apply to address-based codeplugs
+ * Read the bitmap of the valid channels of a 128-channel bank
  */
-void cps_close()
+static void _readChannelBitmap(uint8_t bank_num, uint8_t *bitmap)
 {
+    // First channel bank (128 channels) is saved in EEPROM
+    if(bank_num == 0)
+    {
+        uint32_t readAddr = channelBaseAddrEEPROM + bank_num * sizeof(gdxChannelBank_t);
+        AT24Cx_readData(readAddr, bitmap, 16);
+    }
+    // Remaining 7 channel banks (896 channels) are saved in SPI Flash
+    else
+    {
+        uint32_t readAddr = channelBaseAddrFlash + (bank_num - 1) * sizeof(gdxChannelBank_t);
+        nvm_devRead(&eflash, readAddr, bitmap, 16);
+    }
 }
 
 /**
- * This function does not apply to address-based codeplugs
+ * Read the data of consecutive channels, all belonging to the same bank
  */
-int cps_create(char *cps_name)
+static void _readChannelData(uint16_t pos, void *buf, size_t len)
 {
-    (void) cps_name;
-    return 0;
-}
-
-int cps_readChannel(channel_t *channel, uint16_t pos)
-{
-    if(pos >= maxNumChannels)
-        return -1;
-
-    memset(channel, 0x00, sizeof(channel_t));
-
-    // Channels are organized in 128-channel banks
     uint8_t bank_num = pos / 128;
-    uint8_t bank_channel = pos % 128;
-
-    // ### Read channel bank bitmap ###
-    uint8_t bitmap[16];
+    uint32_t channelOffset = 16 + pos * sizeof(gdxChannel_t);
     // First channel bank (128 channels) is saved in EEPROM
     if(pos < 128)
     {
-        uint32_t readAddr = channelBaseAddrEEPROM + bank_num * sizeof(gdxChannelBank_t);
-        AT24Cx_readData(readAddr, ((uint8_t *) &bitmap), sizeof(bitmap));
+        uint32_t bankAddr = channelBaseAddrEEPROM + bank_num * sizeof(gdxChannelBank_t);
+        AT24Cx_readData(bankAddr + channelOffset, buf, len);
     }
     // Remaining 7 channel banks (896 channels) are saved in SPI Flash
     else
     {
-        uint32_t readAddr = channelBaseAddrFlash + (bank_num - 1) * sizeof(gdxChannelBank_t);
-        nvm_devRead(&eflash, readAddr, ((uint8_t *) &bitmap), sizeof(bitmap));
-    }
-    uint8_t bitmap_byte = bank_channel / 8;
-    uint8_t bitmap_bit = bank_channel % 8;
-    gdxChannel_t chData;
-    // The channel is marked not valid in the bitmap
-    if(!(bitmap[bitmap_byte] & (1 << bitmap_bit)))
-        return -1;
-    // The channel is marked valid in the bitmap
-    // ### Read desired channel from the correct bank ###
-    else
-    {
-        uint32_t channelOffset = sizeof(bitmap) + pos * sizeof(gdxChannel_t);
-        // First channel bank (128 channels) is saved in EEPROM
-        if(pos < 128)
-        {
-            uint32_t bankAddr = channelBaseAddrEEPROM + bank_num * sizeof(gdxChannelBank_t);
-            AT24Cx_readData(bankAddr + channelOffset, ((uint8_t *) &chData), sizeof(gdxChannel_t));
-        }
-        // Remaining 7 channel banks (896 channels) are saved in SPI Flash
-        else
-        {
-            uint32_t bankAddr = channelBaseAddrFlash + bank_num * sizeof(gdxChannelBank_t);
-            nvm_devRead(&eflash, bankAddr + channelOffset, ((uint8_t *) &chData), sizeof(gdxChannel_t));
-        }
+        uint32_t bankAddr = channelBaseAddrFlash + bank_num * sizeof(gdxChannelBank_t);
+        nvm_devRead(&eflash, bankAddr + channelOffset, buf, len);
     }
+}
+
+/**
+ * Convert channel data into a channel_t struct
+ */
+static void _loadChannel(channel_t *channel, const gdxChannel_t *chData)
+{
+    memset(channel, 0x00, sizeof(channel_t));
+
     // Copy data to OpenRTX channel_t
-    channel->mode            = chData.channel_mode + 1;
-    channel->bandwidth       = chData.bandwidth;
-    channel->rx_only         = chData.rx_only;
-    channel->power           = ((chData.power == 1) ? 5000 : 1000); // 5W or 1W
-    channel->rx_frequency    = bcdToBin(chData.rx_frequency) * 10;
-    channel->tx_frequency    = bcdToBin(chData.tx_frequency) * 10;
-    channel->scanList_index  = chData.scan_list_index;
-    channel->groupList_index = chData.group_list_index;
-    memcpy(channel->name, chData.name, sizeof(chData.name));
+    channel->mode            = chData->channel_mode + 1;
+    channel->bandwidth       = chData->bandwidth;
+    channel->rx_only         = chData->rx_only;
+    channel->power           = ((chData->power == 1) ? 5000 : 1000); // 5W or 1W
+    channel->rx_frequency    = bcdToBin(chData->rx_frequency) * 10;
+    channel->tx_frequency    = bcdToBin(chData->tx_frequency) * 10;
+    channel->scanList_index  = chData->scan_list_index;
+    channel->groupList_index = chData->group_list_index;
+    memcpy(channel->name, chData->name, sizeof(chData->name));
     // Terminate string with 0x00 instead of 0xFF
-    _addStringTerminator(channel->name, sizeof(chData.name));
+    _addStringTerminator(channel->name, sizeof(chData->name));
 
     /* Load mode-specific parameters */
     if(channel->mode == OPMODE_FM)
     {
         channel->fm.txToneEn = 0;
         channel->fm.rxToneEn = 0;
-        uint16_t rx_css = chData.ctcss_dcs_receive;
-        uint16_t tx_css = chData.ctcss_dcs_transmit;
+        uint16_t rx_css = chData->ctcss_dcs_receive;
+        uint16_t tx_css = chData->ctcss_dcs_transmit;
 
         // TODO: Implement binary search to speed up this lookup
         if((rx_css != 0) && (rx_css != 0xFFFF))
@@ -182,11 +155,92 @@ int cps_readChannel(channel_t *channel, uint16_t pos)
     }
     else if(channel->mode == OPMODE_DMR)
     {
-        channel->dmr.contact_index = chData.contact_name_index;
-        channel->dmr.dmr_timeslot      = chData.repeater_slot;
-        channel->dmr.rxColorCode       = chData.colorcode_rx;
-        channel->dmr.txColorCode       = chData.colorcode_tx;
+        channel->dmr.contact_index = chData->contact_name_index;
+        channel->dmr.dmr_timeslot      = chData->repeater_slot;
+        channel->dmr.rxColorCode       = chData->colorcode_rx;
+        channel->dmr.txColorCode       = chData->colorcode_tx;
     }
+}
+
+/**
+ * Convert contact data into a contact_t struct
+ */
+static int _loadContact(contact_t *contact, const gdxContact_t *contactData)
+{
+    // Check if contact is empty
+    if(wcslen((const wchar_t *) contactData->name) == 0) return -1;
+
+    // Copy contact name
+    memcpy(contact->name, contactData->name, sizeof(contactData->name));
+    // Terminate string with 0x00 instead of 0xFF
+    _addStringTerminator(contact->name, sizeof(contactData->name));
+
+    contact->mode = OPMODE_DMR;
+
+    // Copy contact DMR ID
+    contact->info.dmr.id = contactData->id[0]
+                         | (contactData->id[1] << 8)
+                         | (contactData->id[2] << 16);
+
+    // Copy contact details
+    contact->info.dmr.contactType = contactData->type;
+    contact->info.dmr.rx_tone     = contactData->receive_tone ? true : false;
+
+    return 0;
+}
+
+/**
+ * This function does not apply to address-based codeplugs
+ */
+int cps_open(char *cps_name)
+{
+
+    (void) cps_name;
+    return 0;
+}
+
+/**
+ * This function does not apply to address-based codeplugs
+ */
+void cps_close()
+{
+}
+
+/**
+ * This function does not apply to address-based codeplugs
+ */
+int cps_create(char *cps_name)
+{
+    (void) cps_name;
+    return 0;
+}
+
+int cps_readChannel(channel_t *channel, uint16_t pos)
+{
+    if(pos >= maxNumChannels)
+        return -1;
+
+    // Channels are organized in 128-channel banks
+    uint8_t bank_num = pos / 128;
+    uint8_t bank_channel = pos % 128;
+
+    // ### Read channel bank bitmap ###
+    uint8_t bitmap[16];
+    _readChannelBitmap(bank_num, bitmap);
+    uint8_t bitmap_byte = bank_channel / 8;
+    uint8_t bitmap_bit = bank_channel % 8;
+    gdxChannel_t chData;
+    // The channel is marked not valid in the bitmap
+    if(!(bitmap[bitmap_byte] & (1 << bitmap_bit)))
+        return -1;
+    // The channel is marked valid in the bitmap
+    // ### Read desired channel from the correct bank ###
+    else
+    {
+        _readChannelData(pos, &chData, sizeof(gdxChannel_t));
+    }
+
+    _loadChannel(channel, &chData);
     return 0;
 }
 
@@ -246,24 +300,104 @@ int cps_readContact(contact_t *contact, uint16_t pos)
     uint32_t contactAddr = contactBaseAddr + pos * sizeof(gdxContact_t);
     nvm_devRead(&eflash, contactAddr, ((uint8_t *) &contactData), sizeof(gdxContact_t));
 
-    // Check if contact is empty
-    if(wcslen((wchar_t *) contactData.name) == 0) return -1;
+    return _loadContact(contact, &contactData);
+}
 
-    // Copy contact name
-    memcpy(contact->name, contactData.name, sizeof(contactData.name));
-    // Terminate string with 0x00 instead of 0xFF
-    _addStringTerminator(contact->name, sizeof(contactData.name));
+_Static_assert((sizeof(gdxChannel_t) <= sizeof(channel_t)) &&
+               (sizeof(gdxContact_t) <= sizeof(contact_t)),
+               "Raw codeplug entries must fit in the batched read buffers");
 
-    contact->mode = OPMODE_DMR;
+int cps_readContacts(contact_t *contacts, uint16_t first, uint16_t count)
+{
+    if(first >= maxNumContacts) return -1;
+    if(count > (maxNumContacts - first)) count = maxNumContacts - first;
 
-    // Copy contact DMR ID
-    contact->info.dmr.id = contactData.id[0]
-                         | (contactData.id[1] << 8)
-                         | (contactData.id[2] << 16);
+    gdxContact_t *raw = cps_rawBuffer(contacts, sizeof(contact_t),
+                                      sizeof(gdxContact_t), count);
+    uint32_t contactAddr = contactBaseAddr + first * sizeof(gdxContact_t);
+    nvm_devRead(&eflash, contactAddr, ((uint8_t *) raw), count * sizeof(gdxContact_t));
 
-    // Copy contact details
-    contact->info.dmr.contactType = contactData.type;
-    contact->info.dmr.rx_tone     = contactData.receive_tone ? true : false;
+    uint16_t i;
+    for(i = 0; i < count; i++)
+    {
+        gdxContact_t contactData = raw[i];
+        if(_loadContact(&contacts[i], &contactData) < 0)
+            break;
+    }
 
-    return 0;
+    return (i > 0) ? i : -1;
+}
+
+int cps_readChannels(channel_t *channels, uint16_t first, uint16_t count)
+{
+    if(first >= maxNumChannels) return -1;
+    if(count > (maxNumChannels - first)) count = maxNumChannels - first;
+
+    // One read for each 128-channel bank, up to the first channel not valid
+    uint16_t done = 0;
+    while(done < count)
+    {
+        uint16_t pos = first + done;
+        uint8_t bank_num = pos / 128;
+        uint16_t num = 128 - (pos % 128);
+        if(num > (count - done))
+            num = count - done;
+
+        uint8_t bitmap[16];
+        _readChannelBitmap(bank_num, bitmap);
+
+        uint16_t valid = 0;
+        while(valid < num)
+        {
+            uint8_t bank_channel = (pos + valid) % 128;
+            if(!(bitmap[bank_channel / 8] & (1 << (bank_channel % 8))))
+                break;
+
+            valid++;
+        }
+
+        gdxChannel_t *raw = cps_rawBuffer(&channels[done], sizeof(channel_t),
+                                          sizeof(gdxChannel_t), valid);
+        _readChannelData(pos, raw, valid * sizeof(gdxChannel_t));
+
+        for(uint16_t i = 0; i < valid; i++)
+        {
+            gdxChannel_t chData = raw[i];
+            _loadChannel(&channels[done + i], &chData);
+        }
+
+        done += valid;
+        if(valid < num)
+            break;
+    }
+
+    return (done > 0) ? done : -1;
+}
+
+int cps_readBankChannels(uint16_t *channels, uint16_t bank_pos, uint16_t first,
+                         uint16_t count)
+{
+    if(bank_pos >= maxNumZones) return -1;
+
+    // ### Read bank bank bitmap ###
+    uint8_t bitmap[32];
+    AT24Cx_readData(zoneBaseAddr, ((uint8_t *) &bitmap), sizeof(bitmap));
+
+    uint8_t bitmap_byte = bank_pos / 8;
+    uint8_t bitmap_bit = bank_pos % 8;
+    // The bank is marked not valid in the bitmap
+    if(!(bitmap[bitmap_byte] & (1 << bitmap_bit))) return -1;
+
+    gdxZone_t zoneData;
+    uint32_t zoneAddr = zoneBaseAddr + sizeof(bitmap) + bank_pos * sizeof(gdxZone_t);
+    AT24Cx_readData(zoneAddr, ((uint8_t *) &zoneData), sizeof(gdxZone_t));
+
+    // Check if bank is empty
+    if(wcslen((wchar_t *) zoneData.name) == 0) return -1;
+
+    uint16_t i;
+    for(i = 0; (i < count) && ((first + i) < 80); i++)
+        channels[i] = zoneData.member[first + i];
+
+    return (i > 0) ? i : -1;
 }
@@ -25,6 +25,7 @@
 #include <wchar.h>
 #include <utils.h>
 #include "cps_data_MD3x0.h"
+#include "cps_batch.h"
 #include "W25Qx.h"
 
 extern const struct nvmDevice eflash;
@@ -43,49 +44,20 @@ static inline void W25Qx_readData(uint32_t addr, void *buf, size_t len)
 
 
 /**
- * This function does not apply to address-based codeplugs
- */
-int cps_open(char *cps_name)
-{
-
-    (void) cps_name;
-    return 0;
-}
-
-/**
- * This function does not apply to address-based codeplugs
- */
-void cps_close()
-{
-}
-
-/**
- * This function does not apply to address-based codeplugs
+ * Used to convert channel data read from SPI flash into a channel_t struct
  */
-int cps_create(char *cps_name)
-{
-    (void) cps_name;
-    return 0;
-}
-
-int cps_readChannel(channel_t *channel, uint16_t pos)
+static void _loadChannel(channel_t *channel, const md3x0Channel_t *chData)
 {
-    if(pos >= maxNumChannels) return -1;
-
     memset(channel, 0x00, sizeof(channel_t));
 
-    md3x0Channel_t chData;
-    uint32_t readAddr = chDataBaseAddr + pos * sizeof(md3x0Channel_t);
-    W25Qx_readData(readAddr, ((uint8_t *) &chData), sizeof(md3x0Channel_t));
-
-    channel->mode            = chData.channel_mode;
-    channel->bandwidth       = (chData.bandwidth == 0) ? 0 : 1;     // Consider 20kHz as 25kHz
-    channel->rx_only         = chData.rx_only;
-    channel->power           = ((chData.power == 1) ? 5000 : 1000); // 5W or 1W
-    channel->rx_frequency    = bcdToBin(chData.rx_frequency) * 10;
-    channel->tx_frequency    = bcdToBin(chData.tx_frequency) * 10;
-    channel->scanList_index  = chData.scan_list_index;
-    channel->groupList_index = chData.group_list_index;
+    channel->mode            = chData->channel_mode;
+    channel->bandwidth       = (chData->bandwidth == 0) ? 0 : 1;     // Consider 20kHz as 25kHz
+    channel->rx_only         = chData->rx_only;
+    channel->power           = ((chData->power == 1) ? 5000 : 1000); // 5W or 1W
+    channel->rx_frequency    = bcdToBin(chData->rx_frequency) * 10;
+    channel->tx_frequency    = bcdToBin(chData->tx_frequency) * 10;
+    channel->scanList_index  = chData->scan_list_index;
+    channel->groupList_index = chData->group_list_index;
 
     /*
      * Brutally convert channel name from unicode to char by truncating the most
@@ -93,7 +65,7 @@ int cps_readChannel(channel_t *channel, uint16_t pos)
      */
     for(uint16_t i = 0; i < 16; i++)
     {
-        channel->name[i] = ((char) (chData.name[i] & 0x00FF));
+        channel->name[i] = ((char) (chData->name[i] & 0x00FF));
     }
 
     /* Load mode-specific parameters */
@@ -101,8 +73,8 @@ int cps_readChannel(channel_t *channel, uint16_t pos)
     {
         channel->fm.txToneEn = 0;
         channel->fm.rxToneEn = 0;
-        uint16_t rx_css = chData.ctcss_dcs_receive;
-        uint16_t tx_css = chData.ctcss_dcs_transmit;
+        uint16_t rx_css = chData->ctcss_dcs_receive;
+        uint16_t tx_css = chData->ctcss_dcs_transmit;
 
         // TODO: Implement binary search to speed up this lookup
         if((rx_css != 0) && (rx_css != 0xFFFF))
@@ -135,12 +107,79 @@ int cps_readChannel(channel_t *channel, uint16_t pos)
     }
     else if(channel->mode == OPMODE_DMR)
     {
-        channel->dmr.contact_index = chData.contact_name_index;
-        channel->dmr.dmr_timeslot      = chData.repeater_slot;
-        channel->dmr.rxColorCode       = chData.colorcode;
-        channel->dmr.txColorCode       = chData.colorcode;
+        channel->dmr.contact_index = chData->contact_name_index;
+        channel->dmr.dmr_timeslot      = chData->repeater_slot;
+        channel->dmr.rxColorCode       = chData->colorcode;
+        channel->dmr.txColorCode       = chData->colorcode;
+    }
+}
+
+/**
+ * Used to convert contact data read from SPI flash into a contact_t struct
+ */
+static int _loadContact(contact_t *contact, const md3x0Contact_t *contactData)
+{
+    // Check if contact is empty
+    #pragma GCC diagnostic ignored "-Waddress-of-packed-member"
+    if(wcslen((const wchar_t *) contactData->name) == 0) return -1;
+    /*
+     * Brutally convert channel name from unicode to char by truncating the most
+     * significant byte
+     */
+    for(uint16_t i = 0; i < 16; i++)
+    {
+        contact->name[i] = ((char) (contactData->name[i] & 0x00FF));
     }
 
+    contact->mode = OPMODE_DMR;
+
+    // Copy contact DMR ID
+    contact->info.dmr.id = contactData->id[0]
+                         | (contactData->id[1] << 8)
+                         | (contactData->id[2] << 16);
+
+    // Copy contact details
+    contact->info.dmr.contactType = contactData->type;
+    contact->info.dmr.rx_tone     = contactData->receive_tone ? true : false;
+
+    return 0;
+}
+
+/**
+ * This function does not apply to address-based codeplugs
+ */
+int cps_open(char *cps_name)
+{
+
+    (void) cps_name;
+    return 0;
+}
+
+/**
+ * This function does not apply to address-based codeplugs
+ */
+void cps_close()
+{
+}
+
+/**
+ * This function does not apply to address-based codeplugs
+ */
+int cps_create(char *cps_name)
+{
+    (void) cps_name;
+    return 0;
+}
+
+int cps_readChannel(channel_t *channel, uint16_t pos)
+{
+    if(pos >= maxNumChannels) return -1;
+
+    md3x0Channel_t chData;
+    uint32_t readAddr = chDataBaseAddr + pos * sizeof(md3x0Channel_t);
+    W25Qx_readData(readAddr, ((uint8_t *) &chData), sizeof(md3x0Channel_t));
+
+    _loadChannel(channel, &chData);
     return 0;
 }
 
@@ -194,28 +233,76 @@ int cps_readContact(contact_t *contact, uint16_t pos)
     uint32_t contactAddr = contactBaseAddr + pos * sizeof(md3x0Contact_t);
     W25Qx_readData(contactAddr, ((uint8_t *) &contactData), sizeof(md3x0Contact_t));
 
-    // Check if contact is empty
-    #pragma GCC diagnostic ignored "-Waddress-of-packed-member"
-    if(wcslen((wchar_t *) contactData.name) == 0) return -1;
-    /*
-     * Brutally convert channel name from unicode to char by truncating the most
-     * significant byte
-     */
-    for(uint16_t i = 0; i < 16; i++)
+    return _loadContact(contact, &contactData);
+}
+
+_Static_assert((sizeof(md3x0Channel_t) <= sizeof(channel_t)) &&
+               (sizeof(md3x0Contact_t) <= sizeof(contact_t)),
+               "Raw codeplug entries must fit in the batched read buffers");
+
+int cps_readContacts(contact_t *contacts, uint16_t first, uint16_t count)
+{
+    if(first >= maxNumContacts) return -1;
+    if(count > (maxNumContacts - first)) count = maxNumContacts - first;
+
+    md3x0Contact_t *raw = cps_rawBuffer(contacts, sizeof(contact_t),
+                                        sizeof(md3x0Contact_t), count);
+    uint32_t readAddr = contactBaseAddr + first * sizeof(md3x0Contact_t);
+    W25Qx_readData(readAddr, ((uint8_t *) raw), count * sizeof(md3x0Contact_t));
+
+    uint16_t i;
+    for(i = 0; i < count; i++)
     {
-        contact->name[i] = ((char) (contactData.name[i] & 0x00FF));
+        md3x0Contact_t contactData = raw[i];
+        if(_loadContact(&contacts[i], &contactData) < 0)
+            break;
     }
 
-    contact->mode = OPMODE_DMR;
+    return (i > 0) ? i : -1;
+}
 
-    // Copy contact DMR ID
-    contact->info.dmr.id = contactData.id[0]
-                         | (contactData.id[1] << 8)
-                         | (contactData.id[2] << 16);
+int cps_readChannels(channel_t *channels, uint16_t first, uint16_t count)
+{
+    if(first >= maxNumChannels) return -1;
+    if(count > (maxNumChannels - first)) count = maxNumChannels - first;
 
-    // Copy contact details
-    contact->info.dmr.contactType = contactData.type;
-    contact->info.dmr.rx_tone     = contactData.receive_tone ? true : false;
+    md3x0Channel_t *raw = cps_rawBuffer(channels, sizeof(channel_t),
+                                        sizeof(md3x0Channel_t), count);
+    uint32_t readAddr = chDataBaseAddr + first * sizeof(md3x0Channel_t);
+    W25Qx_readData(readAddr, ((uint8_t *) raw), count * sizeof(md3x0Channel_t));
 
-    return 0;
+    for(uint16_t i = 0; i < count; i++)
+    {
+        md3x0Channel_t chData = raw[i];
+        _loadChannel(&channels[i], &chData);
+    }
+
+    return (count > 0) ? count : -1;
+}
+
+int cps_readBankChannels(uint16_t *channels, uint16_t bank_pos, uint16_t first,
+                         uint16_t count)
+{
+    if(bank_pos >= maxNumZones) return -1;
+
+    md3x0Zone_t zoneData;
+    uint32_t zoneAddr = zoneBaseAddr + bank_pos * sizeof(md3x0Zone_t);
+    W25Qx_readData(zoneAddr, ((uint8_t *) &zoneData), sizeof(md3x0Zone_t));
+
+    // Check if zone is empty
+    #pragma GCC diagnostic ignored "-Waddress-of-packed-member"
+    if(wcslen((wchar_t *) zoneData.name) == 0) return -1;
+
+    // Zone members are 1 based, an empty member ends the zone
+    uint16_t i;
+    for(i = 0; (i < count) && ((first + i) < 16); i++)
+    {
+        uint16_t member = zoneData.member[first + i];
+        if(member == 0)
+            break;
+
+        channels[i] = member - 1;
+    }
+
+    return (i > 0) ? i : -1;
 }
@@ -21,6 +21,7 @@
 
 #include <nvmem_access.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <limits.h>
 #include <errno.h>
 #include "eeep.h"
@@ -48,12 +49,6 @@ struct eeepRecord
     uint16_t virtAddr;
 };
 
-struct eeepEntry
-{
-    uint32_t physAddr;
-    uint16_t virtAddr;
-};
-
 static uint32_t nextRecordAddress(const uint32_t addr, const struct eeepRecord *rec)
 {
     uint32_t nextAddr = addr;
@@ -77,11 +72,85 @@ static uint32_t nextRecordAddress(const uint32_t addr, const struct eeepRecord *
     return nextAddr + sizeof(struct eeepRecord);
 }
 
-static int findRecord(struct eeepData *priv, uint32_t *memAddr, const uint16_t virtAddr)
+/**
+ * Search a virtual address in the record index.
+ *
+ * @param priv: driver private data.
+ * @param virtAddr: virtual address.
+ * @return position of the entry in the index or, if not present, the position
+ * where it should be inserted.
+ */
+static uint16_t indexSearch(const struct eeepData *priv, const uint16_t virtAddr)
+{
+    uint16_t low  = 0;
+    uint16_t high = priv->numEntries;
+
+    while(low < high)
+    {
+        uint16_t mid = low + ((high - low) / 2);
+        if(priv->index[mid].virtAddr < virtAddr)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
+
+/**
+ * Add or update the entry of a virtual address in the record index.
+ *
+ * @param priv: driver private data.
+ * @param virtAddr: virtual address.
+ * @param physAddr: physical address of the record header.
+ * @param size: size of the record data.
+ * @return zero on success, a negative error code otherwise.
+ */
+static int indexUpdate(struct eeepData *priv, const uint16_t virtAddr,
+                       const uint32_t physAddr, const uint8_t size)
+{
+    uint16_t pos = indexSearch(priv, virtAddr);
+
+    if((pos >= priv->numEntries) || (priv->index[pos].virtAddr != virtAddr))
+    {
+        // New virtual address, grow the index if needed and make room
+        if(priv->numEntries == priv->maxEntries)
+        {
+            uint16_t newSize = (priv->maxEntries == 0) ? 8 : (priv->maxEntries * 2);
+            struct eeepEntry *ptr = realloc(priv->index,
+                                            newSize * sizeof(struct eeepEntry));
+            if(ptr == NULL)
+                return -ENOMEM;
+
+            priv->index      = ptr;
+            priv->maxEntries = newSize;
+        }
+
+        for(uint16_t i = priv->numEntries; i > pos; i--)
+            priv->index[i] = priv->index[i - 1];
+
+        priv->index[pos].virtAddr = virtAddr;
+        priv->numEntries += 1;
+    }
+
+    priv->index[pos].physAddr = physAddr;
+    priv->index[pos].size     = size;
+
+    return 0;
+}
+
+/**
+ * Build the record index scanning all the records of the active page.
+ *
+ * @param priv: driver private data.
+ * @return zero on success, a negative error code otherwise.
+ */
+static int indexBuild(struct eeepData *priv)
 {
     struct eeepRecord rec;
     uint32_t addr = priv->readAddr;
-    *memAddr = 0xFFFFFFFF;
+
+    priv->numEntries = 0;
 
     while(addr < priv->writeAddr)
     {
@@ -89,16 +158,28 @@ static int findRecord(struct eeepData *priv, uint32_t *memAddr, const uint16_t v
         if(ret < 0)
             return ret;
 
-        if((rec.status == EEEP_RECORD_VALID) && (rec.virtAddr == virtAddr))
-            *memAddr = addr;
+        if(rec.status == EEEP_RECORD_VALID)
+        {
+            ret = indexUpdate(priv, rec.virtAddr, addr, rec.size);
+            if(ret < 0)
+                return ret;
+        }
 
         addr = nextRecordAddress(addr, &rec);
     }
 
-    if(*memAddr != 0xFFFFFFFF)
-        return 0;
+    return 0;
+}
+
+static const struct eeepEntry *findRecord(const struct eeepData *priv,
+                                          const uint16_t virtAddr)
+{
+    uint16_t pos = indexSearch(priv, virtAddr);
+
+    if((pos < priv->numEntries) && (priv->index[pos].virtAddr == virtAddr))
+        return &priv->index[pos];
 
-    return -1;
+    return NULL;
 }
 
 static int writeRecord(struct eeepData *priv, uint16_t virtAddr, const void *data,
@@ -129,8 +210,10 @@ static int writeRecord(struct eeepData *priv, uint16_t virtAddr, const void *dat
     // Finally, update the record header changing the state to "valid".
     rec.status = EEEP_RECORD_VALID;
     ret = nvm_devWrite(priv->nvm, headAddr, &rec, sizeof(struct eeepRecord));
+    if(ret < 0)
+        return ret;
 
-    return ret;
+    return indexUpdate(priv, virtAddr, headAddr, len);
 }
 
 static int swapBlock(struct eeepData *priv)
@@ -148,45 +231,6 @@ static int swapBlock(struct eeepData *priv)
     if(ret < 0)
         return ret;
 
-    // Search for all the active entries
-    // TODO: use dynamic memory allocation
-    struct eeepEntry entryList[8] = {0};
-    uint32_t address = priv->readAddr;
-    uint8_t numEntries = 0;
-
-    while(address < priv->writeAddr)
-    {
-        struct eeepRecord rec;
-
-        ret = nvm_devRead(priv->nvm, address, &rec, sizeof(struct eeepRecord));
-        if(ret < 0)
-            return ret;
-
-        if(rec.status == EEEP_RECORD_VALID)
-        {
-            uint8_t pos;
-            for(pos = 0; pos < numEntries; pos++)
-            {
-                // Found record in list, update its physical address
-                if(entryList[pos].virtAddr == rec.virtAddr)
-                {
-                    entryList[pos].physAddr = address;
-                    break;
-                }
-            }
-
-            // Record not found, append it to the list
-            if(pos == numEntries)
-            {
-                entryList[pos].virtAddr = rec.virtAddr;
-                entryList[pos].physAddr = address;
-                numEntries += 1;
-            }
-        }
-
-        address = nextRecordAddress(address, &rec);
-    }
-
     // Set new write address, mark the page as a page with an ogoing copy
     priv->writeAddr = nextBlock + sizeof(uint32_t);
     uint32_t tmp    = EEEP_PAGE_COPYING;
@@ -194,23 +238,19 @@ static int swapBlock(struct eeepData *priv)
     if(ret < 0)
         return ret;
 
-    // Copy over the records to the new page,
-    for(uint8_t i = 0; i < numEntries; i++)
+    // Copy over to the new page the records listed in the index. Each copy
+    // updates the physical address of its own index entry.
+    for(uint16_t i = 0; i < priv->numEntries; i++)
     {
-        struct eeepRecord rec;
-        uint8_t data[256];
-        uint32_t address = entryList[i].physAddr;
-
-        ret = nvm_devRead(priv->nvm, address, &rec, sizeof(struct eeepRecord));
-        if(ret < 0)
-            return ret;
+        uint8_t  data[256];
+        uint32_t address = priv->index[i].physAddr + sizeof(struct eeepRecord);
+        uint8_t  size    = priv->index[i].size;
 
-        address += sizeof(struct eeepRecord);
-        ret = nvm_devRead(priv->nvm, address, data, rec.size);
+        ret = nvm_devRead(priv->nvm, address, data, size);
         if(ret < 0)
             return ret;
 
-        ret = writeRecord(priv, rec.virtAddr, data, rec.size);
+        ret = writeRecord(priv, priv->index[i].virtAddr, data, size);
         if(ret < 0)
             return ret;
     }
@@ -236,29 +276,20 @@ static int eeep_read(const struct nvmDevice *dev, uint32_t offset, void *data,
                      size_t len)
 {
     struct eeepData *priv = (struct eeepData *) dev->priv;
-    struct eeepRecord rec;
-    uint32_t memAddr;
 
     if((offset >= 0xFFFF) || (len >= 255))
         return -EINVAL;
 
-    int ret = findRecord(priv, &memAddr, offset);
-    if(ret < 0)
-        return ret;
-
-    // Found, read infoblock
-    ret = nvm_devRead(priv->nvm, memAddr, &rec, sizeof(struct eeepRecord));
-    if(ret < 0)
-        return ret;
+    const struct eeepEntry *entry = findRecord(priv, offset);
+    if(entry == NULL)
+        return -1;
 
     // Adjust size and read data
-    if(rec.size < len)
-        len = rec.size;
+    if(entry->size < len)
+        len = entry->size;
 
-    memAddr += sizeof(struct eeepRecord);
-    ret = nvm_devRead(priv->nvm, memAddr, data, rec.size);
-
-    return ret;
+    uint32_t memAddr = entry->physAddr + sizeof(struct eeepRecord);
+    return nvm_devRead(priv->nvm, memAddr, data, len);
 }
 
 static int eeep_write(const struct nvmDevice *dev, uint32_t offset,
@@ -302,6 +333,7 @@ int eeep_init(const struct nvmDevice *dev, const uint32_t nvm,
     priv->nvm = desc->dev;
     priv->part = &desc->partitions[part];
     priv->readAddr = 0xFFFFFFFF;
+    priv->numEntries = 0;
 
     // Search for an active page, set the read address to the first record
     // immediately after the page header
@@ -351,12 +383,17 @@ int eeep_init(const struct nvmDevice *dev, const uint32_t nvm,
         }
     }
 
-    return 0;
+    return indexBuild(priv);
 }
 
 int eeep_terminate(const struct nvmDevice* dev)
 {
-    (void) dev;
+    struct eeepData *priv = (struct eeepData *) dev->priv;
+
+    free(priv->index);
+    priv->index      = NULL;
+    priv->numEntries = 0;
+    priv->maxEntries = 0;
 
     return 0;
 }
@@ -35,6 +35,17 @@
 extern const struct nvmOps  eeep_ops;
 extern const struct nvmInfo eeep_info;
 
+/**
+ * Entry of the index of the valid records, mapping a virtual address to the
+ * physical address of its most recent record.
+ */
+struct eeepEntry
+{
+    uint32_t physAddr;      ///< Physical address of the record header
+    uint16_t virtAddr;      ///< Virtual address
+    uint8_t  size;          ///< Size of the record data
+};
+
 /**
  * Driver private data.
  */
@@ -44,6 +55,9 @@ struct eeepData
     const struct nvmPartition *part;        ///< Memory partition used for EEPROM emulation
     uint32_t                  readAddr;     ///< Physical start address for EEEPROM reads
     uint32_t                  writeAddr;    ///< Physical start address for EEEPROM writes
+    struct eeepEntry          *index;       ///< Index of the valid records, sorted by virtual address
+    uint16_t                  numEntries;   ///< Number of entries in the index
+    uint16_t                  maxEntries;   ///< Allocated size of the index
 };
 
 /**
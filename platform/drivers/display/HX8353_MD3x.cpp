@@ -120,6 +120,23 @@ static inline __attribute__((__always_inline__)) void writeData(uint8_t val)
     *((volatile uint8_t*) LCD_FSMC_ADDR_DATA) = val;
 }
 
+/*
+ * Swap the byte order of the pixels in the framebuffer rows going from
+ * startRow (included) to endRow (excluded).
+ */
+static void swapRows(uint16_t *frameBuffer, uint8_t startRow, uint8_t endRow)
+{
+    for(uint8_t y = startRow; y < endRow; y++)
+    {
+        for(uint8_t x = 0; x < CONFIG_SCREEN_WIDTH; x++)
+        {
+            size_t pos = x + y * CONFIG_SCREEN_WIDTH;
+            uint16_t pixel = frameBuffer[pos];
+            frameBuffer[pos] = __builtin_bswap16(pixel);
+        }
+    }
+}
+
 void display_init()
 {
     /* Initialise backlight driver */
@@ -445,15 +462,7 @@ void display_renderRows(uint8_t startRow, uint8_t endRow, void *fb)
      * function gets true as return value and does not stomp our work.
      */
     uint16_t *frameBuffer = (uint16_t *) fb;
-    for(uint8_t y = startRow; y < endRow; y++)
-    {
-        for(uint8_t x = 0; x < CONFIG_SCREEN_WIDTH; x++)
-        {
-            size_t pos = x + y * CONFIG_SCREEN_WIDTH;
-            uint16_t pixel = frameBuffer[pos];
-            frameBuffer[pos] = __builtin_bswap16(pixel);
-        }
-    }
+    swapRows(frameBuffer, startRow, endRow);
 
     /* Configure start and end rows in display driver */
     writeCmd(CMD_RASET);
@@ -497,6 +506,13 @@ void display_renderRows(uint8_t startRow, uint8_t endRow, void *fb)
             }
         } while(lcdWaiting);
     }
+
+    /*
+     * Transfer completed, restore the original byte order: the content of the
+     * framebuffer is retained between frames and the rows not redrawn by the
+     * UI may be sent again by the next partial render.
+     */
+    swapRows(frameBuffer, startRow, endRow);
 }
 
 void display_render(void *fb)
@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN,                            *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+/**
+ * This driver provides an lcd screen emulator for the headless builds of the
+ * linux target: the framebuffer content is converted to RGB888 and handed to
+ * the headless emulator engine, which publishes it to the external tools.
+ */
+
+#include <interfaces/display.h>
+#include <emulator/headless_engine.h>
+#include <stdio.h>
+
+/**
+ * @internal
+ * Internal helper function which fetches pixel at position (x, y) from
+ * framebuffer and stores it in RGB888 format.
+ */
+static inline void fetchPixelFromFb(unsigned int x, unsigned int y, void *fb,
+                                    uint8_t *rgb)
+{
+    #ifdef CONFIG_PIX_FMT_RGB565
+    uint16_t *buf = (uint16_t *)(fb);
+    uint16_t px   = buf[x + y*CONFIG_SCREEN_WIDTH];
+    uint8_t  r    = (px >> 11) & 0x1F;
+    uint8_t  g    = (px >> 5)  & 0x3F;
+    uint8_t  b    = px & 0x1F;
+
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+    #endif
+
+    #ifdef CONFIG_PIX_FMT_BW
+    /*
+     * Black and white 1bpp format: framebuffer is an array of uint8_t, where
+     * each cell contains the values of eight pixels, one per bit.
+     */
+    uint8_t *buf = (uint8_t *)(fb);
+    unsigned int cell = (x + y*CONFIG_SCREEN_WIDTH) / 8;
+    unsigned int elem = (x + y*CONFIG_SCREEN_WIDTH) % 8;
+    uint8_t px = (buf[cell] & (1 << elem)) ? 0xFF : 0x00;
+
+    rgb[0] = px;
+    rgb[1] = px;
+    rgb[2] = px;
+    #endif
+}
+
+void display_init()
+{
+
+}
+
+void display_terminate()
+{
+
+}
+
+void display_renderRows(uint8_t startRow, uint8_t endRow, void *fb)
+{
+    if(endRow > CONFIG_SCREEN_HEIGHT)
+        endRow = CONFIG_SCREEN_HEIGHT;
+
+    uint8_t *frame = headlessEngine_lockFrame();
+
+    for(unsigned int y = startRow; y < endRow; y++)
+    {
+        uint8_t *row = &frame[y * CONFIG_SCREEN_WIDTH * 3];
+
+        for(unsigned int x = 0; x < CONFIG_SCREEN_WIDTH; x++)
+            fetchPixelFromFb(x, y, fb, &row[x * 3]);
+    }
+
+    headlessEngine_unlockFrame();
+}
+
+void display_render(void *fb)
+{
+    display_renderRows(0, CONFIG_SCREEN_HEIGHT, fb);
+}
+
+void display_setContrast(uint8_t contrast)
+{
+    printf("Setting display contrast to %d\n", contrast);
+}
+
+void display_setBacklightLevel(uint8_t level)
+{
+    // Saturate level to 100 and convert value to 0 - 255
+    if(level > 100) level = 100;
+    uint16_t value = (2 * level) + (level * 55)/100;
+
+    headlessEngine_setBacklight(value);
+}
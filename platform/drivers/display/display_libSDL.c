@@ -43,6 +43,9 @@ extern chan_t fb_sync;       /* Shared channel to send a frame buffer update */
 /* Custom SDL Event to adjust backlight */
 extern Uint32 SDL_Backlight_Event;
 
+/* Custom SDL Event to request a texture for a frame buffer update */
+extern Uint32 SDL_Render_Event;
+
 #ifndef CONFIG_PIX_FMT_RGB565
 /**
  * @internal
@@ -106,7 +109,12 @@ void display_renderRows(uint8_t startRow, uint8_t endRow, void *fb)
 
     if(sdl_ready)
     {
-        // receive a texture pixel map
+        // wake up the SDL main loop and receive a texture pixel map
+        SDL_Event e;
+        SDL_zero(e);
+        e.type = SDL_Render_Event;
+        SDL_PushEvent(&e);
+
         void *pixelMap;
         chan_recv(&fb_sync, &pixelMap);
         #ifdef CONFIG_PIX_FMT_RGB565
@@ -21,9 +21,12 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <interfaces/keyboard.h>
-#include <emulator/sdl_engine.h>
 #include <emulator/emulator.h>
 
+#ifndef CONFIG_EMULATOR_HEADLESS
+#include <emulator/sdl_engine.h>
+#endif
+
 void kbd_init()
 {
 }
@@ -34,7 +37,9 @@ keyboard_t kbd_getKeys()
 
     //this pulls in emulated keypresses from the command shell
     keys |= emulator_getKeys();
+    #ifndef CONFIG_EMULATOR_HEADLESS
     keys |= sdlEngine_getKeys();
+    #endif
 
     return keys;
 }
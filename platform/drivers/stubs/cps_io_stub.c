@@ -76,6 +76,35 @@ int cps_readBankData(uint16_t bank_pos, uint16_t pos)
     return -1;
 }
 
+int cps_readContacts(contact_t *contacts, uint16_t first, uint16_t count)
+{
+    (void) contacts;
+    (void) first;
+    (void) count;
+
+    return -1;
+}
+
+int cps_readChannels(channel_t *channels, uint16_t first, uint16_t count)
+{
+    (void) channels;
+    (void) first;
+    (void) count;
+
+    return -1;
+}
+
+int cps_readBankChannels(uint16_t *channels, uint16_t bank_pos, uint16_t first,
+                         uint16_t count)
+{
+    (void) channels;
+    (void) bank_pos;
+    (void) first;
+    (void) count;
+
+    return -1;
+}
+
 int cps_writeContact(contact_t contact, uint16_t pos)
 {
     (void) contact;
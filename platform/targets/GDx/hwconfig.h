@@ -43,6 +43,9 @@ extern const struct spiDevice c6000_spi;
 /* Screen pixel format */
 #define CONFIG_PIX_FMT_BW
 
+/* Display driver addresses the framebuffer in eight pixel high pages */
+#define CONFIG_SCREEN_ROW_PAGES
+
 /* Screen has adjustable contrast */
 #define CONFIG_SCREEN_CONTRAST
 #define CONFIG_DEFAULT_CONTRAST 71
@@ -63,6 +63,9 @@ extern const struct Adc adc1;
 /* Screen pixel format */
 #define CONFIG_PIX_FMT_BW
 
+/* Display driver addresses the framebuffer in eight pixel high pages */
+#define CONFIG_SCREEN_ROW_PAGES
+
 /* Battery type */
 #define CONFIG_BAT_NONE
 
@@ -23,17 +23,28 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <SDL2/SDL.h>
 
 #include <readline/readline.h>
 #include <readline/history.h>
 
 #include "emulator.h"
+#include <memory_profiling.h>
+#include <thread_stats.h>
+
+#ifdef CONFIG_EMULATOR_HEADLESS
+#include "headless_engine.h"
+
+#define SCREENSHOT_FILE "screenshot.ppm"
+#else
+#include <SDL2/SDL.h>
 #include "sdl_engine.h"
 
 /* Custom SDL Event to request a screenshot */
 extern Uint32 SDL_Screenshot_Event;
 
+#define SCREENSHOT_FILE "screenshot.bmp"
+#endif
+
 emulator_state_t emulator_state =
 {
     -100.0f,  // RSSI
@@ -251,13 +262,16 @@ static int pressMultiKeys(void *_self, int _argc, char **_argv)
 static int screenshot(void *_self, int _argc, char **_argv)
 {
     (void) _self;
-    char *filename = "screenshot.bmp";
+    char *filename = SCREENSHOT_FILE;
 
     if(_argc && _argv[0] != NULL)
     {
         filename = _argv[0];
     }
 
+    #ifdef CONFIG_EMULATOR_HEADLESS
+    return headlessEngine_screenshot(filename) ? SH_CONTINUE : SH_ERR;
+    #else
     int len = strlen(filename);
 
     SDL_Event e;
@@ -268,6 +282,7 @@ static int screenshot(void *_self, int _argc, char **_argv)
     strcpy(e.user.data1, filename);
 
     return SDL_PushEvent(&e) == 1 ? SH_CONTINUE : SH_ERR;
+    #endif
 }
 
 static int setFloat(void *_self, int _argc, char **_argv)
@@ -339,6 +354,41 @@ static int printState( void *_self, int _argc, char **_argv)
     return SH_CONTINUE;
 }
 
+static int printMemory( void *_self, int _argc, char **_argv)
+{
+    (void) _self;
+    (void) _argc;
+    (void) _argv;
+    printf("\nMemory usage\n");
+    memprof_printReport();
+    printf("\n");
+    return SH_CONTINUE;
+}
+
+static int printTiming( void *_self, int _argc, char **_argv)
+{
+    (void) _self;
+
+    if(_argc && _argv[0] != NULL)
+    {
+        FILE *file = fopen(_argv[0], "a");
+        if(file == NULL)
+        {
+            printf("Unable to open %s\n", _argv[0]);
+            return SH_ERR;
+        }
+
+        threadStats_dump(file);
+        fclose(file);
+        return SH_CONTINUE;
+    }
+
+    printf("\nThread loop timings (ms)\n");
+    threadStats_dump(stdout);
+    printf("\n");
+    return SH_CONTINUE;
+}
+
 static int shell_nop( void *_self, int _argc, char **_argv)
 {
     (void) _self;
@@ -365,7 +415,12 @@ static _climenu_option _options[] =
     },
     {"keycombo", "Press a bunch of keys simultaneously", NULL, pressMultiKeys },
     {"show",     "Show current radio state (ptt, rssi, etc)", NULL, printState},
-    {"screenshot", "[screenshot.bmp] Save screenshot to first arg or screenshot.bmp if none given",
+    {"memory",   "Show peak stack usage of the threads and heap usage", NULL, printMemory},
+    {"timing",   "Show timing statistics of the thread loops, or append them to the file given as first arg",
+                                NULL,   printTiming
+    },
+    {"screenshot", "[" SCREENSHOT_FILE "] Save screenshot to first arg or "
+                   SCREENSHOT_FILE " if none given",
                                 NULL,   screenshot
     },
     {"sleep",   "Wait some number of ms",           NULL,   shell_sleep },
@@ -477,6 +532,21 @@ static int process_line(char *line)
     }
 }
 
+static void powerOff()
+{
+    emulator_state.powerOff = true;
+
+    // Wake up the engine main loop, sleeping while waiting for events
+    #ifdef CONFIG_EMULATOR_HEADLESS
+    headlessEngine_quit();
+    #else
+    SDL_Event e;
+    SDL_zero(e);
+    e.type = SDL_QUIT;
+    SDL_PushEvent(&e);
+    #endif
+}
+
 void *startCLIMenu()
 {
     printf("\n\n");
@@ -522,7 +592,7 @@ void *startCLIMenu()
 
             case SH_EXIT_OK:
                 //normal quit
-                emulator_state.powerOff = true;
+                powerOff();
                 break;
 
             case SH_ERR:
@@ -544,9 +614,31 @@ void *startCLIMenu()
 
 
 
+/*
+ * Periodically print the memory usage report, the period in seconds is taken
+ * from the OPENRTX_MEMPROF environment variable.
+ */
+static void *memoryReport(void *arg)
+{
+    unsigned int period = *((unsigned int *) arg);
+
+    while(emulator_state.powerOff == false)
+    {
+        sleep(period);
+        printf("\nMemory usage\n");
+        memprof_printReport();
+    }
+
+    return NULL;
+}
+
 void emulator_start()
 {
+    #ifdef CONFIG_EMULATOR_HEADLESS
+    headlessEngine_init();
+    #else
     sdlEngine_init();
+    #endif
 
     pthread_t cli_thread;
     int err = pthread_create(&cli_thread, NULL, startCLIMenu, NULL);
@@ -555,6 +647,17 @@ void emulator_start()
     {
         printf("An error occurred starting the emulator CLI thread: %d\n", err);
     }
+
+    static unsigned int reportPeriod = 0;
+    const char *period = getenv("OPENRTX_MEMPROF");
+    if(period != NULL)
+        reportPeriod = atoi(period);
+
+    if(reportPeriod > 0)
+    {
+        pthread_t report_thread;
+        pthread_create(&report_thread, NULL, memoryReport, &reportPeriod);
+    }
 }
 
 keyboard_t emulator_getKeys()
@@ -23,7 +23,10 @@
 #include <interfaces/keyboard.h>
 #include <stdbool.h>
 #include <stdint.h>
+
+#ifndef CONFIG_EMULATOR_HEADLESS
 #include <SDL2/SDL.h>
+#endif
 
 #ifndef CONFIG_SCREEN_WIDTH
 #define CONFIG_SCREEN_WIDTH 160
@@ -0,0 +1,226 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN,                            *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "headless_engine.h"
+#include "emulator.h"
+
+#define EVENT_QUEUE_SIZE 8
+
+static pthread_mutex_t frameMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t eventMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  eventCond  = PTHREAD_COND_INITIALIZER;
+
+static uint8_t        frame[HEADLESS_FRAME_SIZE];   // Current screen content
+static headlessRing_t *ring = NULL;                 // Shared memory frame ring
+static size_t         ringSize;
+static char           shmName[64];
+
+static char    *screenshotQueue[EVENT_QUEUE_SIZE];  // Pending screenshot requests
+static uint8_t queueHead  = 0;
+static uint8_t queueCount = 0;
+
+
+static void openRing()
+{
+    const char *name = getenv("OPENRTX_SHM");
+    if(name != NULL)
+        snprintf(shmName, sizeof(shmName), "%s", name);
+    else
+        snprintf(shmName, sizeof(shmName), "/openrtx-%d", (int) getpid());
+
+    ringSize = sizeof(headlessRing_t)
+             + (HEADLESS_RING_SLOTS * HEADLESS_FRAME_SIZE);
+
+    int fd = shm_open(shmName, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if(fd < 0)
+    {
+        perror("Failed to open display frame ring");
+        return;
+    }
+
+    if(ftruncate(fd, ringSize) < 0)
+    {
+        perror("Failed to allocate display frame ring");
+        close(fd);
+        shm_unlink(shmName);
+        return;
+    }
+
+    void *ptr = mmap(NULL, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(ptr == MAP_FAILED)
+    {
+        perror("Failed to map display frame ring");
+        shm_unlink(shmName);
+        return;
+    }
+
+    ring            = (headlessRing_t *) ptr;
+    ring->width     = CONFIG_SCREEN_WIDTH;
+    ring->height    = CONFIG_SCREEN_HEIGHT;
+    ring->frameSize = HEADLESS_FRAME_SIZE;
+    ring->numSlots  = HEADLESS_RING_SLOTS;
+    ring->backlight = 255;
+    ring->sequence  = 0;
+    __atomic_store_n(&ring->magic, HEADLESS_RING_MAGIC, __ATOMIC_RELEASE);
+
+    printf("Display frames published on shared memory \"%s\"\n", shmName);
+}
+
+static void closeRing()
+{
+    if(ring == NULL)
+        return;
+
+    munmap(ring, ringSize);
+    shm_unlink(shmName);
+    ring = NULL;
+}
+
+static int saveFrame(const char *filename)
+{
+    FILE *fp = fopen(filename, "wb");
+    if(fp == NULL)
+    {
+        printf("Failed to open \"%s\"\n", filename);
+        return -1;
+    }
+
+    fprintf(fp, "P6\n%d %d\n255\n", CONFIG_SCREEN_WIDTH, CONFIG_SCREEN_HEIGHT);
+
+    pthread_mutex_lock(&frameMutex);
+    size_t ret = fwrite(frame, 1, sizeof(frame), fp);
+    pthread_mutex_unlock(&frameMutex);
+
+    fclose(fp);
+
+    if(ret != sizeof(frame))
+    {
+        printf("Failed to save screenshot to \"%s\"\n", filename);
+        return -1;
+    }
+
+    printf("Saved screenshot as PPM to \"%s\"\n", filename);
+    return 0;
+}
+
+
+
+void headlessEngine_init()
+{
+    memset(frame, 0x00, sizeof(frame));
+    openRing();
+}
+
+void headlessEngine_run()
+{
+    pthread_mutex_lock(&eventMutex);
+
+    while(true)
+    {
+        while((queueCount == 0) && (emulator_state.powerOff == false))
+            pthread_cond_wait(&eventCond, &eventMutex);
+
+        if(queueCount == 0)
+            break;
+
+        char *filename = screenshotQueue[queueHead];
+        queueHead   = (queueHead + 1) % EVENT_QUEUE_SIZE;
+        queueCount -= 1;
+
+        // Do not keep the queue locked while writing to disk
+        pthread_mutex_unlock(&eventMutex);
+        saveFrame(filename);
+        free(filename);
+        pthread_mutex_lock(&eventMutex);
+    }
+
+    pthread_mutex_unlock(&eventMutex);
+
+    printf("Terminating headless display emulator, goodbye!\n");
+    closeRing();
+}
+
+uint8_t *headlessEngine_lockFrame()
+{
+    pthread_mutex_lock(&frameMutex);
+    return frame;
+}
+
+void headlessEngine_unlockFrame()
+{
+    if(ring != NULL)
+    {
+        uint32_t seq  = ring->sequence;
+        uint8_t *slot = ((uint8_t *) ring) + sizeof(headlessRing_t)
+                      + ((seq % HEADLESS_RING_SLOTS) * HEADLESS_FRAME_SIZE);
+
+        memcpy(slot, frame, HEADLESS_FRAME_SIZE);
+        __atomic_store_n(&ring->sequence, seq + 1, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock(&frameMutex);
+}
+
+void headlessEngine_setBacklight(uint8_t level)
+{
+    if(ring != NULL)
+        __atomic_store_n(&ring->backlight, level, __ATOMIC_RELAXED);
+}
+
+bool headlessEngine_screenshot(const char *filename)
+{
+    char *name = strdup(filename);
+    if(name == NULL)
+        return false;
+
+    pthread_mutex_lock(&eventMutex);
+
+    if(queueCount >= EVENT_QUEUE_SIZE)
+    {
+        pthread_mutex_unlock(&eventMutex);
+        free(name);
+        return false;
+    }
+
+    uint8_t tail = (queueHead + queueCount) % EVENT_QUEUE_SIZE;
+    screenshotQueue[tail] = name;
+    queueCount += 1;
+
+    pthread_cond_signal(&eventCond);
+    pthread_mutex_unlock(&eventMutex);
+
+    return true;
+}
+
+void headlessEngine_quit()
+{
+    pthread_mutex_lock(&eventMutex);
+    pthread_cond_signal(&eventCond);
+    pthread_mutex_unlock(&eventMutex);
+}
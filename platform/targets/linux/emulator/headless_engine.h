@@ -0,0 +1,117 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN,                            *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+#ifndef HEADLESS_ENGINE_H
+#define HEADLESS_ENGINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Screen dimensions, adjust basing on the size of the screen you need to
+ * emulate
+ */
+#ifndef CONFIG_SCREEN_WIDTH
+#define CONFIG_SCREEN_WIDTH 160
+#endif
+
+#ifndef CONFIG_SCREEN_HEIGHT
+#define CONFIG_SCREEN_HEIGHT 128
+#endif
+
+/**
+ * Headless emulator engine, used in place of the SDL one when the emulator
+ * runs without a display.
+ *
+ * The content of the emulated screen is kept as an RGB888 frame and, each time
+ * the display is updated, it is published into a POSIX shared memory ring
+ * which can be mapped by external tools. The name of the shared memory object
+ * is taken from the OPENRTX_SHM environment variable and defaults to
+ * "/openrtx-<pid>"; the ring is laid out as a headlessRing_t header followed by
+ * numSlots frames of frameSize bytes each. The most recent frame is the one
+ * in slot (sequence - 1) % numSlots: readers should check that sequence did
+ * not advance by numSlots or more while they were copying a frame.
+ *
+ * Keyboard, PTT and RSSI are driven through the emulator command line.
+ */
+
+#define HEADLESS_RING_MAGIC  0x58545231     // "1RTX"
+#define HEADLESS_RING_SLOTS  8
+#define HEADLESS_FRAME_SIZE  (CONFIG_SCREEN_WIDTH * CONFIG_SCREEN_HEIGHT * 3)
+
+/**
+ * Header of the shared memory frame ring.
+ */
+typedef struct
+{
+    uint32_t magic;         // Ring identifier, HEADLESS_RING_MAGIC
+    uint16_t width;         // Frame width, in pixels
+    uint16_t height;        // Frame height, in pixels
+    uint32_t frameSize;     // Size of a frame, in bytes
+    uint32_t numSlots;      // Number of frame slots
+    uint32_t backlight;     // Current backlight level, from 0 to 255
+    uint32_t sequence;      // Number of frames published so far
+}
+headlessRing_t;
+
+/**
+ * Initialize the headless engine.
+ */
+void headlessEngine_init();
+
+/**
+ * Headless engine main loop, sleeps until an event is posted and returns when
+ * the emulator is powered off. Must be called in the Main Thread.
+ */
+void headlessEngine_run();
+
+/**
+ * Lock the emulated screen for update.
+ *
+ * @return pointer to the RGB888 screen frame.
+ */
+uint8_t *headlessEngine_lockFrame();
+
+/**
+ * Unlock the emulated screen and publish its content into the frame ring.
+ */
+void headlessEngine_unlockFrame();
+
+/**
+ * Set the level of the emulated backlight.
+ *
+ * @param level: backlight level, from 0 to 255.
+ */
+void headlessEngine_setBacklight(uint8_t level);
+
+/**
+ * Thread-safe function requesting to save the content of the emulated screen
+ * to a PPM image.
+ *
+ * @param filename: path of the image file.
+ * @return true if the request has been queued.
+ */
+bool headlessEngine_screenshot(const char *filename);
+
+/**
+ * Thread-safe function waking up the engine main loop after the emulator has
+ * been powered off.
+ */
+void headlessEngine_quit();
+
+#endif /* HEADLESS_ENGINE_H */
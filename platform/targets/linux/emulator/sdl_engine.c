@@ -24,6 +24,7 @@
 chan_t fb_sync;                 // Shared channel to receive frame buffer updates
 Uint32 SDL_Screenshot_Event;    // Shared custom SDL event to request a screenshot
 Uint32 SDL_Backlight_Event;     // Shared custom SDL event to change backlight
+Uint32 SDL_Render_Event;        // Shared custom SDL event to signal a new frame
 
 static SDL_Window   *window;
 static SDL_Renderer *renderer;
@@ -280,9 +281,11 @@ void sdlEngine_init()
         exit(1);
     }
 
-    // Register SDL custom events to handle screenshot requests and backlight
-    SDL_Screenshot_Event = SDL_RegisterEvents(2);
+    // Register SDL custom events to handle screenshot requests, backlight and
+    // frame buffer updates
+    SDL_Screenshot_Event = SDL_RegisterEvents(3);
     SDL_Backlight_Event = SDL_Screenshot_Event+1;
+    SDL_Render_Event = SDL_Screenshot_Event+2;
 
     chan_init(&fb_sync);
 
@@ -318,45 +321,47 @@ void sdlEngine_run()
     {
         keyboard_t key = 0;
 
-        if (SDL_PollEvent(&ev) == 1)
-        {
-            switch (ev.type)
-            {
-                case SDL_QUIT:
-                    emulator_state.powerOff = true;
-                    break;
-
-                case SDL_KEYDOWN:
-                    if (sdk_key_code_to_key(ev.key.keysym.sym, &key))
-                    {
-                        sdl_keys |= key;
-                    }
-                    break;
-
-                case SDL_KEYUP:
-                    if (sdk_key_code_to_key(ev.key.keysym.sym, &key))
-                    {
-                        sdl_keys ^= key;
-                    }
-                    break;
-            }
+        // Sleep until something happens: the display driver and the emulator
+        // command line push custom events to wake up the loop.
+        if (SDL_WaitEvent(&ev) == 0)
+            continue;
 
-            if (ev.type == SDL_Screenshot_Event)
-            {
-                char *filename = (char *)ev.user.data1;
-                screenshot_display(filename);
-                free(ev.user.data1);
-            }
-            else if (ev.type == SDL_Backlight_Event)
-            {
-                set_brightness(*((uint8_t*)ev.user.data1));
-                free(ev.user.data1);
-            }
+        switch (ev.type)
+        {
+            case SDL_QUIT:
+                emulator_state.powerOff = true;
+                break;
+
+            case SDL_KEYDOWN:
+                if (sdk_key_code_to_key(ev.key.keysym.sym, &key))
+                {
+                    sdl_keys |= key;
+                }
+                break;
+
+            case SDL_KEYUP:
+                if (sdk_key_code_to_key(ev.key.keysym.sym, &key))
+                {
+                    sdl_keys ^= key;
+                }
+                break;
         }
 
-        // we update the window only if there is a something ready to render
-        if (chan_can_send(&fb_sync))
+        if (ev.type == SDL_Screenshot_Event)
+        {
+            char *filename = (char *)ev.user.data1;
+            screenshot_display(filename);
+            free(ev.user.data1);
+        }
+        else if (ev.type == SDL_Backlight_Event)
+        {
+            set_brightness(*((uint8_t*)ev.user.data1));
+            free(ev.user.data1);
+        }
+        else if (ev.type == SDL_Render_Event)
         {
+            // The display driver is waiting for a texture to copy the frame
+            // buffer into
             PIXEL_SIZE *pixels;
             int pitch = 0;
 
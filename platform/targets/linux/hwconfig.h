@@ -38,6 +38,9 @@ enum Mod17Flags
 /* Device supports M17 mode */
 #define CONFIG_M17
 
+/* Index the whole codeplug tables */
+#define CONFIG_CPS_INDEX_SIZE 65535
+
 #ifdef __cplusplus
 }
 #endif
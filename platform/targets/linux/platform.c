@@ -18,6 +18,7 @@
 #include <calibration/calibInfo_Mod17.h>
 #include <interfaces/platform.h>
 #include <interfaces/nvmem.h>
+#include <stdlib.h>
 #include <stdio.h>
 #include "emulator.h"
 
@@ -89,13 +90,15 @@ int8_t platform_getChSelector()
 
 bool platform_getPttStatus()
 {
+    #ifndef CONFIG_EMULATOR_HEADLESS
     // Read P key status from SDL
     const uint8_t *state = SDL_GetKeyboardState(NULL);
 
-    if ((state[SDL_SCANCODE_P] != 0) || (emulator_state.PTTstatus == true))
+    if (state[SDL_SCANCODE_P] != 0)
         return true;
-    else
-        return false;
+    #endif
+
+    return emulator_state.PTTstatus;
 }
 
 bool platform_pwrButtonStatus()
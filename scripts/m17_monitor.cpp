@@ -0,0 +1,209 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+/*
+ * Multi-channel M17 monitor for linux.
+ *
+ * Decodes several raw baseband sources (signed 16 bit samples at 24kHz, either
+ * regular files or FIFOs fed by an SDR front end) at the same time, printing
+ * the link setup information of each transmission heard on each channel.
+ *
+ * Usage: m17_monitor [-w workers] [-i] [-H] source [source ...]
+ *
+ *  -w workers: number of worker threads (default: one per source, at most 4).
+ *  -i:         invert the phase of the baseband signals.
+ *  -H:         use hard-decision decoding.
+ *
+ * The monitor exits when all the sources are exhausted or on SIGINT.
+ */
+
+#include <M17/M17MultiReceiver.hpp>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+
+using namespace M17;
+using namespace std;
+
+/**
+ * Monitoring state of a channel.
+ */
+struct ChannelStats
+{
+    M17LinkSetupFrame lsf;          // LSF of the current transmission
+    bool              active;       // A transmission is in progress
+    size_t            frames;       // Stream frames of the current transmission
+    size_t            streams;      // Transmissions heard
+    size_t            totFrames;    // Stream frames received
+};
+
+static volatile sig_atomic_t stopRequest = 0;
+
+static void sigintHandler(int signum)
+{
+    (void) signum;
+    stopRequest = 1;
+}
+
+static const char *dataType(streamType_t type)
+{
+    if(type.fields.dataMode == M17_DATAMODE_PACKET)
+        return "packet";
+
+    switch(type.fields.dataType)
+    {
+        case M17_DATATYPE_DATA:       return "data";
+        case M17_DATATYPE_VOICE:      return "voice";
+        case M17_DATATYPE_VOICE_DATA: return "voice+data";
+        default:                      return "unknown";
+    }
+}
+
+static void endStream(const size_t channel, ChannelStats& stats)
+{
+    if(stats.active == false)
+        return;
+
+    printf("[ch %zu] end of transmission, %zu frames\n", channel, stats.frames);
+    stats.active = false;
+}
+
+static void processFrame(M17RxFrame& frame, ChannelStats& stats)
+{
+    // A new or changed LSF starts a new transmission
+    if((stats.active == false) ||
+       (memcmp(frame.lsf.getData(), stats.lsf.getData(),
+               sizeof(M17LinkSetupFrame)) != 0))
+    {
+        if(frame.lsf.valid() == false)
+            return;
+
+        endStream(frame.channel, stats);
+
+        streamType_t type = frame.lsf.getType();
+        printf("[ch %u] %s -> %s, CAN %u, %s\n", frame.channel,
+               frame.lsf.getSource().c_str(),
+               frame.lsf.getDestination().c_str(),
+               type.fields.CAN, dataType(type));
+
+        stats.lsf     = frame.lsf;
+        stats.active  = true;
+        stats.frames  = 0;
+        stats.streams += 1;
+    }
+
+    if(frame.type != M17FrameType::STREAM)
+        return;
+
+    stats.frames    += 1;
+    stats.totFrames += 1;
+
+    if(frame.streamFrame.isLastFrame())
+        endStream(frame.channel, stats);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t numWorkers  = 0;
+    bool   invertPhase = false;
+    bool   softDecode  = true;
+    int    opt;
+
+    while((opt = getopt(argc, argv, "w:iH")) != -1)
+    {
+        switch(opt)
+        {
+            case 'w': numWorkers  = strtoul(optarg, NULL, 10); break;
+            case 'i': invertPhase = true;                      break;
+            case 'H': softDecode  = false;                     break;
+            default:
+                fprintf(stderr, "Usage: %s [-w workers] [-i] [-H] source "
+                                "[source ...]\n", argv[0]);
+                return -1;
+        }
+    }
+
+    size_t numChannels = argc - optind;
+    if(numChannels == 0)
+    {
+        fprintf(stderr, "No baseband source given\n");
+        return -1;
+    }
+
+    if(numWorkers == 0)
+        numWorkers = (numChannels < 4) ? numChannels : 4;
+
+    M17MultiReceiver receiver(numWorkers, softDecode);
+    for(size_t i = 0; i < numChannels; i++)
+    {
+        const char *path = argv[optind + i];
+        if(receiver.addChannel(path, invertPhase) < 0)
+        {
+            fprintf(stderr, "Failed to open %s\n", path);
+            return -1;
+        }
+
+        printf("[ch %zu] %s\n", i, path);
+    }
+
+    signal(SIGINT, sigintHandler);
+
+    if(receiver.start() == false)
+    {
+        fprintf(stderr, "Failed to start the receiver\n");
+        return -1;
+    }
+
+    vector< ChannelStats > stats(numChannels);
+    M17RxFrame frame;
+
+    while(stopRequest == 0)
+    {
+        bool running = receiver.isRunning();
+        bool idle    = true;
+
+        while(receiver.getFrame(frame))
+        {
+            processFrame(frame, stats[frame.channel]);
+            idle = false;
+        }
+
+        if(running == false)
+            break;
+
+        if(idle)
+            usleep(10000);
+    }
+
+    receiver.stop();
+
+    printf("\n");
+    for(size_t i = 0; i < numChannels; i++)
+    {
+        endStream(i, stats[i]);
+        printf("[ch %zu] %zu transmissions, %zu frames\n", i, stats[i].streams,
+               stats[i].totFrames);
+    }
+
+    return 0;
+}
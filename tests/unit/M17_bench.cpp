@@ -0,0 +1,539 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+/*
+ * Offline M17 receive chain benchmark.
+ *
+ * Streams a raw baseband capture (signed 16 bit, little endian) through the
+ * M17 demodulator and frame decoder as fast as possible, then times each
+ * stage of the receive chain on its own over the same data.
+ *
+ * Usage: m17_bench [-r rate] [-i] [-H] [-n snr] [-f frames]
+ *                  [baseband.raw [syncwords.txt]]
+ *
+ *  -r rate:   sample rate of the capture, must be a multiple of 24000 (default
+ *             48000, the rate of the test assets).
+ *  -i:        invert the phase of the baseband signal.
+ *  -H:        use hard-decision decoding.
+ *  -n snr:    signal to noise ratio of the synthetic transmission, in dB
+ *             (default 10).
+ *  -f frames: number of stream frames of the synthetic transmission (default
+ *             1000).
+ *
+ * The optional syncword file lists the sample index of each frame syncword in
+ * the capture, one per line, and is used to count the frames missed by the
+ * demodulator. Since the content of the capture is not known, the frame error
+ * rate is measured on a synthetic transmission of known random payloads with
+ * added white gaussian noise: each decoded frame is compared with the
+ * transmitted one.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <cmath>
+#include <unistd.h>
+#include <dsp.h>
+#include <fir.hpp>
+#include <firInterpolator.hpp>
+#include <M17/M17DSP.hpp>
+#include <M17/M17Golay.hpp>
+#include <M17/M17Viterbi.hpp>
+#include <M17/Correlator.hpp>
+#include <M17/M17Constants.hpp>
+#include <M17/M17Interleaver.hpp>
+#include <M17/M17Decorrelator.hpp>
+#include <M17/M17Demodulator.hpp>
+#include <M17/M17FrameDecoder.hpp>
+#include <M17/M17FrameEncoder.hpp>
+#include <M17/M17Utils.hpp>
+#include <M17/M17CodePuncturing.hpp>
+
+using namespace M17;
+using namespace std;
+using namespace std::chrono;
+
+static constexpr size_t DEMOD_RATE  = 24000;
+static constexpr size_t BLOCK_SIZE  = 960;      // Half of an M17 frame at 24kHz
+static constexpr size_t SPS         = DEMOD_RATE / M17_SYMBOL_RATE;
+static constexpr size_t TX_RATE     = 48000;
+static constexpr size_t TX_SPS      = TX_RATE / M17_SYMBOL_RATE;
+static constexpr float  TX_GAIN     = 23000.0f;   // Same as M17Modulator
+
+static const char *defaultBaseband  = "../tests/unit/assets/M17_test_baseband.raw";
+static const char *defaultSyncwords = "../tests/unit/assets/M17_test_baseband_syncwords.txt";
+
+static inline double elapsedNs(const steady_clock::time_point& start)
+{
+    return duration_cast< nanoseconds >(steady_clock::now() - start).count();
+}
+
+/**
+ * Load a raw baseband file, decimating it down to the demodulator rate.
+ */
+static bool loadBaseband(const char *path, const size_t rate,
+                         vector< int16_t >& samples)
+{
+    FILE *fp = fopen(path, "rb");
+    if(fp == NULL)
+    {
+        perror("Error opening baseband file");
+        return false;
+    }
+
+    const size_t decim = rate / DEMOD_RATE;
+    int16_t buf[1024];
+    size_t  cnt = 0;
+    size_t  n;
+
+    while((n = fread(buf, sizeof(int16_t), 1024, fp)) > 0)
+    {
+        for(size_t i = 0; i < n; i++, cnt++)
+        {
+            if((cnt % decim) == 0)
+                samples.push_back(buf[i]);
+        }
+    }
+
+    fclose(fp);
+    return true;
+}
+
+/**
+ * Generate the baseband of a voice stream made of random payloads, as sent by
+ * the modulator, adding white gaussian noise and decimating it down to the
+ * demodulator rate.
+ *
+ * @param numFrames: number of stream frames.
+ * @param snr: signal to noise ratio, in dB.
+ * @param payloads: transmitted payloads, indexed by frame number.
+ * @param samples: generated baseband.
+ */
+static void synthBaseband(const size_t numFrames, const double snr,
+                          vector< payload_t >& payloads,
+                          vector< int16_t >& samples)
+{
+    default_random_engine rng(1234);
+    uniform_int_distribution< int > byte(0, 255);
+
+    // Symbols: preamble, LSF, stream frames, EOT and some trailing silence
+    vector< int8_t > symbols;
+    for(size_t i = 0; i < 2 * M17_FRAME_SYMBOLS; i++)
+        symbols.push_back((i % 2) ? -3 : +3);
+
+    auto pushFrame = [&](const frame_t& frame)
+    {
+        for(auto b : frame)
+        {
+            auto sym = byteToSymbols(b);
+            symbols.insert(symbols.end(), sym.begin(), sym.end());
+        }
+    };
+
+    M17FrameEncoder   encoder;
+    M17LinkSetupFrame lsf;
+    frame_t           frame;
+    streamType_t      type;
+
+    lsf.clear();
+    lsf.setSource("N0CALL");
+    type.value           = 0;
+    type.fields.dataMode = M17_DATAMODE_STREAM;
+    type.fields.dataType = M17_DATATYPE_VOICE;
+    lsf.setType(type);
+    lsf.updateCrc();
+
+    encoder.reset();
+    encoder.encodeLsf(lsf, frame);
+    pushFrame(frame);
+
+    payloads.resize(numFrames);
+    for(size_t i = 0; i < numFrames; i++)
+    {
+        for(auto& b : payloads[i])
+            b = byte(rng);
+
+        encoder.encodeStreamFrame(payloads[i], frame, (i + 1) == numFrames);
+        pushFrame(frame);
+    }
+
+    encoder.encodeEotFrame(frame);
+    pushFrame(frame);
+    symbols.insert(symbols.end(), 2 * M17_FRAME_SYMBOLS, 0);
+
+    // Shape the symbols at the transmitter rate
+    FirInterpolator< std::tuple_size< decltype(rrc_taps_48k) >::value,
+                     TX_SPS > rrc(rrc_taps_48k);
+    vector< int16_t > tx(symbols.size() * TX_SPS);
+    rrc.process(symbols.data(), tx.data(), symbols.size(), TX_GAIN);
+
+    double power = 0.0;
+    for(auto s : tx)
+        power += (double) s * s;
+
+    power /= tx.size();
+    normal_distribution< double > noise(0.0, sqrt(power / pow(10.0, snr / 10.0)));
+
+    for(size_t i = 0; i < tx.size(); i += TX_RATE / DEMOD_RATE)
+    {
+        double value = tx[i] + noise(rng);
+        if(value > 32767.0)  value = 32767.0;
+        if(value < -32768.0) value = -32768.0;
+        samples.push_back(static_cast< int16_t >(value));
+    }
+}
+
+/**
+ * Measure the frame error rate on a synthetic transmission, comparing each
+ * decoded stream frame with the transmitted one.
+ */
+static void measureFer(const size_t numFrames, const double snr, const bool soft)
+{
+    vector< payload_t > payloads;
+    vector< int16_t >   samples;
+    synthBaseband(numFrames, snr, payloads, samples);
+
+    M17Demodulator  demod;
+    M17FrameDecoder decoder;
+    vector< bool >  good(numFrames, false);
+    size_t          decoded = 0;
+    size_t          corrupt = 0;
+    bool            locked  = false;
+
+    demod.init();
+    decoder.reset();
+
+    for(size_t pos = 0; pos < samples.size(); pos += BLOCK_SIZE)
+    {
+        size_t len  = min(BLOCK_SIZE, samples.size() - pos);
+        bool   newF = demod.update(&samples[pos], len, false);
+        bool   lock = demod.isLocked();
+
+        if((lock == true) && (locked == false))
+            decoder.reset();
+
+        locked = lock;
+        if((lock == false) || (newF == false))
+            continue;
+
+        const frame_t& frame = demod.getFrame();
+        M17FrameType   type  = soft ? decoder.decodeFrame(frame, demod.getSoftFrame())
+                                    : decoder.decodeFrame(frame);
+        if(type != M17FrameType::STREAM)
+            continue;
+
+        M17StreamFrame sf = decoder.getStreamFrame();
+        uint16_t fn = sf.getFrameNumber() & 0x7FFF;
+        decoded++;
+
+        // A corrupted frame number can point to any frame, or none at all
+        if((fn < numFrames) && (sf.payload() == payloads[fn]))
+            good[fn] = true;
+        else
+            corrupt++;
+    }
+
+    demod.terminate();
+
+    size_t numGood = 0;
+    for(bool g : good)
+        numGood += g ? 1 : 0;
+
+    size_t missing = numFrames - min(numFrames, decoded);
+    double fer     = 1.0 - ((double) numGood / (double) numFrames);
+    printf("Synthetic:      %zu frames, SNR %.1f dB, %s decision\n", numFrames,
+           snr, soft ? "soft" : "hard");
+    printf("Frame errors:   %zu good, %zu corrupted, %zu missing, FER %.2f%%\n",
+           numGood, corrupt, missing, fer * 100.0);
+}
+
+/**
+ * Count the number of reference syncwords, that is the number of frames
+ * expected to be demodulated.
+ */
+static long countSyncwords(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    if(fp == NULL)
+        return -1;
+
+    long count = 0;
+    long index;
+    while(fscanf(fp, "%ld", &index) == 1)
+        count++;
+
+    fclose(fp);
+    return count;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t rate      = 48000;
+    bool   invert    = false;
+    bool   soft      = true;
+    double snr       = 10.0;
+    size_t synFrames = 1000;
+    int    opt;
+
+    while((opt = getopt(argc, argv, "r:iHn:f:")) != -1)
+    {
+        switch(opt)
+        {
+            case 'r': rate      = strtoul(optarg, NULL, 10); break;
+            case 'i': invert    = true;                      break;
+            case 'H': soft      = false;                     break;
+            case 'n': snr       = strtod(optarg, NULL);      break;
+            case 'f': synFrames = strtoul(optarg, NULL, 10); break;
+            default:
+                fprintf(stderr, "Usage: %s [-r rate] [-i] [-H] [-n snr] "
+                                "[-f frames] [baseband.raw [syncwords.txt]]\n",
+                                argv[0]);
+                return -1;
+        }
+    }
+
+    if((rate < DEMOD_RATE) || ((rate % DEMOD_RATE) != 0))
+    {
+        fprintf(stderr, "Sample rate must be a multiple of %zu\n", DEMOD_RATE);
+        return -1;
+    }
+
+    const char *basebandPath = defaultBaseband;
+    const char *syncPath     = NULL;
+
+    if(optind < argc)
+    {
+        basebandPath = argv[optind++];
+        if(optind < argc)
+            syncPath = argv[optind];
+    }
+    else
+    {
+        syncPath = defaultSyncwords;
+    }
+
+    vector< int16_t > baseband;
+    if(loadBaseband(basebandPath, rate, baseband) == false)
+        return -1;
+
+    const size_t numSamples = baseband.size();
+    printf("Input:          %s, %zu samples (%.2f s)\n", basebandPath,
+           numSamples, (double) numSamples / DEMOD_RATE);
+
+    /*
+     * End-to-end run: demodulator and decoder.
+     */
+    vector< int16_t >     signal(baseband);
+    vector< frame_t >     frames;
+    vector< softFrame_t > softFrames;
+    M17Demodulator        demod;
+    M17FrameDecoder       decoder;
+
+    demod.init();
+    decoder.reset();
+
+    size_t   lsfFrames     = 0;
+    size_t   lsfValid      = 0;
+    size_t   streamFrames  = 0;
+    double   decodeNs      = 0;
+
+    auto start = steady_clock::now();
+
+    for(size_t pos = 0; pos < numSamples; pos += BLOCK_SIZE)
+    {
+        size_t len = min(BLOCK_SIZE, numSamples - pos);
+        if(demod.update(&signal[pos], len, invert) == false)
+            continue;
+
+        const frame_t&     frame     = demod.getFrame();
+        const softFrame_t& softFrame = demod.getSoftFrame();
+        frames.push_back(frame);
+        softFrames.push_back(softFrame);
+
+        auto decStart = steady_clock::now();
+        M17FrameType type = soft ? decoder.decodeFrame(frame, softFrame)
+                                 : decoder.decodeFrame(frame);
+        decodeNs += elapsedNs(decStart);
+
+        if(type == M17FrameType::LINK_SETUP)
+        {
+            M17LinkSetupFrame lsf = decoder.getLsf();
+            lsfFrames++;
+            if(lsf.valid()) lsfValid++;
+        }
+        else if(type == M17FrameType::STREAM)
+        {
+            streamFrames++;
+        }
+    }
+
+    double totalNs   = elapsedNs(start);
+    double totalSec  = totalNs / 1e9;
+    size_t numFrames = frames.size();
+
+    printf("Total time:     %.3f ms (decoder %.3f ms)\n", totalNs / 1e6,
+                                                          decodeNs / 1e6);
+    printf("Throughput:     %.0f samples/s, %.0f frames/s, %.1fx real time\n",
+           numSamples / totalSec, numFrames / totalSec,
+           ((double) numSamples / DEMOD_RATE) / totalSec);
+    printf("Frames:         %zu demodulated, %zu LSF (%zu valid), "
+           "%zu stream\n", numFrames, lsfFrames, lsfValid, streamFrames);
+
+    if(syncPath != NULL)
+    {
+        long expected = countSyncwords(syncPath);
+        if(expected > 0)
+        {
+            long missed = expected - (long) numFrames;
+            if(missed < 0) missed = 0;
+            printf("Missed frames:  %ld of %ld expected (%.2f%%)\n", missed,
+                   expected, (100.0 * missed) / expected);
+        }
+    }
+
+    demod.terminate();
+
+    if(synFrames > 0)
+        measureFer(synFrames, snr, soft);
+
+    /*
+     * Per-stage timings, each stage is run alone over the same data.
+     */
+    printf("Stage timings:\n");
+
+    signal = baseband;
+    filter_state_t dcrState;
+    dsp_resetFilterState(&dcrState);
+    start = steady_clock::now();
+    for(size_t pos = 0; pos < numSamples; pos += BLOCK_SIZE)
+    {
+        size_t len = min(BLOCK_SIZE, numSamples - pos);
+        dsp_dcRemoval(&dcrState, &signal[pos], len);
+    }
+    double ns = elapsedNs(start);
+    printf("  DC removal:   %8.2f ns/sample\n", ns / numSamples);
+
+    Fir< std::tuple_size< decltype(rrc_taps_24k) >::value > rrc(rrc_taps_24k);
+    start = steady_clock::now();
+    for(size_t pos = 0; pos < numSamples; pos += BLOCK_SIZE)
+    {
+        size_t len = min(BLOCK_SIZE, numSamples - pos);
+        rrc.process(&signal[pos], &signal[pos], len);
+    }
+    ns = elapsedNs(start);
+    printf("  RRC filter:   %8.2f ns/sample\n", ns / numSamples);
+
+    static constexpr std::array< int8_t, M17_SYNCWORD_SYMBOLS > syncword =
+        { -3, -3, -3, -3, +3, +3, -3, +3 };
+    Correlator< M17_SYNCWORD_SYMBOLS, SPS > correlator;
+    volatile int32_t sink = 0;
+    start = steady_clock::now();
+    for(size_t i = 0; i < numSamples; i++)
+    {
+        correlator.sample(signal[i]);
+        sink = correlator.convolve(syncword);
+    }
+    ns = elapsedNs(start);
+    (void) sink;
+    printf("  Correlator:   %8.2f ns/sample\n", ns / numSamples);
+
+    if(numFrames == 0)
+        return 0;
+
+    // Prepare decorrelated and deinterleaved payloads for the decoders
+    vector< std::array< uint8_t, 46 > >   payloads(numFrames);
+    vector< std::array< uint16_t, 368 > > softPayloads(numFrames);
+    for(size_t i = 0; i < numFrames; i++)
+    {
+        std::copy(frames[i].begin() + 2, frames[i].end(), payloads[i].begin());
+        std::copy(softFrames[i].begin() + 16, softFrames[i].end(),
+                  softPayloads[i].begin());
+    }
+
+    start = steady_clock::now();
+    if(soft)
+    {
+        for(auto& p : softPayloads)
+            decorrelateAndDeinterleave(p);
+    }
+    else
+    {
+        for(auto& p : payloads)
+            decorrelateAndDeinterleave(p);
+    }
+    ns = elapsedNs(start);
+    printf("  Deinterleave: %8.2f ns/frame (%s decision)\n", ns / numFrames,
+           soft ? "soft" : "hard");
+
+    // Both payload types are needed by the following stages
+    if(soft)
+    {
+        for(auto& p : payloads)
+            decorrelateAndDeinterleave(p);
+    }
+    else
+    {
+        for(auto& p : softPayloads)
+            decorrelateAndDeinterleave(p);
+    }
+
+    std::array< uint8_t, 18 > decoded;
+    start = steady_clock::now();
+    if(soft)
+    {
+        M17SoftViterbi viterbi;
+        std::array< uint16_t, 272 > punctured;
+        for(auto& p : softPayloads)
+        {
+            std::copy(p.begin() + 96, p.end(), punctured.begin());
+            viterbi.decodePunctured(punctured, decoded, DATA_PUNCTURE);
+        }
+    }
+    else
+    {
+        M17HardViterbi viterbi;
+        std::array< uint8_t, 34 > punctured;
+        for(auto& p : payloads)
+        {
+            std::copy(p.begin() + 12, p.end(), punctured.begin());
+            viterbi.decodePunctured(punctured, decoded, DATA_PUNCTURE);
+        }
+    }
+    ns = elapsedNs(start);
+    printf("  Viterbi:      %8.2f ns/frame (%s decision)\n", ns / numFrames,
+           soft ? "soft" : "hard");
+
+    start = steady_clock::now();
+    for(auto& p : payloads)
+    {
+        for(size_t i = 0; i < 4; i++)
+        {
+            uint32_t block = (p[3*i] << 16) | (p[3*i + 1] << 8) | p[3*i + 2];
+            sink = golay24_decode(block);
+        }
+    }
+    ns = elapsedNs(start);
+    printf("  Golay:        %8.2f ns/frame (4 codewords)\n", ns / numFrames);
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include "M17/M17Callsign.hpp"
+
+using namespace M17;
+
+struct testCase
+{
+    const char *local;
+    const char *incoming;
+    bool        match;
+};
+
+static const testCase tests[] =
+{
+    { "IU2KWO",     "IU2KWO",     true  },
+    { "IU2KWO",     "IU2KIN",     false },
+    { "IU2KWO",     "ALL",        true  },
+    { "IU2KWO",     "INFO",       true  },
+    { "IU2KWO",     "ECHO",       true  },
+    { "IU2KWO",     "IU2KWO-1",   false },
+    { "IU2KWO-1",   "IU2KWO-1",   true  },
+    { "EA/AB1CD",   "AB1CD",      true  },
+    { "AB1CD",      "EA/AB1CD",   true  },
+    { "F/AB1CD",    "EA/AB1CD",   true  },
+    { "OE3/AB1CD",  "AB1CD",      false },
+    { "AB1CD",      "OE3/AB1CD",  false },
+    { "AB1CD/P",    "AB1CD",      false },
+    { "AB1CD/P",    "AB1CD/P",    true  }
+};
+
+int main()
+{
+    for(auto& test : tests)
+    {
+        // Round trip through the base-40 encoding, as in a real transmission
+        call_t encoded;
+        char   decoded[M17_CALLSIGN_SIZE];
+        if(encode_callsign(test.incoming, encoded, true) == false)
+        {
+            printf("Error encoding %s!\n", test.incoming);
+            return -1;
+        }
+
+        decode_callsign(encoded, decoded);
+        if(strcmp(decoded, test.incoming) != 0)
+        {
+            printf("Error decoding %s, got %s!\n", test.incoming, decoded);
+            return -1;
+        }
+
+        if(compare_callsigns(test.local, decoded) != test.match)
+        {
+            printf("Error comparing %s and %s!\n", test.local, test.incoming);
+            return -1;
+        }
+    }
+
+    return 0;
+}
@@ -45,6 +45,37 @@ uint32_t generateErrorMask()
     return errorMask;
 }
 
+/**
+ * Generate the soft bits of a codeword, with four bit errors having a low
+ * reliability. These errors cannot be corrected by hard decoding but have to
+ * be corrected by the soft-decision decoder.
+ */
+void generateSoftBits(const uint32_t cword, uint16_t *softBits)
+{
+    uniform_int_distribution< uint16_t > strong(0x6000, 0x7FFF);
+    uniform_int_distribution< uint16_t > weak(0x0000, 0x1000);
+    uniform_int_distribution< uint8_t > errPos(0, 23);
+
+    uint32_t errorMask = 0;
+    while(__builtin_popcount(errorMask) < 4)
+        errorMask |= 1 << errPos(rng);
+
+    for(uint8_t i = 0; i < 24; i++)
+    {
+        uint8_t  pos = 23 - i;
+        bool     bit = ((cword >> pos) & 1) != 0;
+        uint16_t rel = strong(rng);
+
+        if(errorMask & (1 << pos))
+        {
+            bit = !bit;
+            rel = weak(rng);
+        }
+
+        softBits[i] = bit ? (0x7FFF + rel) : (0x7FFF - rel);
+    }
+}
+
 int main()
 {
     uniform_int_distribution< uint16_t > rndValue(0, 2047);
@@ -84,5 +115,22 @@ int main()
             return -1;
     }
 
+    for(uint32_t i = 0; i < 10000; i++)
+    {
+        uint16_t value = rndValue(rng);
+        uint32_t cword = M17::golay24_encode(value);
+        uint16_t softBits[24];
+
+        generateSoftBits(cword, softBits);
+        uint16_t decoded = M17::Golay24::softDecode(softBits);
+
+        if(decoded != value)
+        {
+            printf("Soft decoding of value %04x failed, got %04x\n",
+                   value, decoded);
+            return -1;
+        }
+    }
+
     return 0;
 }
@@ -0,0 +1,181 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <vector>
+#include <M17/M17MultiReceiver.hpp>
+
+using namespace M17;
+using namespace std;
+
+static constexpr size_t NUM_CHANNELS = 4;
+static constexpr size_t NUM_WORKERS  = 2;
+
+static const char *inputPath = "../tests/unit/assets/M17_test_baseband.raw";
+
+/**
+ * Decode the baseband stored in a file on several channels at the same time
+ * and compare the frames received on each channel against the reference.
+ */
+static int checkChannels(const char *basebandPath,
+                         vector< M17StreamFrame >& reference)
+{
+    M17MultiReceiver receiver(NUM_WORKERS);
+    for(size_t i = 0; i < NUM_CHANNELS; i++)
+    {
+        if(receiver.addChannel(basebandPath) < 0)
+        {
+            printf("Failed to add channel %zu\n", i);
+            return -1;
+        }
+    }
+
+    vector< M17StreamFrame > received[NUM_CHANNELS];
+    receiver.start();
+
+    M17RxFrame frame;
+    while(true)
+    {
+        bool running = receiver.isRunning();
+
+        while(receiver.getFrame(frame))
+        {
+            if(frame.type == M17FrameType::STREAM)
+                received[frame.channel].push_back(frame.streamFrame);
+        }
+
+        if(running == false)
+            break;
+    }
+
+    receiver.stop();
+
+    for(size_t ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+        if(received[ch].size() != reference.size())
+        {
+            printf("Channel %zu: got %zu frames, expected %zu\n", ch,
+                   received[ch].size(), reference.size());
+            return -1;
+        }
+
+        for(size_t i = 0; i < reference.size(); i++)
+        {
+            if(memcmp(received[ch][i].getData(), reference[i].getData(),
+                      sizeof(M17StreamFrame)) != 0)
+            {
+                printf("Channel %zu: mismatch at frame %zu\n", ch, i);
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Check that several demodulator/decoder pairs running concurrently on the
+ * same baseband decode exactly the same frames of a single instance.
+ */
+
+int main(int argc, char *argv[])
+{
+    if(argc > 1)
+        inputPath = argv[1];
+
+    // Load test baseband, sampled at 48kHz, and decimate it to 24kHz
+    FILE *fp = fopen(inputPath, "rb");
+    if(fp == NULL)
+    {
+        perror("Error in reading test baseband");
+        return -1;
+    }
+
+    vector< int16_t > baseband;
+    int16_t sample[2];
+    while(fread(sample, sizeof(int16_t), 2, fp) == 2)
+        baseband.push_back(sample[0]);
+
+    fclose(fp);
+
+    // Reference decoding with a single demodulator
+    vector< M17StreamFrame > reference;
+    M17Demodulator  demod;
+    M17FrameDecoder decoder;
+    bool locked = false;
+
+    demod.init();
+    decoder.reset();
+    for(size_t pos = 0; pos < baseband.size(); pos += 960)
+    {
+        size_t len = min< size_t >(960, baseband.size() - pos);
+        bool newFrame = demod.update(&baseband[pos], len);
+        bool lock     = demod.isLocked();
+
+        if((lock == true) && (locked == false))
+            decoder.reset();
+
+        locked = lock;
+        if((lock == false) || (newFrame == false))
+            continue;
+
+        auto type = decoder.decodeFrame(demod.getFrame(), demod.getSoftFrame());
+        if(type == M17FrameType::STREAM)
+            reference.push_back(decoder.getStreamFrame());
+    }
+
+    demod.terminate();
+
+    if(reference.empty())
+    {
+        printf("No reference frames decoded\n");
+        return -1;
+    }
+
+    // Multi-channel decoding, from a temporary copy of the decimated baseband
+    char basebandPath[] = "/tmp/M17_multichannel_XXXXXX";
+    int fd = mkstemp(basebandPath);
+    if(fd < 0)
+    {
+        perror("Error in creating temporary baseband");
+        return -1;
+    }
+
+    fp = fdopen(fd, "wb");
+    size_t written = fwrite(baseband.data(), sizeof(int16_t),
+                            baseband.size(), fp);
+    fclose(fp);
+
+    int ret = -1;
+    if(written == baseband.size())
+        ret = checkChannels(basebandPath, reference);
+    else
+        printf("Error in writing temporary baseband\n");
+
+    remove(basebandPath);
+    if(ret < 0)
+        return ret;
+
+    printf("%zu channels, %zu frames each: OK\n", NUM_CHANNELS, reference.size());
+
+    return 0;
+}
@@ -0,0 +1,282 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <M17/M17Packet.hpp>
+#include <M17/M17Utils.hpp>
+#include <M17/M17Interleaver.hpp>
+#include <M17/M17FrameEncoder.hpp>
+#include <M17/M17FrameDecoder.hpp>
+#include <m17_packet.h>
+
+using namespace std;
+using namespace M17;
+
+static default_random_engine rng;
+
+/**
+ * Flip some random bits in the payload of a frame, sync word excluded. The
+ * errors are placed after the first encoded bits, which are weakly protected
+ * since the Viterbi decoder does not assume a starting state.
+ */
+static void addErrors(frame_t& frame, const size_t numErrors)
+{
+    uniform_int_distribution< size_t > errPos(24, InterleaverTable::NB - 1);
+
+    for(size_t i = 0; i < numErrors; i++)
+    {
+        size_t pos = 16 + interleaverTable.index[errPos(rng)];
+        setBit(frame, pos, !getBit(frame, pos));
+    }
+}
+
+/**
+ * Decode a frame, either using hard or soft decisions.
+ */
+static M17FrameType decode(M17FrameDecoder& decoder, const frame_t& frame,
+                           const bool soft)
+{
+    if(soft == false)
+        return decoder.decodeFrame(frame);
+
+    softFrame_t softFrame;
+    for(size_t i = 0; i < softFrame.size(); i++)
+        softFrame[i] = getBit(frame, i) ? 0xFFFF : 0x0000;
+
+    return decoder.decodeFrame(frame, softFrame);
+}
+
+/**
+ * Transmit a packet through the frame encoder and decoder, checking that it
+ * is correctly received. Bit errors are added only to the packet frames.
+ */
+static int loopback(const size_t size, const bool soft, const size_t numErrors)
+{
+    static uint8_t txBuf[M17_PACKET_BUF_SIZE];
+    static uint8_t rxBuf[M17_PACKET_BUF_SIZE];
+
+    uniform_int_distribution< uint8_t > rndByte(0, 255);
+    txBuf[0] = M17_PACKET_RAW;
+    for(size_t i = 1; i < size; i++)
+        txBuf[i] = rndByte(rng);
+
+    M17Packet tx;
+    if(tx.load(txBuf, size) == false)
+        return -1;
+
+    M17FrameEncoder encoder;
+    M17FrameDecoder decoder;
+    M17LinkSetupFrame lsf;
+    frame_t frame;
+
+    streamType_t type;
+    type.value           = 0;
+    type.fields.dataMode = M17_DATAMODE_PACKET;
+    type.fields.dataType = M17_DATATYPE_DATA;
+
+    lsf.clear();
+    lsf.setSource("IU2KWO");
+    lsf.setDestination("IU2KIN");
+    lsf.setType(type);
+    encoder.encodeLsf(lsf, frame);
+
+    if((decode(decoder, frame, soft) != M17FrameType::LINK_SETUP) ||
+       (decoder.getEvent() != M17RxEvent::PACKET_START)           ||
+       (decoder.streamActive() == true))
+        return -1;
+
+    const M17StreamInfo& info = decoder.getStreamInfo();
+    if((strcmp(info.src, "IU2KWO") != 0) || (strcmp(info.dst, "IU2KIN") != 0))
+        return -1;
+
+    M17Packet rx;
+    rx.reset(rxBuf);
+
+    M17PacketStatus status = M17PacketStatus::INCOMPLETE;
+    for(size_t i = 0; i < tx.numFrames(); i++)
+    {
+        M17PacketFrame packetFrame;
+        tx.getFrame(i, packetFrame);
+        encoder.encodePacketFrame(packetFrame, frame);
+        addErrors(frame, numErrors);
+
+        if(decode(decoder, frame, soft) != M17FrameType::PACKET)
+            return -1;
+
+        status = rx.append(decoder.getPacketFrame());
+        if((i + 1) < tx.numFrames() && (status != M17PacketStatus::INCOMPLETE))
+            return -1;
+    }
+
+    if(status != M17PacketStatus::COMPLETE)
+        return -1;
+
+    if((rx.size() != size) || (memcmp(rx.data(), txBuf, size) != 0))
+        return -1;
+
+    return 0;
+}
+
+/**
+ * Check the handling of malformed packets.
+ */
+static int checkErrors()
+{
+    static uint8_t txBuf[M17_PACKET_BUF_SIZE];
+    static uint8_t rxBuf[M17_PACKET_BUF_SIZE];
+    M17PacketFrame frame;
+    M17Packet tx, rx;
+
+    if(tx.load(txBuf, 0) || tx.load(txBuf, M17_PACKET_MAX_SIZE + 1))
+        return -1;
+
+    // Maximum packet size
+    memset(txBuf, 0xAA, sizeof(txBuf));
+    if((tx.load(txBuf, M17_PACKET_MAX_SIZE) == false) ||
+       (tx.numFrames() != M17_PACKET_MAX_FRAMES))
+        return -1;
+
+    // Missing frame
+    rx.reset(rxBuf);
+    tx.getFrame(0, frame);
+    rx.append(frame);
+    tx.getFrame(2, frame);
+    if(rx.append(frame) != M17PacketStatus::ERROR)
+        return -1;
+
+    // Corrupted CRC
+    const char *text = "\x05Hello world!";
+    strcpy(reinterpret_cast< char * >(txBuf), text);
+    tx.load(txBuf, strlen(text) + 1);
+    txBuf[3] ^= 0x01;
+
+    rx.reset(rxBuf);
+    tx.getFrame(0, frame);
+    if(rx.append(frame) != M17PacketStatus::ERROR)
+        return -1;
+
+    return 0;
+}
+
+static int checkSlots()
+{
+    // Only one packet can wait for transmission
+    m17packet_t *packet = m17Packet_allocTx();
+    if((packet == NULL) || (m17Packet_allocTx() != NULL))
+        return -1;
+
+    // Empty packets are rejected and their slot released
+    if(m17Packet_send(packet) || (m17Packet_txPending() == true))
+        return -1;
+
+    if(m17Packet_sendSms("IU2KWO", "Hello") == false)
+        return -1;
+
+    packet = m17Packet_getTx();
+    if((packet == NULL) || (packet->size != 7) || (packet->data[0] != 0x05) ||
+       (strcmp((char *) &packet->data[1], "Hello") != 0) ||
+       (strcmp(packet->dst, "IU2KWO") != 0))
+        return -1;
+
+    m17Packet_release(packet);
+
+    gps_t gps;
+    memset(&gps, 0x00, sizeof(gps));
+    if(m17Packet_sendPosition("", &gps))
+        return -1;
+
+    gps.fix_quality = 1;
+    gps.latitude    = 45464211;
+    gps.longitude   = -9190140;
+    gps.altitude    = 120;
+    gps.speed       = 50;
+    gps.tmg_true    = 0;
+    if(m17Packet_sendPosition("", &gps) == false)
+        return -1;
+
+    packet = m17Packet_getTx();
+    const char *aprs = "!4527.85N/00911.40W[360/026/A=000393";
+    if((packet == NULL) || (packet->data[0] != 0x02) ||
+       (packet->size != strlen(aprs) + 1) ||
+       (memcmp(&packet->data[1], aprs, strlen(aprs)) != 0))
+        return -1;
+
+    m17Packet_release(packet);
+
+    // Received packets are returned oldest first
+    m17packet_t *first  = m17Packet_allocRx();
+    m17packet_t *second = m17Packet_allocRx();
+    if((first == NULL) || (second == NULL))
+        return -1;
+
+    m17Packet_publishRx(second);
+    m17Packet_publishRx(first);
+
+    const m17packet_t *rx = m17Packet_receive();
+    if(rx != second)
+        return -1;
+
+    m17Packet_release(rx);
+    if(m17Packet_receive() != first)
+        return -1;
+
+    m17Packet_release(first);
+
+    return (m17Packet_receive() == NULL) ? 0 : -1;
+}
+
+int main()
+{
+    static const size_t sizes[] = {1, 2, 23, 24, 25, 26, 100, 500,
+                                   M17_PACKET_MAX_SIZE};
+
+    for(auto size : sizes)
+    {
+        if((loopback(size, false, 0) < 0) || (loopback(size, true, 0) < 0))
+        {
+            printf("Error in transmission of a %zu bytes packet\n", size);
+            return -1;
+        }
+
+        if((loopback(size, false, 2) < 0) || (loopback(size, true, 2) < 0))
+        {
+            printf("Error in transmission of a %zu bytes packet with bit errors\n",
+                   size);
+            return -1;
+        }
+    }
+
+    if(checkErrors() < 0)
+    {
+        printf("Error in handling of malformed packets\n");
+        return -1;
+    }
+
+    if(checkSlots() < 0)
+    {
+        printf("Error in packet slot management\n");
+        return -1;
+    }
+
+    return 0;
+}
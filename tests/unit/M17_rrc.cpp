@@ -22,7 +22,10 @@
 #include <limits.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "M17/M17DSP.hpp"
+#include "firInterpolator.hpp"
 
 #define IMPULSE_SIZE 4096
 
@@ -47,13 +50,78 @@ int main()
     impulse[0] = SHRT_MAX;
 
     // Apply RRC on impulse signal
+    Fir< std::tuple_size< decltype(M17::rrc_taps_48k) >::value > rrc(M17::rrc_taps_48k);
     int16_t filtered_impulse[IMPULSE_SIZE] = { 0 };
     for(size_t i = 0; i < IMPULSE_SIZE; i++)
     {
         float elem = static_cast< float >(impulse[i]);
-        filtered_impulse[i] = static_cast< int16_t >(M17::rrc_48k(0.10 * elem));
+        filtered_impulse[i] = static_cast< int16_t >(rrc(0.10 * elem));
     }
     fwrite(filtered_impulse, IMPULSE_SIZE, 1, baseband_out);
     fclose(baseband_out);
+
+    // Check block processing against the sample-by-sample filter
+    Fir< std::tuple_size< decltype(M17::rrc_taps_48k) >::value > sampleFir(M17::rrc_taps_48k);
+    Fir< std::tuple_size< decltype(M17::rrc_taps_48k) >::value > blockFir(M17::rrc_taps_48k);
+
+    int16_t signal[IMPULSE_SIZE];
+    int16_t block[IMPULSE_SIZE];
+    srand(0);
+    for(size_t i = 0; i < IMPULSE_SIZE; i++)
+        signal[i] = static_cast< int16_t >((rand() % 8000) - 4000);
+
+    // Odd-sized chunks to exercise history handling across calls
+    for(size_t i = 0; i < IMPULSE_SIZE; i += 37)
+    {
+        size_t len = ((i + 37) <= IMPULSE_SIZE) ? 37 : (IMPULSE_SIZE - i);
+        blockFir.process(&signal[i], &block[i], len, 2.0f);
+    }
+
+    for(size_t i = 0; i < IMPULSE_SIZE; i++)
+    {
+        float   elem = static_cast< float >(signal[i]);
+        int16_t ref  = static_cast< int16_t >(2.0f * sampleFir(elem));
+        if(abs(ref - block[i]) > 1)
+        {
+            printf("Mismatch at sample %zu: %d != %d\n", i, ref, block[i]);
+            return -1;
+        }
+    }
+
+    // Check polyphase interpolator against zero-stuffing and filtering
+    static constexpr size_t SYMBOLS = 192;
+    static constexpr size_t SPS     = 10;
+    FirInterpolator< std::tuple_size< decltype(M17::rrc_taps_48k) >::value, SPS >
+        interp(M17::rrc_taps_48k);
+    sampleFir.reset();
+
+    int8_t  symbols[SYMBOLS];
+    int16_t stuffed[SYMBOLS * SPS];
+    int16_t interpolated[SYMBOLS * SPS];
+    static constexpr int8_t levels[] = {-3, -1, +1, +3};
+
+    for(size_t frame = 0; frame < 4; frame++)
+    {
+        memset(stuffed, 0x00, sizeof(stuffed));
+        for(size_t i = 0; i < SYMBOLS; i++)
+        {
+            symbols[i]       = levels[rand() % 4];
+            stuffed[i * SPS] = symbols[i];
+        }
+
+        sampleFir.process(stuffed, stuffed, SYMBOLS * SPS, 23000.0f);
+        interp.process(symbols, interpolated, SYMBOLS, 23000.0f);
+
+        for(size_t i = 0; i < SYMBOLS * SPS; i++)
+        {
+            if(abs(stuffed[i] - interpolated[i]) > 1)
+            {
+                printf("Interpolator mismatch at frame %zu, sample %zu: %d != %d\n",
+                       frame, i, stuffed[i], interpolated[i]);
+                return -1;
+            }
+        }
+    }
+
     return 0;
 }
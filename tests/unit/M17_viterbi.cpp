@@ -85,5 +85,25 @@ int main()
         }
     }
 
+    // Soft-decision decoding of the same data, hard bits are mapped to the
+    // extremes of the soft range.
+    array< uint16_t, 34 * 8 > softBits;
+    for(size_t i = 0; i < softBits.size(); i++)
+        softBits[i] = M17::getBit(punctured, i) ? 0xFFFF : 0x0000;
+
+    M17::M17SoftViterbi softDecoder;
+    result.fill(0x00);
+    softDecoder.decodePunctured(softBits, result, M17::DATA_PUNCTURE);
+
+    for(size_t i = 0; i < result.size(); i++)
+    {
+        if(source[i] != result[i])
+        {
+            printf("Soft decoding error at pos %ld: got %02x, expected %02x\n",
+                   i, result[i], source[i]);
+            return -1;
+        }
+    }
+
     return 0;
 }
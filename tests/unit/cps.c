@@ -152,6 +152,177 @@ int test_createOOOCPS() {
     return 0;
 }
 
+int test_deleteAndReopen() {
+    cps_create("/tmp/test7.rtxc");
+
+    cps_open("/tmp/test7.rtxc");
+    contact_t ct1 = { "Test contact 1", 0, {{0}} };
+    contact_t ct2 = { "Test contact 2", 0, {{0}} };
+    channel_t ch1 = { OPMODE_M17, 0, 0, 0, 0, 0, 0, 0, 0, "Test channel 1", "", {0}, {{0}} };
+    channel_t ch2 = { 0, 0, 0, 0, 0, 0, 0, 0, 0, "Test channel 2", "", {0}, {{0}} };
+    channel_t ch3 = { 0, 0, 0, 0, 0, 0, 0, 0, 0, "Test channel 3", "", {0}, {{0}} };
+    bankHdr_t b1 = { "Test Bank 1", 0 };
+    cps_insertContact(ct1, 0);
+    ch1.m17.contact_index = 0;
+    cps_insertChannel(ch1, 0);
+    cps_insertChannel(ch2, 1);
+    cps_insertChannel(ch3, 2);
+    cps_insertBankHeader(b1, 0);
+    cps_insertBankData(0, 0, 0);
+    cps_insertBankData(1, 0, 1);
+    cps_insertBankData(2, 0, 2);
+    // Contact references follow the inserted contacts
+    cps_insertContact(ct2, 0);
+    channel_t c = { 0 };
+    cps_readChannel(&c, 0);
+    if(c.m17.contact_index != 1)
+        return -1;
+    // Deleted channels are dropped from the banks
+    if(cps_deleteChannel(ch2, 1))
+        return -1;
+    if(cps_readBankData(0, 1) != 1)
+        return -1;
+    cps_close();
+
+    cps_open("/tmp/test7.rtxc");
+    bankHdr_t b = { 0 };
+    cps_readBankHeader(&b, 0);
+    if(b.ch_count != 2)
+        return -1;
+    if(cps_readBankData(0, 0) != 0 || cps_readBankData(0, 1) != 1)
+        return -1;
+    cps_readChannel(&c, 1);
+    if(strncmp(ch3.name, c.name, 32L))
+        return -1;
+    cps_readChannel(&c, 0);
+    if(c.m17.contact_index != 1)
+        return -1;
+    if(cps_readChannel(&c, 2) != -1)
+        return -1;
+    // References to deleted contacts are cleared, also after compaction
+    contact_t ct = { 0 };
+    cps_deleteContact(1);
+    cps_readChannel(&c, 0);
+    if(cps_readContact(&ct, c.m17.contact_index) != -1)
+        return -1;
+    cps_close();
+
+    cps_open("/tmp/test7.rtxc");
+    cps_readChannel(&c, 0);
+    if(cps_readContact(&ct, c.m17.contact_index) != -1)
+        return -1;
+    cps_close();
+    return 0;
+}
+
+int test_convertV1() {
+    FILE *f = fopen("/tmp/test8.rtxc", "w");
+    cps_header_t header = { CPS_MAGIC, 0x0001, "", "", 0, 2, 2, 1 };
+    contact_t ct1 = { "Test contact 1", 0, {{0}} };
+    contact_t ct2 = { "Test contact 2", 0, {{0}} };
+    channel_t ch1 = { OPMODE_DMR, 0, 0, 0, 0, 0, 0, 0, 0, "Test channel 1", "", {0}, {{0}} };
+    channel_t ch2 = { 0, 0, 0, 0, 0, 0, 0, 0, 0, "Test channel 2", "", {0}, {{0}} };
+    bankHdr_t b1 = { "Test Bank 1", 2 };
+    uint32_t offset = 0;
+    uint32_t bank[] = { 1, 0 };
+    ch1.dmr.contact_index = 1;
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(&ct1, sizeof(contact_t), 1, f);
+    fwrite(&ct2, sizeof(contact_t), 1, f);
+    fwrite(&ch1, sizeof(channel_t), 1, f);
+    fwrite(&ch2, sizeof(channel_t), 1, f);
+    fwrite(&offset, sizeof(offset), 1, f);
+    fwrite(&b1, sizeof(bankHdr_t), 1, f);
+    fwrite(bank, sizeof(bank), 1, f);
+    fclose(f);
+
+    if(cps_open("/tmp/test8.rtxc"))
+        return -1;
+    contact_t ct = { 0 };
+    cps_readContact(&ct, 1);
+    if(strncmp(ct2.name, ct.name, 32L))
+        return -1;
+    channel_t c = { 0 };
+    cps_readChannel(&c, 0);
+    if(strncmp(ch1.name, c.name, 32L) || c.dmr.contact_index != 1)
+        return -1;
+    bankHdr_t b = { 0 };
+    cps_readBankHeader(&b, 0);
+    if(strncmp(b1.name, b.name, 32L) || b.ch_count != 2)
+        return -1;
+    if(cps_readBankData(0, 0) != 1 || cps_readBankData(0, 1) != 0)
+        return -1;
+    cps_close();
+
+    // The codeplug has been rewritten in the current format
+    f = fopen("/tmp/test8.rtxc", "r");
+    fread(&header, sizeof(header), 1, f);
+    fclose(f);
+    if(header.version_number != (CPS_VERSION_MAJOR << 8 | CPS_VERSION_MINOR))
+        return -1;
+    return 0;
+}
+
+int test_readRanges() {
+    cps_create("/tmp/test9.rtxc");
+
+    cps_open("/tmp/test9.rtxc");
+    bankHdr_t b1 = { "Test Bank 1", 0 };
+    cps_insertBankHeader(b1, 0);
+    for(int i = 0; i < 40; i++)
+    {
+        contact_t ct = { "", 0, {{0}} };
+        channel_t ch = { OPMODE_DMR, 0, 0, 0, 0, 0, 0, 0, 0, "", "", {0}, {{0}} };
+        snprintf(ct.name, sizeof(ct.name), "Test contact %d", i);
+        snprintf(ch.name, sizeof(ch.name), "Test channel %d", i);
+        ch.dmr.contact_index = i;
+        cps_insertContact(ct, i);
+        cps_insertChannel(ch, i);
+    }
+    for(int i = 0; i < 40; i++)
+        cps_insertBankData(39 - i, 0, i);
+    // Mix records from the snapshot and from the journal
+    cps_close();
+    cps_open("/tmp/test9.rtxc");
+    channel_t ch = { 0 };
+    cps_readChannel(&ch, 20);
+    snprintf(ch.name, sizeof(ch.name), "Modified channel");
+    cps_writeChannel(ch, 20);
+
+    channel_t channels[50];
+    contact_t contacts[50];
+    uint16_t  indices[50];
+    if(cps_readChannels(channels, 5, 50) != 35)
+        return -1;
+    if(cps_readContacts(contacts, 0, 50) != 40)
+        return -1;
+    if(cps_readBankChannels(indices, 0, 10, 5) != 5)
+        return -1;
+    for(int i = 0; i < 35; i++)
+    {
+        channel_t c = { 0 };
+        cps_readChannel(&c, i + 5);
+        if(memcmp(&c, &channels[i], sizeof(channel_t)))
+            return -1;
+    }
+    for(int i = 0; i < 40; i++)
+    {
+        contact_t c = { 0 };
+        cps_readContact(&c, i);
+        if(memcmp(&c, &contacts[i], sizeof(contact_t)))
+            return -1;
+    }
+    for(int i = 0; i < 5; i++)
+    {
+        if(indices[i] != cps_readBankData(0, i + 10))
+            return -1;
+    }
+    if(cps_readChannels(channels, 40, 1) != -1)
+        return -1;
+    cps_close();
+    return 0;
+}
+
 int main() {
     if (test_initCPS())
     {
@@ -183,4 +354,19 @@ int main() {
         printf("Error in creation of Out-Of-Order CPS!\n");
         return -1;
     }
+    if (test_deleteAndReopen())
+    {
+        printf("Error in deletion and reopening of CPS!\n");
+        return -1;
+    }
+    if (test_convertV1())
+    {
+        printf("Error in conversion of v0.1 CPS!\n");
+        return -1;
+    }
+    if (test_readRanges())
+    {
+        printf("Error in batched reads!\n");
+        return -1;
+    }
 }
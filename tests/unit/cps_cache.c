@@ -0,0 +1,206 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <interfaces/cps_io.h>
+#include <cps_cache.h>
+#include <string.h>
+#include <stdio.h>
+
+#define NUM_ENTRIES 50
+
+static const char *cpsPath = "/tmp/test_cache.rtxc";
+
+static int createCPS()
+{
+    if(cps_create((char *) cpsPath) < 0)
+        return -1;
+
+    if(cps_open((char *) cpsPath) < 0)
+        return -1;
+
+    for(int i = 0; i < NUM_ENTRIES; i++)
+    {
+        contact_t contact = { 0 };
+        channel_t channel = { 0 };
+
+        snprintf(contact.name, sizeof(contact.name), "Contact %d", i);
+        snprintf(channel.name, sizeof(channel.name), "Channel %d", i);
+        channel.rx_frequency = 430000000 + (i * 12500);
+
+        cps_insertContact(contact, i);
+        cps_insertChannel(channel, i);
+    }
+
+    bankHdr_t b1 = { "Bank 0", 0 };
+    bankHdr_t b2 = { "Bank 1", 0 };
+    cps_insertBankHeader(b1, 0);
+    cps_insertBankHeader(b2, 1);
+
+    return 0;
+}
+
+static int test_names()
+{
+    char name[CPS_STR_SIZE];
+    char expected[CPS_STR_SIZE];
+
+    // Walk the tables back and forth to exercise page eviction
+    for(int pass = 0; pass < 2; pass++)
+    {
+        for(int j = 0; j < NUM_ENTRIES; j++)
+        {
+            int i = (pass == 0) ? j : (NUM_ENTRIES - 1 - j);
+
+            snprintf(expected, sizeof(expected), "Channel %d", i);
+            if(cpsCache_getChannelName(name, sizeof(name), i) < 0)
+                return -1;
+            if(strcmp(name, expected) != 0)
+                return -1;
+
+            snprintf(expected, sizeof(expected), "Contact %d", i);
+            if(cpsCache_getContactName(name, sizeof(name), i) < 0)
+                return -1;
+            if(strcmp(name, expected) != 0)
+                return -1;
+        }
+    }
+
+    if(cpsCache_getChannelName(name, sizeof(name), NUM_ENTRIES) != -1)
+        return -1;
+    if(cpsCache_getContactName(name, sizeof(name), NUM_ENTRIES) != -1)
+        return -1;
+
+    if(cpsCache_getBankName(name, sizeof(name), 1) < 0)
+        return -1;
+    if(strcmp(name, "Bank 1") != 0)
+        return -1;
+    if(cpsCache_getBankName(name, sizeof(name), 2) != -1)
+        return -1;
+
+    // Truncation to the destination buffer size
+    if(cpsCache_getChannelName(name, 5, 10) < 0)
+        return -1;
+    if(strcmp(name, "Chan") != 0)
+        return -1;
+
+    return 0;
+}
+
+static int test_entries()
+{
+    for(int i = 0; i < NUM_ENTRIES; i++)
+    {
+        channel_t cached;
+        channel_t direct;
+
+        if(cpsCache_readChannel(&cached, i) < 0)
+            return -1;
+        if(cps_readChannel(&direct, i) < 0)
+            return -1;
+        if(memcmp(&cached, &direct, sizeof(channel_t)) != 0)
+            return -1;
+
+        // Second read is served from the cache
+        if(cpsCache_readChannel(&cached, i) < 0)
+            return -1;
+        if(memcmp(&cached, &direct, sizeof(channel_t)) != 0)
+            return -1;
+    }
+
+    channel_t channel;
+    if(cpsCache_readChannel(&channel, NUM_ENTRIES) != -1)
+        return -1;
+
+    return 0;
+}
+
+static int test_invalidation()
+{
+    char name[CPS_STR_SIZE];
+    channel_t channel;
+
+    // Load entry and name in the cache, then modify the entry
+    if(cpsCache_readChannel(&channel, 3) < 0)
+        return -1;
+    if(cpsCache_getChannelName(name, sizeof(name), 3) < 0)
+        return -1;
+
+    snprintf(channel.name, sizeof(channel.name), "Modified");
+    if(cps_writeChannel(channel, 3) < 0)
+        return -1;
+
+    if(cpsCache_readChannel(&channel, 3) < 0)
+        return -1;
+    if(strcmp(channel.name, "Modified") != 0)
+        return -1;
+    if(cpsCache_getChannelName(name, sizeof(name), 3) < 0)
+        return -1;
+    if(strcmp(name, "Modified") != 0)
+        return -1;
+
+    // Insertion shifts the following entries
+    contact_t contact = { "New contact", 0, {{0}} };
+    if(cpsCache_getContactName(name, sizeof(name), 0) < 0)
+        return -1;
+    if(cps_insertContact(contact, 0) < 0)
+        return -1;
+
+    if(cpsCache_getContactName(name, sizeof(name), 0) < 0)
+        return -1;
+    if(strcmp(name, "New contact") != 0)
+        return -1;
+    if(cpsCache_getContactName(name, sizeof(name), NUM_ENTRIES) < 0)
+        return -1;
+    if(strcmp(name, "Contact 49") != 0)
+        return -1;
+
+    return 0;
+}
+
+int main()
+{
+    if(createCPS())
+    {
+        printf("Error in codeplug creation!\n");
+        return -1;
+    }
+
+    if(test_names())
+    {
+        printf("Error in cached name lookup!\n");
+        return -1;
+    }
+
+    if(test_entries())
+    {
+        printf("Error in cached entry read!\n");
+        return -1;
+    }
+
+    if(test_invalidation())
+    {
+        printf("Error in cache invalidation!\n");
+        return -1;
+    }
+
+    cps_close();
+
+    return 0;
+}
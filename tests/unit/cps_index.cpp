@@ -0,0 +1,265 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <interfaces/cps_io.h>
+#include <M17/M17Callsign.hpp>
+#include <cps_index.h>
+#include <strings.h>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const char *cpsPath = "/tmp/test_index.rtxc";
+
+static const char *callsigns[] =
+{
+    "IU2KWO", "IU2KIN", "IU2NUO", "IU2NRO", "DL1ABC", "W1AW", "K1ABC",
+    "IU2KWA", "G4XYZ", "IU5BON", "VK2ABC", "JA1XYZ", "F4ABC", "EA4XYZ"
+};
+
+static constexpr size_t NUM_CONTACTS = sizeof(callsigns) / sizeof(callsigns[0]);
+static constexpr size_t NUM_DMR      = 90;
+
+static vector< string > readNames(bool contacts)
+{
+    vector< string > names;
+
+    for(uint16_t pos = 0; ; pos++)
+    {
+        char name[CPS_STR_SIZE + 1] = { 0 };
+
+        if(contacts)
+        {
+            contact_t contact;
+            if(cps_readContact(&contact, pos) < 0)
+                break;
+            memcpy(name, contact.name, CPS_STR_SIZE);
+        }
+        else
+        {
+            channel_t channel;
+            if(cps_readChannel(&channel, pos) < 0)
+                break;
+            memcpy(name, channel.name, CPS_STR_SIZE);
+        }
+
+        names.push_back(name);
+    }
+
+    return names;
+}
+
+static int createCPS()
+{
+    if(cps_create(const_cast< char * >(cpsPath)) < 0)
+        return -1;
+
+    if(cps_open(const_cast< char * >(cpsPath)) < 0)
+        return -1;
+
+    uint16_t pos = 0;
+
+    for(size_t i = 0; i < NUM_CONTACTS; i++)
+    {
+        contact_t contact;
+        memset(&contact, 0x00, sizeof(contact));
+
+        M17::call_t address;
+        M17::encode_callsign(callsigns[i], address);
+
+        snprintf(contact.name, sizeof(contact.name), "%s op", callsigns[i]);
+        contact.mode = OPMODE_M17;
+        memcpy(contact.info.m17.address, address.data(), 6);
+
+        cps_insertContact(contact, pos++);
+    }
+
+    for(size_t i = 0; i < NUM_DMR; i++)
+    {
+        contact_t contact;
+        memset(&contact, 0x00, sizeof(contact));
+
+        // Mixed case names sharing long prefixes
+        snprintf(contact.name, sizeof(contact.name), "%s %02zu",
+                 (i % 2) ? "talkgroup" : "TalkGroup", (NUM_DMR - i) * 7 % 31);
+        contact.mode = OPMODE_DMR;
+        contact.info.dmr.id = 2220000 + ((i * 37) % 101);
+
+        cps_insertContact(contact, pos++);
+    }
+
+    for(size_t i = 0; i < 40; i++)
+    {
+        channel_t channel;
+        memset(&channel, 0x00, sizeof(channel));
+        snprintf(channel.name, sizeof(channel.name), "%c%c Repeater %zu",
+                 'A' + (char)((i * 7) % 26), 'a' + (char)(i % 3), i);
+
+        cps_insertChannel(channel, i);
+    }
+
+    return 0;
+}
+
+static int checkTable(bool contacts)
+{
+    vector< string > names = readNames(contacts);
+    vector< string > sorted;
+
+    // The index must list all the entries, in alphabetical order
+    for(uint16_t rank = 0; ; rank++)
+    {
+        int pos = contacts ? cpsIndex_getContact(rank)
+                           : cpsIndex_getChannel(rank);
+        if(pos < 0)
+            break;
+
+        sorted.push_back(names.at(pos));
+    }
+
+    if(sorted.size() != names.size())
+        return -1;
+
+    for(size_t i = 1; i < sorted.size(); i++)
+    {
+        if(strcasecmp(sorted[i - 1].c_str(), sorted[i].c_str()) > 0)
+            return -1;
+    }
+
+    // Prefix searches must return exactly the entries found by a linear scan
+    for(size_t i = 0; i < names.size(); i++)
+    {
+        for(size_t len = 0; len <= names[i].size(); len++)
+        {
+            string prefix = names[i].substr(0, len);
+            cpsMatch_t match;
+
+            int ret = contacts ? cpsIndex_searchContacts(prefix.c_str(), &match)
+                               : cpsIndex_searchChannels(prefix.c_str(), &match);
+            if(ret < 0)
+                return -1;
+
+            size_t expected = 0;
+            for(auto& name : names)
+            {
+                if(strncasecmp(name.c_str(), prefix.c_str(), len) == 0)
+                    expected++;
+            }
+
+            if(match.count != expected)
+                return -1;
+
+            for(uint16_t j = 0; j < match.count; j++)
+            {
+                if(strncasecmp(sorted[match.first + j].c_str(), prefix.c_str(),
+                               len) != 0)
+                    return -1;
+            }
+        }
+    }
+
+    cpsMatch_t match;
+    int ret = contacts ? cpsIndex_searchContacts("zzz", &match)
+                       : cpsIndex_searchChannels("zzz", &match);
+    if((ret < 0) || (match.count != 0))
+        return -1;
+
+    return 0;
+}
+
+static int checkLookup()
+{
+    for(size_t i = 0; i < NUM_CONTACTS; i++)
+    {
+        if(cpsIndex_findM17Contact(callsigns[i]) != (int) i)
+            return -1;
+    }
+
+    if(cpsIndex_findM17Contact("N0CALL") != -1)
+        return -1;
+
+    for(size_t i = 0; i < NUM_DMR; i++)
+    {
+        uint32_t id = 2220000 + ((i * 37) % 101);
+        if(cpsIndex_findDmrContact(id) != (int)(NUM_CONTACTS + i))
+            return -1;
+    }
+
+    if(cpsIndex_findDmrContact(1234567) != -1)
+        return -1;
+
+    return 0;
+}
+
+int main()
+{
+    if(createCPS() < 0)
+    {
+        printf("Error in codeplug creation!\n");
+        return -1;
+    }
+
+    if(cpsIndex_build() < 0)
+    {
+        printf("Error in index build!\n");
+        return -1;
+    }
+
+    if((checkTable(true) < 0) || (checkTable(false) < 0))
+    {
+        printf("Error in name search!\n");
+        return -1;
+    }
+
+    if(checkLookup() < 0)
+    {
+        printf("Error in contact lookup!\n");
+        return -1;
+    }
+
+    // Modify the codeplug, indices have to be rebuilt
+    contact_t contact;
+    memset(&contact, 0x00, sizeof(contact));
+    snprintf(contact.name, sizeof(contact.name), "AAA first");
+    contact.mode = OPMODE_DMR;
+    contact.info.dmr.id = 1234567;
+    cps_insertContact(contact, 0);
+
+    cpsMatch_t match;
+    if((cpsIndex_searchContacts("aaa", &match) < 0) || (match.count != 1) ||
+       (cpsIndex_getContact(match.first) != 0))
+    {
+        printf("Error in index update!\n");
+        return -1;
+    }
+
+    if(cpsIndex_findDmrContact(1234567) != 0)
+    {
+        printf("Error in index update!\n");
+        return -1;
+    }
+
+    cps_close();
+
+    return 0;
+}
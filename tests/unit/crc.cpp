@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <crc.h>
+
+/*
+ * Bitwise reference implementation of an MSB-first 16-bit CRC.
+ */
+static uint16_t crcReference(const uint16_t poly, uint16_t crc,
+                             const uint8_t *data, const size_t len)
+{
+    for(size_t i = 0; i < len; i++)
+    {
+        crc ^= (data[i] << 8);
+
+        for(uint8_t j = 0; j < 8; j++)
+        {
+            if(crc & 0x8000)
+                crc = (crc << 1) ^ poly;
+            else
+                crc = (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+int main()
+{
+    // Check values from the CRC-16/XMODEM and M17 specifications
+    const char *check = "123456789";
+    if((crc_ccitt(check, 9) != 0x31C3) || (crc_m17(check, 9) != 0x772B) ||
+       (crc_m17("A", 1) != 0x206E) || (crc_m17(NULL, 0) != 0xFFFF))
+    {
+        printf("Error in CRC check values!\n");
+        return -1;
+    }
+
+    uint8_t data[1031];
+    srand(0x5935);
+    for(size_t i = 0; i < sizeof(data); i++)
+        data[i] = rand();
+
+    // All the lengths, to cover both the sliced and the bytewise paths
+    for(size_t len = 0; len <= sizeof(data); len++)
+    {
+        if((crc_ccitt(data, len) != crcReference(0x1021, 0x0000, data, len)) ||
+           (crc_m17(data, len)   != crcReference(0x5935, 0xFFFF, data, len)))
+        {
+            printf("Error in CRC of %zu bytes!\n", len);
+            return -1;
+        }
+    }
+
+    // Incremental computation over chunks of varying size
+    uint16_t ccitt = CRC_CCITT_INIT;
+    uint16_t m17   = CRC_M17_INIT;
+    size_t   pos   = 0;
+    for(size_t chunk = 1; pos < sizeof(data); chunk++)
+    {
+        size_t len = chunk;
+        if((pos + len) > sizeof(data))
+            len = sizeof(data) - pos;
+
+        ccitt = crc_ccittUpdate(ccitt, &data[pos], len);
+        m17   = crc_m17Update(m17, &data[pos], len);
+        pos  += len;
+    }
+
+    if((ccitt != crc_ccitt(data, sizeof(data))) ||
+       (m17   != crc_m17(data, sizeof(data))))
+    {
+        printf("Error in incremental CRC!\n");
+        return -1;
+    }
+
+    return 0;
+}
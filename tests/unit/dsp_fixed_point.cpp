@@ -0,0 +1,160 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <dsp.h>
+#include <iir.hpp>
+#include <fir.hpp>
+#include "M17/M17DSP.hpp"
+
+#define SIGNAL_SIZE 24000
+
+using namespace std;
+
+/**
+ * Check the fixed point DSP functions against their floating point versions.
+ */
+
+static int16_t signal[SIGNAL_SIZE];
+
+static void makeSignal(const int16_t amplitude, const int16_t offset)
+{
+    for(size_t i = 0; i < SIGNAL_SIZE; i++)
+        signal[i] = static_cast< int16_t >((rand() % (2 * amplitude)) - amplitude + offset);
+}
+
+static int testDcRemoval()
+{
+    filter_state_t     state;
+    filter_state_q15_t stateQ15;
+    int16_t ref[SIGNAL_SIZE];
+    int16_t out[SIGNAL_SIZE];
+
+    dsp_resetFilterState(&state);
+    dsp_resetFilterStateQ15(&stateQ15);
+    makeSignal(8000, 3000);
+
+    for(size_t i = 0; i < SIGNAL_SIZE; i++)
+    {
+        ref[i] = signal[i];
+        out[i] = signal[i];
+    }
+
+    // Odd-sized chunks to exercise state handling across calls
+    for(size_t i = 0; i < SIGNAL_SIZE; i += 97)
+    {
+        size_t len = ((i + 97) <= SIGNAL_SIZE) ? 97 : (SIGNAL_SIZE - i);
+        dsp_dcRemoval(&state, &ref[i], len);
+        dsp_dcRemovalQ15(&stateQ15, &out[i], len);
+    }
+
+    for(size_t i = 0; i < SIGNAL_SIZE; i++)
+    {
+        if(abs(ref[i] - out[i]) > 2)
+        {
+            printf("DC removal mismatch at sample %zu: %d != %d\n", i, ref[i],
+                   out[i]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int testFir()
+{
+    static constexpr size_t N = std::tuple_size< decltype(M17::rrc_taps_24k) >::value;
+    Fir< N >        fir(M17::rrc_taps_24k);
+    Fir< N, q15_t > firQ15(M17::rrc_taps_24k);
+    int16_t ref[SIGNAL_SIZE];
+    int16_t out[SIGNAL_SIZE];
+
+    makeSignal(16000, 0);
+    fir.process(signal, ref, SIGNAL_SIZE, -1.0f);
+    firQ15.process(signal, out, SIGNAL_SIZE, -1.0f);
+
+    for(size_t i = 0; i < SIGNAL_SIZE; i++)
+    {
+        if(abs(ref[i] - out[i]) > 2)
+        {
+            printf("FIR mismatch at sample %zu: %d != %d\n", i, ref[i], out[i]);
+            return -1;
+        }
+    }
+
+    // Sample-by-sample interface
+    fir.reset();
+    firQ15.reset();
+    for(size_t i = 0; i < SIGNAL_SIZE; i++)
+    {
+        float   r = fir(static_cast< float >(signal[i]));
+        int16_t o = firQ15(signal[i]);
+        if(fabs(r - o) > 2.0f)
+        {
+            printf("FIR mismatch at sample %zu: %f != %d\n", i, r, o);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int testIir()
+{
+    static constexpr std::array < float, 3 > num = {4.24433681e-05f, 8.48867363e-05f, 4.24433681e-05f};
+    static constexpr std::array < float, 3 > den = {1.0f,           -1.98148851f,     0.98165828f};
+    Iir< 3 >        iir(num, den);
+    Iir< 3, q31_t > iirQ31(num, den);
+
+    makeSignal(32000, 0);
+    for(size_t i = 0; i < SIGNAL_SIZE; i++)
+    {
+        int32_t sample = abs(signal[i]);
+        float   r = iir(static_cast< float >(sample));
+        int32_t o = iirQ31(sample);
+
+        // Allow one unit of rounding plus 0.1% of error
+        if(fabs(r - o) > (1.0f + fabs(r) * 0.001f))
+        {
+            printf("IIR mismatch at sample %zu: %f != %d\n", i, r, o);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main()
+{
+    srand(0);
+
+    if(testDcRemoval() < 0)
+        return -1;
+
+    if(testFir() < 0)
+        return -1;
+
+    if(testIir() < 0)
+        return -1;
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+/***************************************************************************
+ *   Copyright (C) 2025 by Federico Amedeo Izzo IU2NUO,                    *
+ *                         Niccolò Izzo IU2KIN                             *
+ *                         Frederik Saraci IU2NRO                          *
+ *                         Silvano Seva IU2KWO                             *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, see <http://www.gnu.org/licenses/>   *
+ ***************************************************************************/
+
+#include <interfaces/delays.h>
+#include <thread_stats.h>
+#include <stdio.h>
+
+static void runLoop(const enum threadLoop loop, const unsigned int iterations,
+                    const unsigned int busy, const unsigned int period)
+{
+    long long time = getTick();
+
+    for(unsigned int i = 0; i < iterations; i++)
+    {
+        threadStats_begin(loop);
+        delayMs(busy);
+        threadStats_end(loop);
+
+        time += period;
+        sleepUntil(time);
+    }
+}
+
+int main()
+{
+    threadStats_t stats;
+
+    // Iterations well within their period
+    runLoop(LOOP_UI, 10, 5, 25);
+    if((threadStats_get(LOOP_UI, &stats) < 0) || (stats.iterations != 10) ||
+       (stats.period != 25) || (stats.maxDuration < 5) || (stats.missed != 0))
+    {
+        printf("Error in loop statistics!\n");
+        return -1;
+    }
+
+    // Two overlong iterations, each one counted once as a deadline miss
+    threadStats_begin(LOOP_UI);
+    delayMs(40);
+    threadStats_end(LOOP_UI);
+    threadStats_begin(LOOP_UI);
+    delayMs(40);
+    threadStats_end(LOOP_UI);
+    threadStats_get(LOOP_UI, &stats);
+    if((stats.iterations != 12) || (stats.missed != 2) ||
+       (stats.maxDuration < 40) || (stats.lastDuration < 40))
+    {
+        printf("Error in deadline miss detection!\n");
+        return -1;
+    }
+
+    // Late start after a short iteration
+    threadStats_begin(LOOP_UI);
+    threadStats_end(LOOP_UI);
+    delayMs(60);
+    threadStats_begin(LOOP_UI);
+    threadStats_end(LOOP_UI);
+    threadStats_get(LOOP_UI, &stats);
+    if((stats.missed != 3) || (stats.maxJitter < 25))
+    {
+        printf("Error in late start detection!\n");
+        return -1;
+    }
+
+    // A restarted loop does not account the pause as jitter
+    runLoop(LOOP_DECODE, 3, 1, 20);
+    delayMs(100);
+    threadStats_restart(LOOP_DECODE);
+    runLoop(LOOP_DECODE, 3, 1, 20);
+    threadStats_get(LOOP_DECODE, &stats);
+    if((stats.iterations != 6) || (stats.missed != 0) || (stats.maxJitter > 10))
+    {
+        printf("Error in loop restart!\n");
+        return -1;
+    }
+
+    // Free running loops have no deadlines
+    runLoop(LOOP_RTX, 3, 30, 0);
+    threadStats_get(LOOP_RTX, &stats);
+    if((stats.period != 0) || (stats.missed != 0) || (stats.maxJitter != 0))
+    {
+        printf("Error in free running loop!\n");
+        return -1;
+    }
+
+    // Waits within an iteration are not accounted in its duration
+    threadStats_begin(LOOP_RTX);
+    delayMs(5);
+    threadStats_pause(LOOP_RTX);
+    delayMs(50);
+    threadStats_resume(LOOP_RTX);
+    delayMs(5);
+    threadStats_end(LOOP_RTX);
+    threadStats_get(LOOP_RTX, &stats);
+    if((stats.lastDuration < 10) || (stats.lastDuration > 30))
+    {
+        printf("Error in wait exclusion!\n");
+        return -1;
+    }
+
+    threadStats_reset();
+    runLoop(LOOP_UI, 1, 1, 25);
+    threadStats_get(LOOP_UI, &stats);
+    if((stats.iterations != 1) || (stats.missed != 0))
+    {
+        printf("Error in statistics reset!\n");
+        return -1;
+    }
+
+    threadStats_dump(stdout);
+
+    return 0;
+}